@@ -0,0 +1,42 @@
+#ifndef MACHINE_AXES_H
+#define MACHINE_AXES_H
+
+#include <stdint.h>
+
+// <------Machine axes------->
+// Every axis of the machine, as AXIS(letter, configuration, max jerk), in the order the planner, compiled recipes and
+// the simulator number them. The letter has to be listed in GCODE_AXES, and the configuration and max jerk are in
+// MACHINE-PARAMETERS.h. Adding an axis is one line here
+#define MACHINE_AXES(AXIS) \
+    AXIS('X', LINEAR_MOTOR_CONFIGURATION, LINEAR_MOTOR_MAX_JERK_MM_PER_MIN)   /* the linear carriage */ \
+    AXIS('R', ROTATION_MOTOR_CONFIGURATION, ROTATION_MOTOR_MAX_JERK)          /* the mandril rotation */
+
+// the number of axes on the machine. This only counts the list, so it can be used without MACHINE-PARAMETERS.h
+#define MACHINE_AXIS_COUNT_ONE(letter, configuration, maxJerk) + 1
+#define MACHINE_AXIS_COUNT (0 MACHINE_AXES(MACHINE_AXIS_COUNT_ONE))
+
+// the letter of each axis, in the order they are listed
+#define MACHINE_AXIS_LETTER(letter, configuration, maxJerk) letter,
+inline constexpr char MACHINE_AXIS_LETTERS[MACHINE_AXIS_COUNT] = {MACHINE_AXES(MACHINE_AXIS_LETTER)};
+#undef MACHINE_AXIS_LETTER
+
+/**
+ * @brief Find a machine axis by its letter
+ * @param letter The GCode letter of the axis
+ * @return The axis, or MACHINE_AXIS_COUNT if the machine doesn't have one with that letter
+*/
+constexpr uint8_t MachineAxisIndex(char letter){
+    for(uint8_t i = 0; i < MACHINE_AXIS_COUNT; i++){
+        if(MACHINE_AXIS_LETTERS[i] == letter){
+            return i;
+        }
+    }
+    return MACHINE_AXIS_COUNT;
+}
+
+// the machine's motion system, as MotionSystem<MotionAxis<...>, ...> with every axis above.
+// It needs MotionSystem.h and MACHINE-PARAMETERS.h where it is used
+#define MACHINE_MOTION_AXIS(letter, configuration, maxJerk) , MotionAxis<letter, configuration, maxJerk>
+#define MACHINE_MOTION_SYSTEM MotionSystemOf<void MACHINE_AXES(MACHINE_MOTION_AXIS)>
+
+#endif // MACHINE_AXES_H
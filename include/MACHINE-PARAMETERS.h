@@ -2,17 +2,26 @@
 #define MACHINE_PARAMETERS_H
 #include "PINOUT.h"
 #include "StepperMotorConfiguration.h"
+#include "HomingConfiguration.h"
+#include "EthernetConfiguration.h"
 // <------Motor parameters----->
+// Steps are streamed to the MUX in I2C bursts where each port image lasts 9 bus clocks,
+// and a step needs one image low and one image high. That's ~5.5kHz at 100kHz.
+// The bus is left free for a few input reads between bursts, so steps that fast can't catch up on all of that gap.
+#define MAX_STEP_FREQUENCY (I2C_BUS_FREQUENCY / 9 / 2)
+
 // linear motor
 #define STEPS_PER_MM 5 // TODO: just an estimate
-// 825 Hz is the maximum frequency the ESP32 can generate with the MUX
-#define LINEAR_MOTOR_MAX_SPEED_MM_PER_MIN 825*60*STEPS_PER_MM // mm per minute
+#define LINEAR_MOTOR_MAX_SPEED_MM_PER_MIN (MAX_STEP_FREQUENCY*60/STEPS_PER_MM) // mm per minute
 
 // currently acceleration is not used, but it could potentially be added in the future
 #define LINEAR_MOTOR_MAX_ACCELERATION_MM_PER_MIN_PER_MIN 10000000 // mm per minute per minute
 #define IS_LINEAR_MOTOR_INVERTED true
+// the biggest instant speed change the linear motor can take between two moves without stalling
+#define LINEAR_MOTOR_MAX_JERK_MM_PER_MIN 300 // TODO: just an estimate
 
-StepperMotorConfiguration LINEAR_MOTOR_CONFIGURATION(
+// the configurations are constexpr, so the motor's fixed point constants are worked out when the firmware is built
+inline constexpr StepperMotorConfiguration LINEAR_MOTOR_CONFIGURATION(
     LINEAR_MOTOR_STEP_PIN,
     LINEAR_MOTOR_DIRECTION_PIN,
     LINEAR_MOTOR_ENABLE_PIN,
@@ -24,12 +33,12 @@ StepperMotorConfiguration LINEAR_MOTOR_CONFIGURATION(
 
 // rotation motor
 #define STEPS_PER_REVOLUTION 200
-// 825 Hz is the maximum frequency the ESP32 can generate with the MUX
-#define ROTATION_MOTOR_MAX_SPEED 825*60*STEPS_PER_REVOLUTION // degrees per minute
+#define ROTATION_MOTOR_MAX_SPEED (MAX_STEP_FREQUENCY*60/STEPS_PER_REVOLUTION) // degrees per minute
 #define ROTATION_MOTOR_MAX_ACCELERATION 10000000 // degrees per minute per minute
 #define IS_ROTATION_MOTOR_INVERTED false
+#define ROTATION_MOTOR_MAX_JERK 3600 // degrees per minute. TODO: just an estimate
 
-StepperMotorConfiguration ROTATION_MOTOR_CONFIGURATION(
+inline constexpr StepperMotorConfiguration ROTATION_MOTOR_CONFIGURATION(
     ROTATION_MOTOR_STEP_PIN,
     ROTATION_MOTOR_DIRECTION_PIN,
     ROTATION_MOTOR_ENABLE_PIN,
@@ -60,13 +69,64 @@ StepperMotorConfiguration ROTATION_MOTOR_CONFIGURATION(
 #define ENDSTOP_2_POSITION 1000
 #define HOME_SWITCH_POSITION 0
 
+// <------Homing parameters------->
+// the linear axis runs at the home switch fast, backs off, and comes back slowly. G28 reports how long each part took,
+// so these can be tuned down to the shortest homing that still repeats. How far the axis goes past the switch before
+// it stops is the speed times the loop time, so the slow speed sets how precisely home repeats
+#define LINEAR_HOMING_FAST_SPEED_MM_PER_MIN 2000 // TODO: just an estimate
+#define LINEAR_HOMING_SLOW_SPEED_MM_PER_MIN 100 // TODO: just an estimate
+#define LINEAR_HOMING_BACK_OFF_MM 3 // has to be further than the fast approach runs past the switch
+#define LINEAR_HOMING_SEARCH_MM 4000 // the fast approach gives up if the switch isn't this close
+#define LINEAR_HOMING_DIRECTION -1 // the home switch is at the low end of the axis
+
+inline constexpr HomingConfiguration LINEAR_HOMING_CONFIGURATION(
+    LINEAR_HOMING_FAST_SPEED_MM_PER_MIN,
+    LINEAR_HOMING_SLOW_SPEED_MM_PER_MIN,
+    LINEAR_HOMING_BACK_OFF_MM,
+    LINEAR_HOMING_SEARCH_MM,
+    LINEAR_HOMING_DIRECTION
+);
+
+// the rotation axis has no switch, so it just goes back to 0 while the linear axis homes
+#define ROTATION_HOMING_SPEED 1000 // degrees per minute
+
 // <------other parameters-------->
 // serial definitions
 #define SERIAL_BAUD_RATE 115200
 
+// command dispatch. Lower priorities go first in each round, and each channel runs up to its weight of commands a turn
+#define COMMAND_BUDGET_US 500 // how long each loop may spend running commands
+#define USB_COMMAND_PRIORITY 0
+#define USB_COMMAND_WEIGHT 4
+#define DISPLAY_COMMAND_PRIORITY 1
+#define DISPLAY_COMMAND_WEIGHT 2
+#define NETWORK_COMMAND_PRIORITY 1
+#define NETWORK_COMMAND_WEIGHT 4
+#define RECIPE_COMMAND_PRIORITY 2
+#define RECIPE_COMMAND_WEIGHT 4
+
 // IP Definitions
 #define STATIC_IP 10, 0, 0, 2
 #define GATEWAY_IP 10, 0, 0, 1
 #define SUBNET_MASK 255, 255, 255, 0
+// the TCP port GCode can be streamed to. Ports under 1024 need root on a PC, so the PC builds use another one.
+// It can be overridden with a build flag, and the simulator can be given one with --port
+#ifndef GCODE_SERVER_PORT
+#ifdef ARDUINO_ARCH_ESP32
+#define GCODE_SERVER_PORT 23
+#else
+#define GCODE_SERVER_PORT 2323
+#endif
+#endif
+
+inline EthernetConfiguration ETHERNET_CONFIGURATION = {
+    PHYSICAL_ADDRESS,
+    MDC_PIN,
+    MDIO_PIN,
+    ETH_CLK_MODE,
+    {STATIC_IP},
+    {GATEWAY_IP},
+    {SUBNET_MASK}
+};
 
 #endif // MACHINE_PARAMETERS_H
\ No newline at end of file
@@ -5,24 +5,27 @@
 #include <Wire.h>
 #include <PCF8574.h>
 
+#include "I2CPort.h"
 #include "I2CPin.h"
 
 
 // <------- I2C Definitions ---------->
 #define SDA_PIN 4
 #define SCL_PIN 5
+#define I2C_BUS_FREQUENCY 100000 // the PCF8574 is only rated for 100kHz
 #define PCF8574_OUT_1_8_ADDRESS 0x24
 #define PCF8574_OUT_9_16_ADDRESS 0x25
 #define PCF8574_IN_1_8_ADDRESS 0x22
 #define PCF8574_IN_9_16_ADDRESS 0x21
 
-// Create I2C Objects
-TwoWire I2C_BUS(0);
+// Create I2C Objects. Everything here is inline, so more than one file can include the pinout
+inline TwoWire I2C_BUS(0);
 
-PCF8574 i2c_output_port_1(PCF8574_OUT_1_8_ADDRESS, &I2C_BUS);
-PCF8574 i2c_output_port_2(PCF8574_OUT_9_16_ADDRESS, &I2C_BUS);
-PCF8574 i2c_input_port_1(PCF8574_IN_1_8_ADDRESS, &I2C_BUS);
-PCF8574 i2c_input_port_2(PCF8574_IN_9_16_ADDRESS, &I2C_BUS);
+// output writes are buffered in each port and sent in one transaction when the port is flushed
+inline I2CPort i2c_output_port_1(PCF8574_OUT_1_8_ADDRESS, &I2C_BUS);
+inline I2CPort i2c_output_port_2(PCF8574_OUT_9_16_ADDRESS, &I2C_BUS);
+inline I2CPort i2c_input_port_1(PCF8574_IN_1_8_ADDRESS, &I2C_BUS);
+inline I2CPort i2c_input_port_2(PCF8574_IN_9_16_ADDRESS, &I2C_BUS);
 
 // <------- Ethernet Definitions ---------->
 // Type: LAN8720
@@ -36,35 +39,36 @@ PCF8574 i2c_input_port_2(PCF8574_IN_9_16_ADDRESS, &I2C_BUS);
 #define TX2_PIN 33 // This is HT2 on the board
 
 // <------stepper motor pin definitions------->
+// the pins are constexpr so the motor configurations built from them can be too
 #define LINEAR_MOTOR_STEP_PIN_NUMBER 0
 #define LINEAR_MOTOR_DIRECTION_PIN_NUMBER 1
 #define LINEAR_MOTOR_ENABLE_PIN_NUMBER 2
-I2CPin LINEAR_MOTOR_STEP_PIN(LINEAR_MOTOR_STEP_PIN_NUMBER, &i2c_output_port_1);
-I2CPin LINEAR_MOTOR_DIRECTION_PIN(LINEAR_MOTOR_DIRECTION_PIN_NUMBER, &i2c_output_port_1);
-I2CPin LINEAR_MOTOR_ENABLE_PIN(LINEAR_MOTOR_ENABLE_PIN_NUMBER, &i2c_output_port_1);
+inline constexpr I2CPin LINEAR_MOTOR_STEP_PIN(LINEAR_MOTOR_STEP_PIN_NUMBER, &i2c_output_port_1);
+inline constexpr I2CPin LINEAR_MOTOR_DIRECTION_PIN(LINEAR_MOTOR_DIRECTION_PIN_NUMBER, &i2c_output_port_1);
+inline constexpr I2CPin LINEAR_MOTOR_ENABLE_PIN(LINEAR_MOTOR_ENABLE_PIN_NUMBER, &i2c_output_port_1);
 
 #define ROTATION_MOTOR_STEP_PIN_NUMBER 3
 #define ROTATION_MOTOR_DIRECTION_PIN_NUMBER 4
 #define ROTATION_MOTOR_ENABLE_PIN_NUMBER 5
-I2CPin ROTATION_MOTOR_STEP_PIN(ROTATION_MOTOR_STEP_PIN_NUMBER, &i2c_output_port_1);
-I2CPin ROTATION_MOTOR_DIRECTION_PIN(ROTATION_MOTOR_DIRECTION_PIN_NUMBER, &i2c_output_port_1);
-I2CPin ROTATION_MOTOR_ENABLE_PIN(ROTATION_MOTOR_ENABLE_PIN_NUMBER, &i2c_output_port_1);
+inline constexpr I2CPin ROTATION_MOTOR_STEP_PIN(ROTATION_MOTOR_STEP_PIN_NUMBER, &i2c_output_port_1);
+inline constexpr I2CPin ROTATION_MOTOR_DIRECTION_PIN(ROTATION_MOTOR_DIRECTION_PIN_NUMBER, &i2c_output_port_1);
+inline constexpr I2CPin ROTATION_MOTOR_ENABLE_PIN(ROTATION_MOTOR_ENABLE_PIN_NUMBER, &i2c_output_port_1);
 
 // <------ Endstop pin definitions-------->
 #define ENDSTOP_1_PIN_NUMBER 0
 #define ENDSTOP_2_PIN_NUMBER 1
 #define HOME_STOP_PIN_NUMBER 2
 
-I2CPin ENDSTOP_1_PIN(ENDSTOP_1_PIN_NUMBER, &i2c_input_port_1);
-I2CPin ENDSTOP_2_PIN(ENDSTOP_2_PIN_NUMBER, &i2c_input_port_1);
-I2CPin HOME_STOP_PIN(HOME_STOP_PIN_NUMBER, &i2c_input_port_1);
+inline constexpr I2CPin ENDSTOP_1_PIN(ENDSTOP_1_PIN_NUMBER, &i2c_input_port_1);
+inline constexpr I2CPin ENDSTOP_2_PIN(ENDSTOP_2_PIN_NUMBER, &i2c_input_port_1);
+inline constexpr I2CPin HOME_STOP_PIN(HOME_STOP_PIN_NUMBER, &i2c_input_port_1);
 
 // <------ Miscelaneous pin definitions-------->
 #define ESTOP_PIN_NUMBER 3
 #define SPRAYER_PIN_NUMBER 6
 #define HEATER_PIN_NUMBER 7
-I2CPin ESTOP_PIN(ESTOP_PIN_NUMBER, &i2c_input_port_1);
-I2CPin SPRAYER_PIN(SPRAYER_PIN_NUMBER, &i2c_output_port_1);
-I2CPin HEATER_PIN(HEATER_PIN_NUMBER, &i2c_output_port_1);
+inline constexpr I2CPin ESTOP_PIN(ESTOP_PIN_NUMBER, &i2c_input_port_1);
+inline constexpr I2CPin SPRAYER_PIN(SPRAYER_PIN_NUMBER, &i2c_output_port_1);
+inline constexpr I2CPin HEATER_PIN(HEATER_PIN_NUMBER, &i2c_output_port_1);
 
 #endif // PINOUT_H
\ No newline at end of file
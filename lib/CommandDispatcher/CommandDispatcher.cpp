@@ -0,0 +1,67 @@
+/**
+ * @file CommandDispatcher.cpp
+ * @brief This file contains the CommandDispatcher class implimentation
+ * @version 1.0.0
+ * @author Quinn Henthorne. Contact: quinn.henthorne@gmail.com
+*/
+
+#include "CommandDispatcher.h"
+
+bool CommandDispatcher::AddSource(GCodeSource *source, uint8_t priority, uint8_t weight){
+    if(this->sourceCount == COMMAND_DISPATCHER_MAX_SOURCES){
+        return false;
+    }
+    // keep the channels sorted by priority, so a round goes through them in order
+    uint8_t i = this->sourceCount;
+    while(i > 0 && this->sources[i - 1].priority > priority){
+        this->sources[i] = this->sources[i - 1];
+        i--;
+    }
+    this->sources[i] = {source, priority, weight > 0 ? weight : static_cast<uint8_t>(1)};
+    this->sourceCount++;
+    this->current = 0;
+    this->used = 0;
+    return true;
+}
+
+uint16_t CommandDispatcher::Dispatch(){
+    uint32_t start = CycleTimer::Now();
+    uint16_t commandsRun = 0;
+    bool isBlocked[COMMAND_DISPATCHER_MAX_SOURCES] = {};
+
+    // stop once every channel in a row has had nothing it could run
+    uint8_t idleSources = 0;
+    while(idleSources < this->sourceCount){
+        Source &source = this->sources[this->current];
+        GCodeDefinitions::GCode *command = isBlocked[this->current] ? NULL : source.source->PeekGCode();
+        bool isRun = false;
+        if(command != NULL){
+            // out of time. The next pass starts with this command
+            if(commandsRun > 0 && CycleTimer::MicrosSince(start) >= this->budget){
+                break;
+            }
+            if(this->execute(*command, *source.source)){
+                source.source->PopGCode();
+                commandsRun++;
+                isRun = true;
+            }
+            else{
+                isBlocked[this->current] = true;
+            }
+        }
+
+        if(isRun){
+            idleSources = 0;
+            // a channel keeps its turn until it has run its weight
+            if(++this->used < source.weight){
+                continue;
+            }
+        }
+        else{
+            idleSources++;
+        }
+        this->used = 0;
+        this->current = this->current + 1 < this->sourceCount ? this->current + 1 : 0;
+    }
+    return commandsRun;
+}
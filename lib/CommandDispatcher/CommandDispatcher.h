@@ -0,0 +1,79 @@
+/**
+ * @file CommandDispatcher.h
+ * @brief This file contains the CommandDispatcher class
+ * @details This file contains the CommandDispatcher class which runs the commands waiting in every channel.
+ * Each pass it runs as many as fit in a time budget, so a burst of short commands is cleared in one pass instead of
+ * one command per loop. The channels take turns in order of priority, and each runs up to its weight of commands
+ * before the next one gets a turn. A pass that runs out of time picks up the next pass where it stopped,
+ * so a busy channel can never starve the others.
+ * @version 1.0.0
+ * @author Quinn Henthorne. Contact: quinn.henthorne@gmail.com
+*/
+
+#ifndef COMMAND_DISPATCHER_H
+#define COMMAND_DISPATCHER_H
+
+#include <Arduino.h>
+#include "GCodeSource.h"
+#include "CycleTimer.h"
+
+// the most channels commands can come from
+#define COMMAND_DISPATCHER_MAX_SOURCES 4
+
+class CommandDispatcher{
+    public:
+        /**
+         * @brief Construct a new Command Dispatcher object
+         * @param execute Runs a command from a channel. Returns true if the command was used, false if it can't run yet.
+         * Replies go to the channel the command came from
+         * @param budget How long each pass may spend running commands, in microseconds. The machine's is COMMAND_BUDGET_US
+        */
+        CommandDispatcher(bool (*execute)(const GCodeDefinitions::GCode &command, GCodeSource &source), uint32_t budget) :
+            execute(execute),
+            budget(budget){}
+
+        /**
+         * @brief Add a channel to take commands from
+         * @param source The channel
+         * @param priority Lower goes first in each round. Channels with the same priority go in the order they were added
+         * @param weight The most commands the channel runs before the next one gets a turn
+         * @return true if it was added, false if there are already COMMAND_DISPATCHER_MAX_SOURCES channels
+        */
+        bool AddSource(GCodeSource *source, uint8_t priority, uint8_t weight);
+
+        /**
+         * @brief Run the waiting commands until every channel is empty or can't run its next command, or the budget runs out
+         * @return The number of commands that were run
+         * @note At least one command is tried every pass, however long it takes. A channel whose next command
+         * can't run yet is passed over until the next pass, so the others can still run theirs
+        */
+        uint16_t Dispatch();
+
+        /**
+         * @brief Set how long each pass may spend running commands
+         * @param budget The budget in microseconds
+        */
+        void SetBudget(uint32_t budget){ this->budget = budget; }
+
+        /**
+         * @brief Get how long each pass may spend running commands
+         * @return The budget in microseconds
+        */
+        uint32_t GetBudget(){ return budget; }
+
+    private:
+        struct Source{
+            GCodeSource *source;
+            uint8_t priority;
+            uint8_t weight;
+        };
+
+        bool (*execute)(const GCodeDefinitions::GCode &command, GCodeSource &source);
+        uint32_t budget;
+        Source sources[COMMAND_DISPATCHER_MAX_SOURCES];
+        uint8_t sourceCount{0};
+        uint8_t current{0}; // the channel whose turn it is
+        uint8_t used{0}; // the commands the current channel has run this turn
+};
+
+#endif // COMMAND_DISPATCHER_H
@@ -0,0 +1,46 @@
+/**
+ * @file CommsTask.cpp
+ * @brief This file contains the CommsTask class
+ * @version 1.0.0
+ * @author Quinn Henthorne. Contact: quinn.henthorne@gmail.com
+*/
+
+#include "CommsTask.h"
+
+#ifdef ARDUINO_ARCH_ESP32
+
+void CommsTask::Begin(){
+    xTaskCreatePinnedToCore(
+        commsTask,
+        "comms",
+        COMMS_TASK_STACK_SIZE,
+        this,
+        COMMS_TASK_PRIORITY,
+        &this->taskHandle,
+        COMMS_TASK_CORE
+    );
+}
+
+void CommsTask::Update(){
+    // the task reads the channels
+}
+
+void CommsTask::commsTask(void *parameter){
+    CommsTask *comms = static_cast<CommsTask *>(parameter);
+    while(true){
+        comms->update();
+        vTaskDelay(pdMS_TO_TICKS(COMMS_TASK_PERIOD_MS));
+    }
+}
+
+#else
+
+void CommsTask::Begin(){
+    // there is no task on the native build
+}
+
+void CommsTask::Update(){
+    this->update();
+}
+
+#endif
@@ -0,0 +1,60 @@
+/**
+ * @file CommsTask.h
+ * @brief This file contains the CommsTask class
+ * @details This file contains the CommsTask class which reads the serial ports and the network on the other core.
+ * Receiving and parsing messages then never holds up the main loop, which is left to run the motion, the endstops
+ * and the machine state on the same core as the step task. The two sides only share the command queues and a
+ * snapshot of the machine.
+ * @version 1.0.0
+ * @author Quinn Henthorne. Contact: quinn.henthorne@gmail.com
+*/
+
+#ifndef COMMS_TASK_H
+#define COMMS_TASK_H
+
+#include <Arduino.h>
+
+// the priority and core of the comms task. Core 0 is otherwise left to the WiFi and Ethernet stacks
+#define COMMS_TASK_PRIORITY 1
+#define COMMS_TASK_CORE 0
+#define COMMS_TASK_STACK_SIZE 8192
+// how long the task sleeps between passes, so the idle task on its core can feed the watchdog
+#define COMMS_TASK_PERIOD_MS 1
+
+class CommsTask{
+    public:
+        /**
+         * @brief Construct a new Comms Task object
+         * @param update The function that reads every channel once
+        */
+        CommsTask(void (*update)()) :
+            update(update){}
+
+        /**
+         * @brief Start the comms task
+         * @note Everything the update function reads must be set up before this is called
+        */
+        void Begin();
+
+        /**
+         * @brief Read every channel, if there's no task to do it
+         * @note This is called from the main loop. On the ESP32 the task reads the channels and this does nothing,
+         * on the native build there is only one thread so the channels are read inline
+        */
+        void Update();
+
+    private:
+        void (*update)();
+
+#ifdef ARDUINO_ARCH_ESP32
+        TaskHandle_t taskHandle{NULL};
+
+        /**
+         * @brief The comms task. Reads every channel, then sleeps for a tick
+         * @param parameter A pointer to the comms task
+        */
+        static void commsTask(void *parameter);
+#endif
+};
+
+#endif // COMMS_TASK_H
@@ -10,7 +10,6 @@
 #define ENDSTOP_H
 
 #include "I2CPin.h"
-#include <PCF8574.h>
 
 class Endstop{
     public:
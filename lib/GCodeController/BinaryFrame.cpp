@@ -0,0 +1,86 @@
+/**
+ * @file BinaryFrame.cpp
+ * @brief This file contains the binary framing implimentation
+ * @version 1.0.0
+ * @author Quinn Henthorne. Contact: quinn.henthorne@gmail.com
+*/
+
+#include "BinaryFrame.h"
+
+uint16_t BinaryFrame::Crc16(const uint8_t *data, uint16_t length, uint16_t crc){
+    for(uint16_t i = 0; i < length; i++){
+        crc ^= static_cast<uint16_t>(data[i]) << 8;
+        for(uint8_t bit = 0; bit < 8; bit++){
+            crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+        }
+    }
+    return crc;
+}
+
+BinaryFrame::CobsEncoder::CobsEncoder(uint8_t *encoded) :
+    encoded(encoded){}
+
+void BinaryFrame::CobsEncoder::Put(uint8_t byte){
+    // each block starts with the distance to the next zero, which replaces that zero
+    if(byte != 0){
+        this->encoded[this->outIndex++] = byte;
+        this->code++;
+    }
+    // a zero or a full block ends the current block
+    if(byte == 0 || this->code == 0xFF){
+        this->encoded[this->codeIndex] = this->code;
+        this->code = 1;
+        this->codeIndex = this->outIndex++;
+    }
+}
+
+uint16_t BinaryFrame::CobsEncoder::Finish(){
+    this->encoded[this->codeIndex] = this->code;
+    return this->outIndex;
+}
+
+uint16_t BinaryFrame::CobsEncode(const uint8_t *data, uint16_t length, uint8_t *encoded){
+    CobsEncoder encoder(encoded);
+    for(uint16_t i = 0; i < length; i++){
+        encoder.Put(data[i]);
+    }
+    return encoder.Finish();
+}
+
+uint16_t BinaryFrame::CobsDecode(const uint8_t *encoded, uint16_t length, uint8_t *decoded){
+    uint16_t inIndex = 0;
+    uint16_t outIndex = 0;
+    while(inIndex < length){
+        uint8_t code = encoded[inIndex++];
+        // a zero can't be in an encoded frame, and a block can't run past the end of it
+        if(code == 0 || inIndex + code - 1 > length){
+            return 0;
+        }
+        for(uint8_t i = 1; i < code; i++){
+            decoded[outIndex++] = encoded[inIndex++];
+        }
+        // every block except a full one or the last one stands for a zero
+        if(code != 0xFF && inIndex < length){
+            decoded[outIndex++] = 0;
+        }
+    }
+    return outIndex;
+}
+
+uint16_t BinaryFrame::Encode(FrameType type, const uint8_t *payload, uint16_t length, uint8_t *frame){
+    // the CRC covers the type and the payload
+    uint8_t header = type;
+    uint16_t crc = Crc16(&header, BINARY_FRAME_HEADER_LENGTH);
+    crc = Crc16(payload, length, crc);
+
+    CobsEncoder encoder(frame);
+    encoder.Put(header);
+    for(uint16_t i = 0; i < length; i++){
+        encoder.Put(payload[i]);
+    }
+    encoder.Put(static_cast<uint8_t>(crc));
+    encoder.Put(static_cast<uint8_t>(crc >> 8));
+    uint16_t encodedLength = encoder.Finish();
+    frame[encodedLength] = BINARY_FRAME_DELIMITER;
+    return encodedLength + 1;
+}
@@ -0,0 +1,134 @@
+/**
+ * @file BinaryFrame.h
+ * @brief This file contains the binary framing used when a host switches a GCodeMessage out of text mode
+ * @details A frame is a type byte, a payload and a CRC16 of both, COBS encoded so the only zero byte on the
+ * wire is the delimiter that ends each frame. A move frame packs several fixed-layout move records,
+ * which is much denser than sending each move as a "!G1,X###,R###,F###;" line. A text frame carries
+ * commands in the text format without the start and end markers, so every command still works in binary mode.
+ * Nothing here depends on the Arduino framework, so host tools can build frames with the same code.
+ * @version 1.0.0
+ * @author Quinn Henthorne. Contact: quinn.henthorne@gmail.com
+*/
+
+#ifndef BINARY_FRAME_H
+#define BINARY_FRAME_H
+
+#include <stdint.h>
+
+// the byte that ends every frame on the wire
+#define BINARY_FRAME_DELIMITER 0x00
+
+// the frame type and CRC around the payload
+#define BINARY_FRAME_HEADER_LENGTH 1
+#define BINARY_FRAME_CRC_LENGTH 2
+
+// a move frame starts with the little endian int32 line number of its first record. -1 if the records aren't numbered
+#define BINARY_MOVES_HEADER_LENGTH 4
+
+// one move record: the G number, a mask of the fields that are set, then X, R and F as little endian int32
+// A move on any other axis has to be sent in a text frame
+#define BINARY_MOVE_RECORD_LENGTH 14
+#define BINARY_MOVE_HAS_X 0x01
+#define BINARY_MOVE_HAS_R 0x02
+#define BINARY_MOVE_HAS_F 0x04
+
+namespace BinaryFrame{
+    enum FrameType : uint8_t{
+        MOVES = 0x01, // the line number of the first record, then a whole number of move records
+        TEXT = 0x02 // one or more text commands separated by the text end marker
+    };
+
+    /**
+     * @brief Work out the CRC16 of some data
+     * @param data The data to check
+     * @param length The length of the data
+     * @param crc The CRC so far, so data can be checked in pieces
+     * @return The CRC16-CCITT of the data, with a polynomial of 0x1021 and a starting value of 0xFFFF
+    */
+    uint16_t Crc16(const uint8_t *data, uint16_t length, uint16_t crc = 0xFFFF);
+
+    /**
+     * @brief COBS encodes data a byte at a time, so a frame can be encoded from several pieces
+    */
+    class CobsEncoder{
+        public:
+            /**
+             * @brief Construct a new COBS encoder
+             * @param encoded Where to put the encoded data
+            */
+            CobsEncoder(uint8_t *encoded);
+
+            /**
+             * @brief Encode the next byte
+             * @param byte The byte to encode
+            */
+            void Put(uint8_t byte);
+
+            /**
+             * @brief Finish the last block
+             * @return The length of the encoded data. The delimiter is not added
+            */
+            uint16_t Finish();
+
+        private:
+            uint8_t *encoded;
+            uint16_t codeIndex = 0; // where the length of the current block goes
+            uint16_t outIndex = 1; // where the next byte goes
+            uint8_t code = 1; // the length of the current block plus one
+    };
+
+    /**
+     * @brief COBS encode some data
+     * @param data The data to encode
+     * @param length The length of the data
+     * @param encoded Where to put the encoded data. It must have room for length + length / 254 + 1 bytes
+     * @return The length of the encoded data. The delimiter is not added
+    */
+    uint16_t CobsEncode(const uint8_t *data, uint16_t length, uint8_t *encoded);
+
+    /**
+     * @brief COBS decode a frame
+     * @param encoded The encoded frame without its delimiter
+     * @param length The length of the encoded frame
+     * @param decoded Where to put the decoded data. It can be the same buffer as encoded
+     * @return The length of the decoded data. 0 if the frame isn't valid COBS
+    */
+    uint16_t CobsDecode(const uint8_t *encoded, uint16_t length, uint8_t *decoded);
+
+    /**
+     * @brief Build a frame ready to send
+     * @param type The type of the frame
+     * @param payload The payload of the frame
+     * @param length The length of the payload
+     * @param frame Where to put the frame. It must have room for the encoded payload, the header, the CRC and the delimiter
+     * @return The length of the frame including its delimiter
+    */
+    uint16_t Encode(FrameType type, const uint8_t *payload, uint16_t length, uint8_t *frame);
+
+    /**
+     * @brief Write a 32 bit value as little endian bytes
+     * @param value The value to write
+     * @param bytes Where to write the 4 bytes
+    */
+    inline void WriteInt32(int32_t value, uint8_t *bytes){
+        uint32_t unsignedValue = static_cast<uint32_t>(value);
+        for(uint8_t i = 0; i < 4; i++){
+            bytes[i] = static_cast<uint8_t>(unsignedValue >> (8 * i));
+        }
+    }
+
+    /**
+     * @brief Read a 32 bit value from little endian bytes
+     * @param bytes The 4 bytes to read
+     * @return The value
+    */
+    inline int32_t ReadInt32(const uint8_t *bytes){
+        uint32_t unsignedValue = 0;
+        for(uint8_t i = 0; i < 4; i++){
+            unsignedValue |= static_cast<uint32_t>(bytes[i]) << (8 * i);
+        }
+        return static_cast<int32_t>(unsignedValue);
+    }
+};
+
+#endif // BINARY_FRAME_H
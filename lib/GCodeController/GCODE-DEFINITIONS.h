@@ -8,56 +8,141 @@
 #ifndef GCODE_DEFINITIONS_H
 #define GCODE_DEFINITIONS_H
 
-#include <Arduino.h>
+#include <stdint.h>
 
 namespace GCodeDefinitions{
+    /**
+     * @brief Every command the machine understands, as X(name, letter, number)
+     * @details This is the only place a command is listed. The Command enum, the command strings and the decoder
+     * below are all generated from it, so adding a command is one line here plus its case in the dispatcher
+    */
+    #define GCODE_COMMANDS(X) \
+        X(M2, 'M', 2)       /* ping */ \
+        X(G4, 'G', 4)       /* wait */ \
+        X(M0, 'M', 0)       /* estop */ \
+        X(M1, 'M', 1)       /* release estop */ \
+        X(M24, 'M', 24)     /* pause/resume */ \
+        X(M114, 'M', 114)   /* get position */ \
+        X(G91, 'G', 91)     /* relative positioning */ \
+        X(G90, 'G', 90)     /* absolute positioning */ \
+        X(M208, 'M', 208)   /* set max travel */ \
+        X(M92, 'M', 92)     /* set steps per unit */ \
+        X(G1, 'G', 1)       /* controlled move */ \
+        X(G0, 'G', 0)       /* coast move */ \
+        X(G28, 'G', 28)     /* home */ \
+        X(M42, 'M', 42)     /* set pin */ \
+        X(M880, 'M', 880)   /* set the serial framing, S0 for text or S1 for binary */ \
+        X(M110, 'M', 110)   /* set the current line number */ \
+        X(M28, 'M', 28)     /* start uploading a recipe */ \
+        X(M29, 'M', 29)     /* finish uploading a recipe */ \
+        X(M32, 'M', 32)     /* run a recipe */ \
+        X(M27, 'M', 27)     /* report recipe status */ \
+        X(M524, 'M', 524)   /* abort the running recipe */ \
+        X(M881, 'M', 881)   /* report the timing histograms, S1 also clears them */
+
     enum Command : uint8_t{
-            INVALID, // invalid command
-            M2, // ping
-            G4, // wait
-            M0, // estop
-            M1, // release estop
-            M24, // pause/resume
-            M114, // get position
-            G91, // relative positioning
-            G90, // absolute positioning
-            M208, // set max travel
-            M92, // set steps per unit
-            G1, // controlled move
-            G0, // coast move
-            G28, // home
-            M42 // set pin  
+        INVALID, // invalid command
+        #define GCODE_COMMAND_ENUM(name, letter, number) name,
+        GCODE_COMMANDS(GCODE_COMMAND_ENUM)
+        #undef GCODE_COMMAND_ENUM
     };
 
-    // create an array to hold a list of char[] that correspond to the commands
+    // the name of each command, indexed by Command
     const char * const commandStrings[] = {
         "INVALID",
-        "M2",
-        "G4",
-        "M0",
-        "M1",
-        "M24",
-        "M114",
-        "G91",
-        "G90",
-        "M208",
-        "M92",
-        "G1",
-        "G0",
-        "G28",
-        "M42"
+        #define GCODE_COMMAND_STRING(name, letter, number) #name,
+        GCODE_COMMANDS(GCODE_COMMAND_STRING)
+        #undef GCODE_COMMAND_STRING
     };
 
-    const uint8_t commandStringLength = 15; // note: this needs to be updated if commandStrings is changed
+    constexpr uint8_t commandStringLength = sizeof(commandStrings) / sizeof(commandStrings[0]);
+
+    // the largest number a command can have. Anything bigger can't be a command
+    #define GCODE_MAX_COMMAND_NUMBER 9999
+
+    /**
+     * @brief Pack a command letter and number into one value so a command can be found with a single switch
+     * @param letter The uppercase command letter, G or M
+     * @param number The number after the letter
+     * @return A value that is unique for every letter and number pair
+    */
+    constexpr uint16_t CommandKey(char letter, uint16_t number){
+        return (letter == 'M' ? 0x8000 : 0) | number;
+    }
+
+    /**
+     * @brief Find the command for a letter and number
+     * @param letter The uppercase command letter
+     * @param number The number after the letter
+     * @return The command, or INVALID if there isn't one
+     * @note The compiler turns this into a jump table, so it takes the same time for every command
+    */
+    constexpr Command DecodeCommand(char letter, uint16_t number){
+        if(letter != 'G' && letter != 'M'){
+            return INVALID;
+        }
+        switch(CommandKey(letter, number)){
+            #define GCODE_COMMAND_CASE(name, letter, number) case CommandKey(letter, number): return name;
+            GCODE_COMMANDS(GCODE_COMMAND_CASE)
+            #undef GCODE_COMMAND_CASE
+            default:
+                return INVALID;
+        }
+    }
+
+    // every command has to decode back to itself. This fails to build if a command is listed twice,
+    // since the switch above would then have a duplicate case
+    #define GCODE_COMMAND_CHECK(name, letter, number) \
+        static_assert(number <= GCODE_MAX_COMMAND_NUMBER, #name " has too large a number"); \
+        static_assert(DecodeCommand(letter, number) == name, #name " doesn't decode to itself");
+    GCODE_COMMANDS(GCODE_COMMAND_CHECK)
+    #undef GCODE_COMMAND_CHECK
+
+    /**
+     * @brief Every axis a command can move, as AXIS(name, letter)
+     * @details The Axis enum and the letter lookup are generated from it, in this order. The machine's axes are
+     * picked from these by letter, so adding an axis is one line here plus one in MACHINE_AXES
+    */
+    #define GCODE_AXES(AXIS) \
+        AXIS(X, 'X')        /* the linear carriage */ \
+        AXIS(R, 'R')        /* the mandril rotation */
+
+    enum Axis : uint8_t{
+        #define GCODE_AXIS_ENUM(name, letter) AXIS_##name,
+        GCODE_AXES(GCODE_AXIS_ENUM)
+        #undef GCODE_AXIS_ENUM
+        AXIS_COUNT
+    };
+
+    // the letter of each axis, indexed by Axis
+    constexpr char axisLetters[] = {
+        #define GCODE_AXIS_LETTER(name, letter) letter,
+        GCODE_AXES(GCODE_AXIS_LETTER)
+        #undef GCODE_AXIS_LETTER
+    };
+
+    static_assert(AXIS_COUNT <= 8, "the axes that are set have to fit in a byte");
+
+    /**
+     * @brief Find the axis for a letter
+     * @param letter The uppercase axis letter
+     * @return The axis, or AXIS_COUNT if there isn't one
+    */
+    constexpr uint8_t AxisIndex(char letter){
+        switch(letter){
+            #define GCODE_AXIS_CASE(name, letter) case letter: return AXIS_##name;
+            GCODE_AXES(GCODE_AXIS_CASE)
+            #undef GCODE_AXIS_CASE
+            default:
+                return AXIS_COUNT;
+        }
+    }
 
     // struct to hold the parsed command
     struct GCode{
         Command command = Command::INVALID;
-        int32_t X = 0;
-        bool hasX = false;
-
-        int32_t R = 0;
-        bool hasR = false;
+        int32_t axes[AXIS_COUNT] = {}; // the position of each axis, indexed by Axis
+        uint8_t axisMask = 0; // a bit for every axis that is set
 
         int32_t F = 0;
         bool hasF = false;
@@ -71,14 +156,35 @@ namespace GCodeDefinitions{
         int32_t T = 0;
         bool hasT = false;
 
+        int32_t N = 0; // the line number the host gave the command
+        bool hasN = false;
+
+        /**
+         * @brief Returns true if an axis was given
+         * @param axis The axis
+        */
+        bool HasAxis(uint8_t axis) const{
+            return (this->axisMask & (1 << axis)) != 0;
+        }
+
+        /**
+         * @brief Set the position of an axis
+         * @param axis The axis
+         * @param value The position
+        */
+        void SetAxis(uint8_t axis, int32_t value){
+            this->axes[axis] = value;
+            this->axisMask |= 1 << axis;
+        }
+
         // create a deep copy fucntion
         GCode copy() const{
             GCode copyGCode;
             copyGCode.command = this->command;
-            copyGCode.X = this->X;
-            copyGCode.hasX = this->hasX;
-            copyGCode.R = this->R;
-            copyGCode.hasR = this->hasR;
+            for(uint8_t i = 0; i < AXIS_COUNT; i++){
+                copyGCode.axes[i] = this->axes[i];
+            }
+            copyGCode.axisMask = this->axisMask;
             copyGCode.F = this->F;
             copyGCode.hasF = this->hasF;
             copyGCode.S = this->S;
@@ -87,6 +193,8 @@ namespace GCodeDefinitions{
             copyGCode.hasP = this->hasP;
             copyGCode.T = this->T;
             copyGCode.hasT = this->hasT;
+            copyGCode.N = this->N;
+            copyGCode.hasN = this->hasN;
             return copyGCode;
         }
     };
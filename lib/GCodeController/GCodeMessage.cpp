@@ -15,143 +15,259 @@ GCodeDefinitions::GCode * GCodeMessage::PopGCode(){
     return command;
 }
 
-void GCodeMessage::parseData(){
-    uint16_t messageLength = strlen(this->data);
-    GCodeDefinitions::GCode newCommand = this->parseGCodeString(this->data, messageLength);
-    // if the command is an estop command then set the estop command received flag to true and stop parsing
-    if(newCommand.command == GCodeDefinitions::Command::M0){
-        this->estopCommandReceived = true;
-    }
-    // otherwise just push the command to the queue to be used later
-    else{
-        this->queue.push(newCommand);
+void GCodeMessage::Reset(){
+    this->recvInProgress = false;
+    this->data_recieved = false;
+    this->ndx = 0;
+    this->binaryMode = false;
+    this->frameOverflowed = false;
+    this->isLineNumbered = false;
+    this->expectedLine = 0;
+    this->resendLine = -1;
+    // a recipe that was only half uploaded isn't kept
+    if(this->isUploading){
+        this->recipeStore->AbortUpload();
+        this->isUploading = false;
     }
 }
 
+void GCodeMessage::readSerial(){
+    if(!this->binaryMode){
+        SerialMessage::readSerial();
+        return;
+    }
 
-GCodeDefinitions::GCode GCodeMessage::parseGCodeString(char *message, uint16_t length){
-
-    GCodeDefinitions::GCode newCommand = GCodeDefinitions::GCode();
-
-    // the string will be organized as follows:
-    //!COMMAND,X###,R###,F###,S###,P###;
-    // where everything after the command is optional
-    // Resetting everything
-    this->ClearNewData();
-    // make all of the characters uppercase to remove any imput variation.
-    this->capitalize(message);
-
-    // the maximum length of one of any of the values is 8 characters
-    char temp[15];
-    uint8_t tempLength = 0;
-    // get the command
-    while(message[tempLength] != ',' && tempLength < length){
-        temp[tempLength] = message[tempLength];
-        tempLength++;
-    }
-    // parse the command
-    newCommand.command = matchToCommand(temp, tempLength);
-
-    // reset the temp array
-    memset(temp, 0, 8);
-    uint8_t dataStart = tempLength + 1;
-    tempLength = 0;
-
-    // get the rest of the values
-    for(uint16_t i = dataStart; i < length; i++){
-        char c = message[i];
-        if(c == ','){
-            // parse the value
-            this->populateCommandWithData(&newCommand, temp, tempLength);
-            // reset the temp array
-            memset(temp, 0, 15);
-            tempLength = 0;
+    // a frame is everything up to the delimiter. COBS makes sure it is the only zero byte
+    while(this->serial->available() > 0 && this->data_recieved == false){
+        uint8_t c = this->serial->read();
+        if(c == BINARY_FRAME_DELIMITER){
+            // a frame that didn't fit can't pass its CRC, so drop it here
+            if(this->ndx > 0 && !this->frameOverflowed){
+                this->dataLength = this->ndx;
+                this->data_recieved = true;
+            }
+            this->ndx = 0;
+            this->frameOverflowed = false;
         }
-        // we don't append the ';' at the end of the string, so we check if this is our last character by using i
-        else if (i == length - 1){
-            temp[tempLength] = c;
-            tempLength++;
-            this->populateCommandWithData(&newCommand, temp, tempLength);
-            break;
+        else if(this->ndx < num_chars){
+            this->data[this->ndx] = c;
+            this->ndx++;
         }
         else{
-            temp[tempLength] = c;
-            tempLength++;
+            this->frameOverflowed = true;
         }
     }
+}
 
-    // set the new data flag to true if our message isn't invalid
-    this->new_data = (newCommand.command != GCodeDefinitions::Command::INVALID);
-
-    // return the parsed command
-    return newCommand;
+void GCodeMessage::parseData(){
+    // Resetting everything
+    this->ClearNewData();
+    if(this->binaryMode){
+        this->parseFrame();
+        return;
+    }
+    // parse the message right where it was received
+    this->handleCommand(GCodeParser::Parse(this->data, this->dataLength));
 }
 
-GCodeDefinitions::Command GCodeMessage::matchToCommand(char *str, uint8_t length){
-        // go through each command string and see if it matches
-    for(int i = 0; i < GCodeDefinitions::commandStringLength; i++){
-        // check if the strings match
-        for(int j = 0; j < length; j++){
-            // if the strings don't match then break
-            if(str[j] != GCodeDefinitions::commandStrings[i][j]){
-                break;
+void GCodeMessage::parseFrame(){
+    using namespace GCodeDefinitions;
+
+    // decode into the spare buffer. A decoded frame is never longer than the encoded one
+    uint8_t *frame = reinterpret_cast<uint8_t *>(this->temp_data);
+    uint16_t length = BinaryFrame::CobsDecode(reinterpret_cast<const uint8_t *>(this->data), this->dataLength, frame);
+    if(length < BINARY_FRAME_HEADER_LENGTH + BINARY_FRAME_CRC_LENGTH){
+        this->Reply("Invalid binary frame! Ignoring.");
+        this->requestLostLines();
+        return;
+    }
+    uint16_t crc = frame[length - 2] | (frame[length - 1] << 8);
+    if(BinaryFrame::Crc16(frame, length - BINARY_FRAME_CRC_LENGTH) != crc){
+        this->Reply("Binary frame failed its CRC check! Ignoring.");
+        this->requestLostLines();
+        return;
+    }
+
+    const uint8_t *payload = frame + BINARY_FRAME_HEADER_LENGTH;
+    uint16_t payloadLength = length - BINARY_FRAME_HEADER_LENGTH - BINARY_FRAME_CRC_LENGTH;
+    switch(frame[0]){
+        case BinaryFrame::FrameType::MOVES:{
+            if(payloadLength < BINARY_MOVES_HEADER_LENGTH || (payloadLength - BINARY_MOVES_HEADER_LENGTH) % BINARY_MOVE_RECORD_LENGTH != 0){
+                this->Reply("Invalid binary frame! Ignoring.");
+                this->requestLostLines();
+                return;
             }
-            // if the strings match and we are at the end of the string then we have a match
-            if(j == length - 1){
-                                return (GCodeDefinitions::Command)i;
+            // the records are numbered on from the first line, unless it's negative
+            int32_t line = BinaryFrame::ReadInt32(payload);
+            bool isAcked = false;
+            int32_t lastAckedLine = 0;
+            for(uint16_t i = BINARY_MOVES_HEADER_LENGTH; i < payloadLength; i += BINARY_MOVE_RECORD_LENGTH){
+                const uint8_t *record = payload + i;
+                GCode newCommand = GCode();
+                if(line >= 0){
+                    newCommand.N = line++;
+                    newCommand.hasN = true;
+                }
+                newCommand.command = DecodeCommand('G', record[0]);
+                // only moves can be sent as move records
+                if(newCommand.command != Command::G0 && newCommand.command != Command::G1){
+                    newCommand.command = Command::INVALID;
+                }
+                uint8_t fields = record[1];
+                if(fields & BINARY_MOVE_HAS_X){
+                    newCommand.SetAxis(AXIS_X, BinaryFrame::ReadInt32(record + 2));
+                }
+                if(fields & BINARY_MOVE_HAS_R){
+                    newCommand.SetAxis(AXIS_R, BinaryFrame::ReadInt32(record + 6));
+                }
+                newCommand.hasF = fields & BINARY_MOVE_HAS_F;
+                newCommand.F = newCommand.hasF ? BinaryFrame::ReadInt32(record + 10) : 0;
+                // ack the frame once instead of every record in it
+                if(this->handleCommand(newCommand, false) && newCommand.hasN){
+                    isAcked = true;
+                    lastAckedLine = newCommand.N;
+                }
             }
+            if(isAcked){
+                this->sendAck(lastAckedLine);
+            }
+            break;
         }
-    }
-    
-    return GCodeDefinitions::Command::INVALID;
-}
 
-void GCodeMessage::populateCommandWithData(GCodeDefinitions::GCode *command, char *str, uint8_t length){
-    // the first character of the string will be the value type
-    char valueType = str[0];
-    // the rest of the string will be the value
-    char value[15];
-    for(uint8_t i = 1; i < length; i++){
-        value[i - 1] = str[i];
-    }
-    value[length - 1] = '\0';
-    // parse the value
-    int32_t parsedValue = atoi(value);
-
-    // populate the last command with the data
-    switch(valueType){
-        case 'X':
-            command->X = parsedValue;
-            command->hasX = true;
-            break;
-        case 'R':
-            command->R = parsedValue;
-            command->hasR = true;
-            break;
-        case 'F':
-            command->F = parsedValue;
-            command->hasF = true;
-            break;
-        case 'S':
-            command->S = parsedValue;
-            command->hasS = true;
-            break;
-        case 'P':
-            command->P = parsedValue;
-            command->hasP = true;
-            break;
-        case 'T':
-            command->T = parsedValue;
-            command->hasT = true;
+        case BinaryFrame::FrameType::TEXT:{
+            // each command ends at the end marker or the end of the frame
+            const char *text = reinterpret_cast<const char *>(payload);
+            uint16_t start = 0;
+            for(uint16_t i = 0; i <= payloadLength; i++){
+                if(i == payloadLength || text[i] == this->endMarker){
+                    if(i > start){
+                        this->handleCommand(GCodeParser::Parse(text + start, i - start));
+                    }
+                    start = i + 1;
+                }
+            }
             break;
+        }
+
         default:
-                        command->command = GCodeDefinitions::Command::INVALID;
+            this->Reply("Invalid binary frame! Ignoring.");
             break;
     }
 }
 
-void GCodeMessage::capitalize(char *str){
-    for(uint8_t i = 0; i < strlen(str); i++){
-        str[i] = toupper(str[i]);
+bool GCodeMessage::handleCommand(const GCodeDefinitions::GCode &command, bool isAcked){
+    using namespace GCodeDefinitions;
+
+    // if the command is an estop command then set the estop command received flag to true.
+    // An estop never waits on line numbers
+    if(command.command == Command::M0){
+        this->estopCommandReceived = true;
+    }
+
+    // a line number lets us check that nothing was lost on the way
+    bool isAnswered = false; // true if the query handler has already answered the command
+    if(command.hasN && command.command != Command::M110){
+        this->isLineNumbered = true;
+        // we already have this line, so the host missed our ack. Ack it again without running it twice
+        if(command.N < this->expectedLine){
+            if(isAcked){
+                this->sendAck(command.N);
+            }
+            return true;
+        }
+        // a line went missing, so ask for the first one we don't have. The host sends everything from there again,
+        // so the lines it already sent after the missing one don't have to ask too
+        if(command.N > this->expectedLine){
+            if(this->resendLine != this->expectedLine){
+                this->requestResend(this->expectedLine);
+            }
+            return false;
+        }
+        // the line was garbled. It is asked for every time, since the host might be waiting on this line's reply
+        if(command.command == Command::INVALID){
+            this->requestResend(command.N);
+            return false;
+        }
+        // there's nowhere to put the line yet, unless it's answered right away and never queued
+        bool isQueued = !this->isUploading && command.command != Command::M0 && command.command != Command::M110
+            && command.command != Command::M880 && command.command != Command::M28 && command.command != Command::M29;
+        if(isQueued && this->queue.size() == this->queue.max_size()){
+            isAnswered = this->queryHandler != NULL && this->queryHandler(command, *this);
+            if(!isAnswered){
+                this->requestResend(command.N);
+                return false;
+            }
+        }
+    }
+
+    // the line number the host wants to count from. The next line is the one after it, or 0 without a number
+    if(command.command == Command::M110){
+        this->isLineNumbered = true;
+        this->expectedLine = command.hasN ? command.N : 0;
+    }
+    // the framing has to change before the next byte is read, so it can't wait in the queue
+    else if(command.command == Command::M880){
+        bool binaryMode = command.hasS && command.S == 1;
+        this->Reply("!M880,S%d;", binaryMode ? 1 : 0);
+        this->binaryMode = binaryMode;
+        this->recvInProgress = false;
+        this->frameOverflowed = false;
+        this->ndx = 0;
+    }
+    // start writing commands to a recipe instead of running them
+    else if(command.command == Command::M28){
+        if(this->recipeStore != NULL && !this->isUploading && this->recipeStore->BeginUpload(command.P)){
+            this->isUploading = true;
+            this->Reply("!M28,P%ld;", static_cast<long>(command.P));
+        }
+        else{
+            this->Reply("Could not start the recipe upload");
+        }
+    }
+    // save the recipe and go back to running commands
+    else if(command.command == Command::M29){
+        int32_t length = this->isUploading ? this->recipeStore->EndUpload() : -1;
+        if(length >= 0){
+            this->Reply("!M29,P%ld,N%ld;", static_cast<long>(this->recipeStore->GetUploadSlot()), static_cast<long>(length));
+        }
+        else{
+            this->Reply("Could not save the recipe");
+        }
+        this->isUploading = false;
+    }
+    // estops were flagged above and never go anywhere else
+    else if(this->isUploading && command.command != Command::M0){
+        if(!this->recipeStore->Write(command)){
+            this->Reply("Could not write to the recipe");
+        }
+    }
+    // otherwise just push the command to the queue to be used later, unless it can be answered right away
+    else if(command.command != Command::M0 && !isAnswered && (this->queryHandler == NULL || !this->queryHandler(command, *this))){
+        this->queue.push(command);
+    }
+
+    if(command.hasN){
+        this->expectedLine++;
+        this->resendLine = -1;
+        if(isAcked){
+            this->sendAck(command.N);
+        }
+    }
+    return true;
+}
+
+void GCodeMessage::requestLostLines(){
+    // we can't tell which lines were in a bad frame, but they start at the next one we expect
+    if(this->isLineNumbered){
+        this->requestResend(this->expectedLine);
     }
-}
\ No newline at end of file
+}
+
+void GCodeMessage::sendAck(int32_t line){
+    this->Reply("!ACK,N%ld,Q%u;", static_cast<long>(line), static_cast<unsigned>(this->queue.max_size() - this->queue.size()));
+}
+
+void GCodeMessage::requestResend(int32_t line){
+    this->resendLine = line;
+    this->Reply("!RS,N%ld;", static_cast<long>(line));
+}
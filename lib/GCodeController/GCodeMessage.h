@@ -8,25 +8,45 @@
 #ifndef GCODE_MESSAGE_H
 #define GCODE_MESSAGE_H
 
+#include <atomic>
 #include "SerialMessage.h"
 #include "GCODE-DEFINITIONS.h"
+#include "GCodeParser.h"
 #include "GCodeQueue.h"
+#include "GCodeSource.h"
+#include "BinaryFrame.h"
+#include "RecipeStore.h"
 
-class GCodeMessage : public SerialMessage{
+class GCodeMessage : public SerialMessage, public GCodeSource{
     public:
     /**
      * @brief Construct a new GCode Message object
      */
-    GCodeMessage(HardwareSerial *serial = &Serial) : SerialMessage(serial){};
+    GCodeMessage(HardwareSerial *serial = &Serial) : SerialMessage(serial){ this->SetReplyOutput(serial); };
+
+    /**
+     * @brief Construct a new GCode Message object that reads from any stream, like a network client
+     */
+    GCodeMessage(Stream *stream) : SerialMessage(stream){ this->SetReplyOutput(stream); };
+
+    /**
+     * @brief Forget any half received message and go back to text mode with no line numbers
+     * @note This is for when a new host connects. Commands that are already queued are kept, but a half uploaded recipe is thrown away
+    */
+    void Reset();
 
     /**
      * @brief Returns the parsed GCode message
      * @return the parsed GCode message
      * @note If nothing has been parsed, or if the CLearNewData() function has been called, then the returned GCode will be invalid
      */
-    GCodeDefinitions::GCode * PopGCode();
+    GCodeDefinitions::GCode * PopGCode() override;
 
-    GCodeDefinitions::GCode * PeekGCode(){
+    /**
+     * @brief Returns the next GCode message without removing it from the queue
+     * @return the next GCode message. NULL if the queue is empty
+     */
+    GCodeDefinitions::GCode * PeekGCode() override{
         return this->queue.peek();
     }
 
@@ -41,14 +61,56 @@ class GCodeMessage : public SerialMessage{
      * @post The estopCommandReceived flag will be set to false
     */
     bool EStopCommandReceived(){
-        bool tempVal = this->estopCommandReceived;
-        this->estopCommandReceived = false;
-        return tempVal;
+        // the flag is set by whichever task reads the channel, so it's swapped in one step to never miss one
+        return this->estopCommandReceived.exchange(false);
+    }
+
+    /**
+     * @brief Answer some commands as soon as they're received instead of queueing them
+     * @param handler Called with every command that would be queued, and this channel to answer on. Returns true if it answered the command
+     * @note The handler runs on whichever task reads the channel, so it must not touch the motors.
+     * Replies go to the port messages are read from until SetReplyOutput() is called
+    */
+    void SetQueryHandler(bool (*handler)(const GCodeDefinitions::GCode &command, GCodeSource &source)){
+        this->queryHandler = handler;
+    }
+
+    /**
+     * @brief Let recipes be uploaded over this channel
+     * @param store Where uploaded recipes are kept
+     * @note Between M28,P<slot> and M29 every command is written to the recipe instead of being queued, except estops
+    */
+    void SetRecipeStore(RecipeStore *store){
+        this->recipeStore = store;
+    }
+
+    /**
+     * @brief Returns true if the host has switched this channel to binary frames
+     * @return true if messages are read as binary frames instead of text
+     * @note The host switches with M880,S1 and back with M880,S0. Replies are always text
+    */
+    bool IsBinaryMode(){
+        return this->binaryMode;
     }
 
+    protected:
+    /**
+     * @brief Read a text message, or a frame up to its delimiter in binary mode
+    */
+    void readSerial() override;
+
     private:
-    GCodeQueue queue; // the queue of GCode commands
-    bool estopCommandReceived = false; // immediately true if an estop command has been received
+    GCodeQueue<> queue; // the queue of GCode commands
+    std::atomic<bool> estopCommandReceived{false}; // immediately true if an estop command has been received
+    bool (*queryHandler)(const GCodeDefinitions::GCode &command, GCodeSource &source) = NULL; // answers commands that don't need to be queued. NULL if none are
+    bool binaryMode = false; // true if messages are binary frames
+    bool frameOverflowed = false; // true if the frame being received didn't fit in the data buffer
+    bool isLineNumbered = false; // true once the host has sent a line number
+    RecipeStore *recipeStore = NULL; // where recipes uploaded over this channel go. NULL if they can't be
+    bool isUploading = false; // true if commands are being written to a recipe instead of queued
+    int32_t expectedLine = 0; // the line number of the next line we can take
+    int32_t resendLine = -1; // the line we last asked to be sent again. -1 if we're not waiting on one.
+                             // The lines after it that are thrown away don't ask again
 
     /**
      * @brief Parse the message into a GCode struct
@@ -56,32 +118,38 @@ class GCodeMessage : public SerialMessage{
     void parseData() override;
 
     /**
-     * @brief Parse a string into its constituent components
-     * @param message The string to parse
-     * @param length The length of the string
-     * @return The parsed GCode
+     * @brief Check a binary frame and turn each command in it into a GCode struct
+    */
+    void parseFrame();
+
+    /**
+     * @brief Act on a command that has just been parsed
+     * @param command The parsed command
+     * @param isAcked true to ack the command if it has a line number
+     * @return true if the command was taken. False if it was thrown away and a resend was asked for
+     * @note Estops, line number changes and framing changes happen right away. Everything else is queued.
+     * A command with a line number is only taken if it is the next line, and is acked with the free queue slots
     */
-    GCodeDefinitions::GCode parseGCodeString(char *message, uint16_t length);
+    bool handleCommand(const GCodeDefinitions::GCode &command, bool isAcked = true);
 
     /**
-     * @brief Check if a string matches a command
-     * @param str The string to check
-     * @return The command that the string matches
+     * @brief Tell the host that a line was taken
+     * @param line The line number
+     * @note The ack is !ACK,N<line>,Q<free queue slots>;
     */
-    GCodeDefinitions::Command matchToCommand(char *str, uint8_t length);
+    void sendAck(int32_t line);
 
     /**
-     * @brief Populate a single value in the given command with the data from the string
-     * @param str The string to parse
-     * @param length The length of the string
+     * @brief Ask the host to send everything again from a line
+     * @param line The first line to send again
+     * @note The request is !RS,N<line>;
     */
-    void populateCommandWithData(GCodeDefinitions::GCode *command, char *str, uint8_t length);
+    void requestResend(int32_t line);
 
     /**
-     * @brief Capitalize a string
-     * @param str A pointer to the string to capitalize
+     * @brief Ask for the lines that were in a frame that couldn't be read, if the host is numbering lines
     */
-    void capitalize(char *str);
+    void requestLostLines();
 };
 
 #endif // GCODE_MESSAGE_H
\ No newline at end of file
@@ -0,0 +1,149 @@
+/**
+ * @file GCodeParser.cpp
+ * @brief This file contains the GCodeParser implimentation
+ * @version 1.0.0
+ * @author Quinn Henthorne. Contact: quinn.henthorne@gmail.com
+*/
+
+#include "GCodeParser.h"
+#include <stdio.h>
+
+/**
+ * @brief Make a letter uppercase
+ * @param c The character to fold
+ * @return The uppercase letter, or the character as it was if it isn't a lowercase letter
+*/
+static inline char foldCase(char c){
+    return (c >= 'a' && c <= 'z') ? c - ('a' - 'A') : c;
+}
+
+/**
+ * @brief Put a parsed value into the field of the command it belongs to
+ * @param command The command to populate
+ * @param valueType The letter in front of the value
+ * @param value The parsed value
+ * @return false if the letter isn't a field we know about
+*/
+static bool populateCommandWithData(GCodeDefinitions::GCode &command, char valueType, int32_t value){
+    uint8_t axis = GCodeDefinitions::AxisIndex(valueType);
+    if(axis < GCodeDefinitions::AXIS_COUNT){
+        command.SetAxis(axis, value);
+        return true;
+    }
+    switch(valueType){
+        case 'F':
+            command.F = value;
+            command.hasF = true;
+            break;
+        case 'S':
+            command.S = value;
+            command.hasS = true;
+            break;
+        case 'P':
+            command.P = value;
+            command.hasP = true;
+            break;
+        case 'T':
+            command.T = value;
+            command.hasT = true;
+            break;
+        case 'N':
+            command.N = value;
+            command.hasN = true;
+            break;
+        default:
+            return false;
+    }
+    return true;
+}
+
+GCodeDefinitions::GCode GCodeParser::Parse(const char *message, uint16_t length){
+    GCodeDefinitions::GCode newCommand = GCodeDefinitions::GCode();
+
+    // the command runs up to the first comma
+    uint16_t i = 0;
+    while(i < length && message[i] != ','){
+        i++;
+    }
+    newCommand.command = MatchToCommand(message, i);
+    // keep reading the values of a command that won't parse, so its line number can still be asked for again
+    bool isValid = newCommand.command != GCodeDefinitions::Command::INVALID;
+
+    // every value after that is a letter followed by a number, like atoi() would read it
+    while(i < length){
+        // skip the comma. A comma at the very end doesn't start a value
+        i++;
+        if(i == length){
+            break;
+        }
+        char valueType = foldCase(message[i]);
+        i++;
+
+        bool isNegative = false;
+        if(i < length && (message[i] == '-' || message[i] == '+')){
+            isNegative = message[i] == '-';
+            i++;
+        }
+        int32_t value = 0;
+        while(i < length && message[i] >= '0' && message[i] <= '9'){
+            value = value * 10 + (message[i] - '0');
+            i++;
+        }
+        // ignore anything else in the value, like a decimal part
+        while(i < length && message[i] != ','){
+            i++;
+        }
+
+        if(!populateCommandWithData(newCommand, valueType, isNegative ? -value : value)){
+            isValid = false;
+        }
+    }
+
+    if(!isValid){
+        newCommand.command = GCodeDefinitions::Command::INVALID;
+    }
+    return newCommand;
+}
+
+GCodeDefinitions::Command GCodeParser::MatchToCommand(const char *str, uint8_t length){
+    // a command is a letter followed by at least one digit
+    if(length < 2){
+        return GCodeDefinitions::Command::INVALID;
+    }
+
+    // the whole rest of the string has to be the number, so M1 and M114 can't be mistaken for each other
+    uint16_t number = 0;
+    for(uint8_t i = 1; i < length; i++){
+        if(str[i] < '0' || str[i] > '9'){
+            return GCodeDefinitions::Command::INVALID;
+        }
+        number = number * 10 + (str[i] - '0');
+        if(number > GCODE_MAX_COMMAND_NUMBER){
+            return GCodeDefinitions::Command::INVALID;
+        }
+    }
+
+    return GCodeDefinitions::DecodeCommand(foldCase(str[0]), number);
+}
+
+uint16_t GCodeParser::Format(const GCodeDefinitions::GCode &command, char *buffer, uint16_t size){
+    int length = snprintf(buffer, size, "%s", GCodeDefinitions::commandStrings[command.command]);
+    // the values go in the same order the parser documents them, axes first
+    for(uint8_t i = 0; i < GCodeDefinitions::AXIS_COUNT && length >= 0 && length < size; i++){
+        if(command.HasAxis(i)){
+            length += snprintf(buffer + length, size - length, ",%c%ld", GCodeDefinitions::axisLetters[i], static_cast<long>(command.axes[i]));
+        }
+    }
+    const char letters[] = {'F', 'S', 'P', 'T'};
+    const bool hasValues[] = {command.hasF, command.hasS, command.hasP, command.hasT};
+    const int32_t values[] = {command.F, command.S, command.P, command.T};
+    for(uint8_t i = 0; i < sizeof(letters) && length >= 0 && length < size; i++){
+        if(hasValues[i]){
+            length += snprintf(buffer + length, size - length, ",%c%ld", letters[i], static_cast<long>(values[i]));
+        }
+    }
+    if(length < 0 || length >= size){
+        return 0;
+    }
+    return length;
+}
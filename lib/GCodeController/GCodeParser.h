@@ -0,0 +1,47 @@
+/**
+ * @file GCodeParser.h
+ * @brief This file contains the GCodeParser functions which turn a received string into a GCode struct
+ * @details The parser makes a single pass over the string where it was received. Case is folded and numbers are
+ * parsed as the characters are scanned, so nothing is copied. It doesn't depend on the Arduino framework,
+ * so the same parser can be built into host tools.
+ * @version 1.0.0
+ * @author Quinn Henthorne. Contact: quinn.henthorne@gmail.com
+*/
+
+#ifndef GCODE_PARSER_H
+#define GCODE_PARSER_H
+
+#include <stdint.h>
+#include "GCODE-DEFINITIONS.h"
+
+namespace GCodeParser{
+    /**
+     * @brief Parse a string into its constituent components
+     * @param message The string to parse without the start and end markers. It is not modified
+     * @param length The length of the string
+     * @return The parsed GCode. The command is INVALID if the string couldn't be parsed
+     * @note The string is organized as COMMAND,X###,R###,F###,S###,P###,T###,N### where everything after the command is optional.
+     * X and R are the axes in GCODE_AXES, and every axis listed there is parsed the same way
+    */
+    GCodeDefinitions::GCode Parse(const char *message, uint16_t length);
+
+    /**
+     * @brief Check if a string matches a command
+     * @param str The string to check. Lowercase letters match uppercase ones
+     * @param length The length of the string
+     * @return The command that the string matches, or INVALID if it isn't a known letter followed by only digits
+    */
+    GCodeDefinitions::Command MatchToCommand(const char *str, uint8_t length);
+
+    /**
+     * @brief Write a GCode back out as a string that Parse() would read
+     * @param command The command to write
+     * @param buffer Where to write the string. It is null terminated
+     * @param size The size of the buffer
+     * @return The length of the string, or 0 if it didn't fit
+     * @note The string doesn't have the start and end markers, and the line number isn't written
+    */
+    uint16_t Format(const GCodeDefinitions::GCode &command, char *buffer, uint16_t size);
+};
+
+#endif // GCODE_PARSER_H
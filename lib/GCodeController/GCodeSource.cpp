@@ -0,0 +1,28 @@
+/**
+ * @file GCodeSource.cpp
+ * @brief This file contains the GCodeSource implimentation
+ * @version 1.0.0
+ * @author Quinn Henthorne. Contact: quinn.henthorne@gmail.com
+*/
+
+#include "GCodeSource.h"
+#include <stdarg.h>
+#include <stdio.h>
+
+void GCodeSource::Reply(const char *format, ...){
+    // the other core can print on the same output, so a reply is sent in one write to stay in one piece
+    char reply[GCODE_SOURCE_REPLY_LENGTH];
+    va_list args;
+    va_start(args, format);
+    int length = vsnprintf(reply, sizeof(reply) - 2, format, args);
+    va_end(args);
+    if(length < 0){
+        return;
+    }
+    if(length > static_cast<int>(sizeof(reply)) - 3){
+        length = sizeof(reply) - 3;
+    }
+    reply[length++] = '\r';
+    reply[length++] = '\n';
+    this->replyOutput->write(reinterpret_cast<const uint8_t *>(reply), length);
+}
@@ -0,0 +1,60 @@
+/**
+ * @file GCodeSource.h
+ * @brief This file contains the GCodeSource interface, for anything commands are taken from in order
+ * @details A source also knows where the replies to its commands go, so a command is always answered on the channel
+ * it came from.
+ * @version 1.0.0
+ * @author Quinn Henthorne. Contact: quinn.henthorne@gmail.com
+*/
+
+#ifndef GCODE_SOURCE_H
+#define GCODE_SOURCE_H
+
+#include <Arduino.h>
+#include "GCODE-DEFINITIONS.h"
+
+// the longest reply Reply() formats. Longer ones are cut short
+#define GCODE_SOURCE_REPLY_LENGTH 128
+
+class GCodeSource{
+    public:
+        virtual ~GCodeSource(){}
+
+        /**
+         * @brief Returns the next command without taking it
+         * @return the next command. NULL if there isn't one ready
+        */
+        virtual GCodeDefinitions::GCode * PeekGCode() = 0;
+
+        /**
+         * @brief Take the next command
+         * @return the command
+        */
+        virtual GCodeDefinitions::GCode * PopGCode() = 0;
+
+        /**
+         * @brief Set where the replies to this source's commands go
+         * @param output Where replies go, like a TxBuffer in front of the port so they never block. Must not be NULL
+        */
+        void SetReplyOutput(Print *output){
+            this->replyOutput = output;
+        }
+
+        /**
+         * @brief Get where the replies to this source's commands go
+         * @return The output replies are printed to
+        */
+        Print * GetReplyOutput(){ return replyOutput; }
+
+        /**
+         * @brief Format a reply and send it as one line, like printf()
+         * @param format The printf format of the reply, without its line ending
+         * @note The reply is sent in one write, so it stays in one piece if something else prints on the same output
+        */
+        void Reply(const char *format, ...) __attribute__((format(printf, 2, 3)));
+
+    protected:
+        Print *replyOutput{NULL}; // where replies are sent
+};
+
+#endif // GCODE_SOURCE_H
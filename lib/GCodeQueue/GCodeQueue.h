@@ -1,6 +1,8 @@
 /**
  * @file GCodeQueue.h
  * @brief This file contains the GCodeQueue class which will hold GCode commands until we are ready to execute them
+ * @details The queue is a ring buffer, so pushing and popping take the same time no matter how deep it is.
+ * It is safe for one task to push while another task pops without any locks.
  * @version 1.0.0
  * @author Quinn Henthorne. Contact: quinn.henthorne@gmail.com
 */
@@ -8,15 +10,26 @@
 #ifndef GCODE_QUEUE_H
 #define GCODE_QUEUE_H
 
+#include <Arduino.h>
+#include <atomic>
 #include "GCODE-DEFINITIONS.h"
+#include "Log.h"
 
 /*
-    The maximum number of GCode commands that can be stored in the queue before additional commands are discarded
+    The default maximum number of GCode commands that can be stored in the queue before additional commands are discarded
     Commands in the queue will try to be processed as fast as possible.
-    Once the command is processed, the queue will remove the command from the queue and shift all other commands down one index
+    This must be a power of 2. It can be overridden with a build flag
 */
-#define GCODE_QUEUE_MAX_SIZE 20
+#ifndef GCODE_QUEUE_MAX_SIZE
+#define GCODE_QUEUE_MAX_SIZE 256
+#endif
+
+template <uint16_t Depth = GCODE_QUEUE_MAX_SIZE>
 class GCodeQueue{
+    // the read and write counters run freely and wrap around, which only lines up with the buffer if the depth is a power of 2
+    static_assert(Depth > 0 && (Depth & (Depth - 1)) == 0, "GCodeQueue depth must be a power of 2");
+    static_assert(Depth <= 32768, "GCodeQueue depth must fit in the counters");
+
     public:
 
         /**
@@ -28,43 +41,77 @@ class GCodeQueue{
          * @brief Add a GCode command to the end of the queue
          * @param command the GCode command to add to the queue
          * @return true if the command was added to the queue. False if the queue is full and the command was not added
+         * @note Only one task may push to the queue
         */
-        bool push(const GCodeDefinitions::GCode &command);
+        bool push(const GCodeDefinitions::GCode &command){
+            uint16_t tail = this->tail.load(std::memory_order_relaxed);
+            // check if the queue is full
+            if(static_cast<uint16_t>(tail - this->head.load(std::memory_order_acquire)) == Depth){
+                LOG_ERROR("GCodeQueue::push(): queue is full. This command will be discarded");
+                return false;
+            }
+
+            // add the command to the queue
+            this->commands[tail % Depth] = command.copy();
+            // the command has to be written before the consumer can see it
+            this->tail.store(tail + 1, std::memory_order_release);
+            return true;
+        }
 
         /**
          * @brief Pop a GCode command from the front of the queue
          * @return GCode the GCode command that was popped from the queue
          * @note if the queue is empty then NULL is returned. Also, the GCode command popped from the queue must be used completetly before calling this function again.
-         * Calling this function a second time will overwrite the GCode command that was popped from the queue
+         * Calling this function a second time will overwrite the GCode command that was popped from the queue.
+         * Only one task may pop from the queue
         */
-        GCodeDefinitions::GCode * pop();
+        GCodeDefinitions::GCode * pop(){
+            uint16_t head = this->head.load(std::memory_order_relaxed);
+            // check if the queue is empty
+            if(head == this->tail.load(std::memory_order_acquire)){
+                return NULL;
+            }
+
+            // copy the command out before the slot is handed back to the producer
+            this->currentCommand = this->commands[head % Depth];
+            this->head.store(head + 1, std::memory_order_release);
+
+            return &this->currentCommand;
+        }
 
+        /**
+         * @brief Get the GCode command at the front of the queue without removing it
+         * @return A pointer to the command at the front of the queue. NULL if the queue is empty
+        */
         GCodeDefinitions::GCode * peek(){
-            return &commands[0];
+            uint16_t head = this->head.load(std::memory_order_relaxed);
+            if(head == this->tail.load(std::memory_order_acquire)){
+                return NULL;
+            }
+            return &this->commands[head % Depth];
         }
 
         /**
          * @brief Get the number of GCode commands in the queue
          * @return int the number of GCode commands in the queue
         */
-        uint16_t size();
+        uint16_t size(){
+            return static_cast<uint16_t>(this->tail.load(std::memory_order_acquire) - this->head.load(std::memory_order_acquire));
+        }
 
         /**
          * @brief Get the maximum number of GCode commands that can be stored in the queue
          * @return int the maximum number of GCode commands that can be stored in the queue
         */
-        static uint16_t max_size(){return GCODE_QUEUE_MAX_SIZE;};
+        static uint16_t max_size(){return Depth;};
+
     private:
-        uint16_t currentQueueSize = 0; // the number of GCode commands in the queue
+        std::atomic<uint16_t> head{0}; // the number of commands that have been popped. Only written by the consumer
+        std::atomic<uint16_t> tail{0}; // the number of commands that have been pushed. Only written by the producer
         // create an array of GCode commands
-        GCodeDefinitions::GCode commands[GCODE_QUEUE_MAX_SIZE];
+        GCodeDefinitions::GCode commands[Depth];
 
         GCodeDefinitions::GCode currentCommand; // the current GCode command being executed
-
-        /**
-         * @brief shift all GCode commands in the queue down one index
-        */
-        void shiftDown();
 };
 
-#endif // GCODE_QUEUE_H
\ No newline at end of file
+#endif // GCODE_QUEUE_H
@@ -0,0 +1,25 @@
+/**
+ * @file EthernetConfiguration.h
+ * @brief This file contains the EthernetConfiguration struct
+ * @details The configuration holds the wiring of the LAN8720 PHY and the static address the GCodeServer takes on the network
+ * @version 1.0.0
+ * @author Quinn Henthorne. Contact: quinn.henthorne@gmail.com
+*/
+
+#ifndef ETHERNET_CONFIGURATION_H
+#define ETHERNET_CONFIGURATION_H
+
+#include <stdint.h>
+
+// the wiring of the Ethernet PHY and the address to use on the network
+struct EthernetConfiguration{
+    const uint8_t phyAddress; // the address of the PHY on the MDIO bus
+    const int8_t mdcPin;
+    const int8_t mdioPin;
+    const int8_t clockPin; // the pin the 50MHz RMII clock comes in or goes out on. 0 is in, 16 and 17 are out
+    const uint8_t ip[4];
+    const uint8_t gateway[4];
+    const uint8_t subnetMask[4];
+};
+
+#endif // ETHERNET_CONFIGURATION_H
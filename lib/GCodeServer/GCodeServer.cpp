@@ -0,0 +1,94 @@
+/**
+ * @file GCodeServer.cpp
+ * @brief This file contains the GCodeServer implimentation
+ * @version 1.0.0
+ * @author Quinn Henthorne. Contact: quinn.henthorne@gmail.com
+*/
+
+#include "GCodeServer.h"
+
+#if defined(ARDUINO_ARCH_ESP32) && CONFIG_ETH_USE_ESP32_EMAC
+#include <ETH.h>
+
+/**
+ * @brief Work out the RMII clock mode from the pin the clock is on
+ * @param pin The clock pin
+ * @return The clock mode
+*/
+static eth_clock_mode_t clockModeFromPin(int8_t pin){
+    switch(pin){
+        case 16:
+            return ETH_CLOCK_GPIO16_OUT;
+        case 17:
+            return ETH_CLOCK_GPIO17_OUT;
+        default:
+            return ETH_CLOCK_GPIO0_IN;
+    }
+}
+#endif
+
+GCodeServer::GCodeServer(const EthernetConfiguration &configuration, uint16_t port) :
+    configuration(configuration),
+    server(port),
+    message(&client),
+    replies(&client){
+    this->message.SetReplyOutput(&this->replies);
+}
+
+bool GCodeServer::Begin(){
+    bool isStarted = true;
+#if defined(ARDUINO_ARCH_ESP32) && CONFIG_ETH_USE_ESP32_EMAC
+    // there is no power pin on the board, so -1
+#if ESP_ARDUINO_VERSION_MAJOR >= 3
+    isStarted = ETH.begin(ETH_PHY_LAN8720, this->configuration.phyAddress, this->configuration.mdcPin,
+        this->configuration.mdioPin, -1, clockModeFromPin(this->configuration.clockPin));
+#else
+    isStarted = ETH.begin(this->configuration.phyAddress, -1, this->configuration.mdcPin,
+        this->configuration.mdioPin, ETH_PHY_LAN8720, clockModeFromPin(this->configuration.clockPin));
+#endif
+    const uint8_t *ip = this->configuration.ip;
+    const uint8_t *gateway = this->configuration.gateway;
+    const uint8_t *subnetMask = this->configuration.subnetMask;
+    ETH.config(IPAddress(ip[0], ip[1], ip[2], ip[3]),
+        IPAddress(gateway[0], gateway[1], gateway[2], gateway[3]),
+        IPAddress(subnetMask[0], subnetMask[1], subnetMask[2], subnetMask[3]));
+#elif defined(ARDUINO_ARCH_ESP32)
+    // this chip doesn't have an Ethernet MAC
+    isStarted = false;
+#endif
+    this->server.begin();
+    // acks are small, so don't hold them back waiting for more data
+    this->server.setNoDelay(true);
+    // the server is false if it couldn't listen on the port
+    return isStarted && this->server;
+}
+
+void GCodeServer::Update(){
+    // take a new host if the last one has gone. Anyone else waiting is turned away
+    GCodeClientSocket newClient = this->server.available();
+    if(newClient){
+        if(this->client.connected()){
+            newClient.stop();
+        }
+        else{
+            this->client.stop();
+            this->client = newClient;
+            this->message.Reset();
+            this->replies.Clear();
+        }
+    }
+
+    this->message.Update();
+
+    // the socket can't say how much room it has, so a bit is written each update
+    if(this->client.connected()){
+        this->replies.Drain(GCODE_SERVER_DRAIN_LENGTH);
+    }
+    else{
+        this->replies.Clear();
+    }
+}
+
+bool GCodeServer::IsConnected(){
+    return this->client.connected();
+}
@@ -0,0 +1,75 @@
+/**
+ * @file GCodeServer.h
+ * @brief This file contains the GCodeServer class
+ * @details This file contains the GCodeServer class which takes GCode over TCP on the Ethernet port.
+ * Commands are read with a GCodeMessage, so they are parsed and queued exactly like commands from the serial ports,
+ * and the line number acks and binary framing work the same way. One host can be connected at a time.
+ * Replies to the host are buffered and sent from Update(), so the main loop can answer a command without touching the socket.
+ * When building for anything other than the ESP32 the server listens on 127.0.0.1 instead.
+ * @version 1.0.0
+ * @author Quinn Henthorne. Contact: quinn.henthorne@gmail.com
+*/
+
+#ifndef GCODE_SERVER_H
+#define GCODE_SERVER_H
+
+#include <Arduino.h>
+#include "GCodeMessage.h"
+#include "TxBuffer.h"
+#include "EthernetConfiguration.h"
+
+#ifdef ARDUINO_ARCH_ESP32
+#include <WiFi.h>
+typedef WiFiServer GCodeServerSocket;
+typedef WiFiClient GCodeClientSocket;
+#else
+#include "LoopbackSocket.h"
+typedef LoopbackServer GCodeServerSocket;
+typedef LoopbackClient GCodeClientSocket;
+#endif
+
+// the most reply bytes written to the host in one update
+#define GCODE_SERVER_DRAIN_LENGTH 512
+
+class GCodeServer{
+    public:
+        /**
+         * @brief Construct a new GCode Server object
+         * @param configuration The Ethernet pins and addresses
+         * @param port The TCP port to listen on
+        */
+        GCodeServer(const EthernetConfiguration &configuration, uint16_t port);
+
+        /**
+         * @brief Start the Ethernet interface with its static IP and start listening
+         * @return true if the Ethernet interface started and the server is listening
+        */
+        bool Begin();
+
+        /**
+         * @brief Accept a host if one is waiting, read anything it has sent and send it the replies that are waiting
+         * @note This never blocks, so it can be called every loop. Replies for a host that has gone are thrown away
+        */
+        void Update();
+
+        /**
+         * @brief Returns true if a host is connected
+         * @return true if a host is connected
+        */
+        bool IsConnected();
+
+        /**
+         * @brief Returns the message the commands from the host are read into
+         * @return The message. Use it like the serial messages. Its replies go to the host
+        */
+        GCodeMessage & GetMessage(){ return message; }
+
+    private:
+        const EthernetConfiguration &configuration;
+        GCodeServerSocket server;
+        GCodeClientSocket client; // the connected host
+        GCodeMessage message; // reads from client
+        TxBuffer replies; // the replies waiting to be sent to client
+};
+
+#endif // GCODE_SERVER_H
@@ -0,0 +1,113 @@
+/**
+ * @file LoopbackSocket.cpp
+ * @brief This file contains the LoopbackServer and LoopbackClient implimentation
+ * @version 1.0.0
+ * @author Quinn Henthorne. Contact: quinn.henthorne@gmail.com
+*/
+
+#ifndef ARDUINO_ARCH_ESP32
+
+#include "LoopbackSocket.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+
+uint8_t LoopbackClient::connected(){
+    if(this->socket < 0){
+        return false;
+    }
+    // a read of 0 bytes means the other end has closed the connection
+    char c;
+    ssize_t result = recv(this->socket, &c, 1, MSG_PEEK | MSG_DONTWAIT);
+    if(result == 0 || (result < 0 && errno != EAGAIN && errno != EWOULDBLOCK)){
+        return false;
+    }
+    return true;
+}
+
+void LoopbackClient::stop(){
+    if(this->socket >= 0){
+        close(this->socket);
+    }
+    this->socket = -1;
+}
+
+int LoopbackClient::available(){
+    int count = 0;
+    if(this->socket < 0 || ioctl(this->socket, FIONREAD, &count) < 0){
+        return 0;
+    }
+    return count;
+}
+
+int LoopbackClient::read(){
+    uint8_t c;
+    if(this->socket < 0 || recv(this->socket, &c, 1, MSG_DONTWAIT) != 1){
+        return -1;
+    }
+    return c;
+}
+
+int LoopbackClient::peek(){
+    uint8_t c;
+    if(this->socket < 0 || recv(this->socket, &c, 1, MSG_PEEK | MSG_DONTWAIT) != 1){
+        return -1;
+    }
+    return c;
+}
+
+size_t LoopbackClient::write(uint8_t byte){
+    return this->write(&byte, 1);
+}
+
+size_t LoopbackClient::write(const uint8_t *buffer, size_t size){
+    if(this->socket < 0){
+        return 0;
+    }
+    ssize_t written = send(this->socket, buffer, size, MSG_DONTWAIT | MSG_NOSIGNAL);
+    return written < 0 ? 0 : written;
+}
+
+uint16_t LoopbackServer::portOverride = 0;
+
+bool LoopbackServer::begin(){
+    this->socket = ::socket(AF_INET, SOCK_STREAM, 0);
+    if(this->socket < 0){
+        return false;
+    }
+    int reuse = 1;
+    setsockopt(this->socket, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(this->GetPort());
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if(bind(this->socket, reinterpret_cast<sockaddr *>(&address), sizeof(address)) < 0 || listen(this->socket, 1) < 0){
+        close(this->socket);
+        this->socket = -1;
+        return false;
+    }
+    // accept() must never block the loop
+    fcntl(this->socket, F_SETFL, fcntl(this->socket, F_GETFL) | O_NONBLOCK);
+    return true;
+}
+
+LoopbackClient LoopbackServer::available(){
+    if(this->socket < 0){
+        return LoopbackClient();
+    }
+    int client = accept(this->socket, NULL, NULL);
+    if(client < 0){
+        return LoopbackClient();
+    }
+    int noDelay = 1;
+    setsockopt(client, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+    return LoopbackClient(client);
+}
+
+#endif // ARDUINO_ARCH_ESP32
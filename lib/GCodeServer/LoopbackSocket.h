@@ -0,0 +1,107 @@
+/**
+ * @file LoopbackSocket.h
+ * @brief This file contains the LoopbackServer and LoopbackClient classes
+ * @details These stand in for WiFiServer and WiFiClient when building for Linux. They have the same interface,
+ * but listen on a non-blocking TCP socket on 127.0.0.1, so the GCodeServer can be tested with any TCP client.
+ * @version 1.0.0
+ * @author Quinn Henthorne. Contact: quinn.henthorne@gmail.com
+*/
+
+#ifndef LOOPBACK_SOCKET_H
+#define LOOPBACK_SOCKET_H
+
+#ifndef ARDUINO_ARCH_ESP32
+
+#include <Arduino.h>
+
+class LoopbackClient : public Stream{
+    public:
+        /**
+         * @brief Construct a client that isn't connected
+        */
+        LoopbackClient() : socket(-1){}
+
+        /**
+         * @brief Construct a client for a socket that has been accepted
+         * @param socket The accepted socket. It is closed when stop() is called
+        */
+        LoopbackClient(int socket) : socket(socket){}
+
+        /**
+         * @brief Returns true if the socket is still open and the other end hasn't closed it
+         * @return true if the client is connected
+        */
+        uint8_t connected();
+
+        /**
+         * @brief Close the socket
+        */
+        void stop();
+
+        int available() override;
+        int read() override;
+        int peek() override;
+        size_t write(uint8_t byte) override;
+        size_t write(const uint8_t *buffer, size_t size) override;
+        void flush() override{}
+
+        operator bool(){ return socket >= 0; }
+
+    private:
+        int socket; // the file descriptor of the socket. -1 if there isn't one
+};
+
+class LoopbackServer{
+    public:
+        /**
+         * @brief Construct a new Loopback Server object
+         * @param port The port to listen on
+        */
+        LoopbackServer(uint16_t port) : port(port){}
+
+        /**
+         * @brief Start listening on 127.0.0.1
+         * @return true if the server is listening. False if the port couldn't be opened, like when it is in use
+         * @note A port set with SetPortOverride() is used instead of the one the server was made with
+        */
+        bool begin();
+
+        /**
+         * @brief Returns true if the server is listening
+        */
+        operator bool(){ return socket >= 0; }
+
+        /**
+         * @brief Get the port the server listens on
+         * @return The port
+        */
+        uint16_t GetPort(){ return portOverride != 0 ? portOverride : port; }
+
+        /**
+         * @brief Make every server listen on a port picked when the program is run, like the simulator's --port
+         * @param port The port to use. 0 to go back to the port each server was made with
+         * @note This must be called before begin()
+        */
+        static void SetPortOverride(uint16_t port){ portOverride = port; }
+
+        /**
+         * @brief Doesn't do anything. Small writes are never delayed on the loopback interface
+        */
+        void setNoDelay(bool noDelay){}
+
+        /**
+         * @brief Accept a client if one is waiting
+         * @return The client. It is false if no one was waiting
+         * @note This never blocks
+        */
+        LoopbackClient available();
+
+    private:
+        const uint16_t port;
+        int socket{-1}; // the listening socket. -1 if it couldn't be opened
+        static uint16_t portOverride; // the port to use instead of port. 0 if there isn't one
+};
+
+#endif // ARDUINO_ARCH_ESP32
+
+#endif // LOOPBACK_SOCKET_H
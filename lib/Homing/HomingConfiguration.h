@@ -0,0 +1,23 @@
+#pragma once
+#include <stdint.h>
+
+/**
+ * @brief How an axis finds its home switch
+ * @details The axis runs at the switch at the fast speed, backs off until the switch lets go, then comes back at the slow speed.
+ * Only the slow approach decides where home is, so the fast speed can be as high as the axis can stop from
+ * within the back off distance, and the slow speed sets how precisely home repeats.
+*/
+struct HomingConfiguration{
+    const uint32_t fastSpeed; // the speed of the first approach and the back off in units per minute
+    const uint32_t slowSpeed; // the speed of the second approach in units per minute
+    const int32_t backOffDistance; // how far to back off the switch in units. The slow approach searches twice this far
+    const int32_t searchDistance; // how far the fast approach searches before it gives up, in units
+    const int8_t direction; // -1 if the switch is towards 0, 1 if it is the other way
+
+    constexpr HomingConfiguration(uint32_t fastSpeed, uint32_t slowSpeed, int32_t backOffDistance, int32_t searchDistance, int8_t direction) :
+        fastSpeed(fastSpeed),
+        slowSpeed(slowSpeed),
+        backOffDistance(backOffDistance),
+        searchDistance(searchDistance),
+        direction(direction){}
+};
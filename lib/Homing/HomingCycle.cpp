@@ -0,0 +1,120 @@
+/**
+ * @file HomingCycle.cpp
+ * @brief This file contains the HomingCycle implimentation
+ * @version 1.0.0
+ * @author Quinn Henthorne. Contact: quinn.henthorne@gmail.com
+*/
+
+#include "HomingCycle.h"
+#include <stdio.h>
+
+void HomingCycle::Start(bool isTriggered){
+    for(uint8_t i = 0; i < PHASE_COUNT; i++){
+        this->phaseTimes[i] = 0;
+    }
+    this->totalTime = 0;
+    this->timeStarted = millis();
+    this->timePhaseStarted = this->timeStarted;
+    this->phase = IDLE;
+
+    // if we're already on the switch there's nothing to approach, so back off first
+    if(isTriggered){
+        this->startPhase(BACK_OFF, -this->configuration.direction * this->configuration.backOffDistance, this->configuration.fastSpeed);
+    }
+    else{
+        this->startPhase(FAST_APPROACH, this->configuration.direction * this->configuration.searchDistance, this->configuration.fastSpeed);
+    }
+}
+
+void HomingCycle::Stop(){
+    this->phase = IDLE;
+}
+
+HomingCycle::Phase HomingCycle::Update(bool isTriggered){
+    switch(this->phase){
+        case FAST_APPROACH:
+            // stop on the step we're on and go back the other way
+            if(isTriggered){
+                this->startPhase(BACK_OFF, -this->configuration.direction * this->configuration.backOffDistance, this->configuration.fastSpeed);
+            }
+            // we went as far as the switch could be without finding it
+            else if(!this->motor->IsMoving()){
+                LOG_ERROR("Home switch not found");
+                this->startPhase(FAILED, 0, 0);
+            }
+            break;
+
+        case BACK_OFF:
+            // the back off always runs its whole distance, so the slow approach starts the same distance from the switch
+            if(!this->motor->IsMoving()){
+                // the back off is too short to get off the switch
+                if(isTriggered){
+                    LOG_ERROR("Still on the home switch after backing off");
+                    this->startPhase(FAILED, 0, 0);
+                }
+                else{
+                    this->startPhase(SLOW_APPROACH, this->configuration.direction * 2 * this->configuration.backOffDistance, this->configuration.slowSpeed);
+                }
+            }
+            break;
+
+        case SLOW_APPROACH:
+            if(isTriggered){
+                this->startPhase(DONE, 0, 0);
+            }
+            // the switch let go when we backed off but isn't there now
+            else if(!this->motor->IsMoving()){
+                LOG_ERROR("Home switch not found on the slow approach");
+                this->startPhase(FAILED, 0, 0);
+            }
+            break;
+
+        default:
+            break;
+    }
+    return this->phase;
+}
+
+void HomingCycle::startPhase(Phase next, int32_t distance, uint32_t speed){
+    uint32_t now = millis();
+    this->phaseTimes[this->phase] = now - this->timePhaseStarted;
+    this->timePhaseStarted = now;
+    this->phase = next;
+
+    this->scheduler->Lock();
+    // stopping on the step the switch was seen on is what makes home repeat, so this isn't rounded to a unit,
+    // and neither is the distance from there. Then the back off is the same number of steps every time
+    this->motor->Stop();
+    if(distance != 0){
+        this->motor->SetTargetSteps(this->motor->GetCurrentSteps() + this->motor->UnitsToSteps(distance));
+        this->motor->SetSpeed(speed);
+    }
+    this->scheduler->Unlock();
+
+    if(next == DONE || next == FAILED){
+        this->totalTime = now - this->timeStarted;
+    }
+    LOG_DEBUG("Homing %s", GetPhaseName(next));
+}
+
+void HomingCycle::Report(Print &output, const char *command){
+    char report[HOMING_REPORT_LENGTH];
+    snprintf(report, sizeof(report), "!%s,HOMING,F%lu,B%lu,S%lu,T%lu;\r\n", command,
+        static_cast<unsigned long>(this->phaseTimes[FAST_APPROACH]),
+        static_cast<unsigned long>(this->phaseTimes[BACK_OFF]),
+        static_cast<unsigned long>(this->phaseTimes[SLOW_APPROACH]),
+        static_cast<unsigned long>(this->totalTime));
+    output.print(report);
+}
+
+const char * HomingCycle::GetPhaseName(Phase phase){
+    switch(phase){
+        case IDLE: return "IDLE";
+        case FAST_APPROACH: return "FAST_APPROACH";
+        case BACK_OFF: return "BACK_OFF";
+        case SLOW_APPROACH: return "SLOW_APPROACH";
+        case DONE: return "DONE";
+        case FAILED: return "FAILED";
+        default: return "UNKNOWN";
+    }
+}
@@ -0,0 +1,125 @@
+/**
+ * @file HomingCycle.h
+ * @brief This file contains the HomingCycle class
+ * @details The homing cycle finds an axis's home switch in three phases. It runs at the switch quickly, backs off until
+ * the switch lets go, then comes back slowly so the switch is always hit at the same speed. Each phase is timed,
+ * so the speeds and back off distance can be tuned down to the shortest cycle that still repeats.
+ * The switch is read by the main loop and given to Update(), so the cycle doesn't care how it's wired.
+ * @version 1.0.0
+ * @author Quinn Henthorne. Contact: quinn.henthorne@gmail.com
+*/
+
+#ifndef HOMING_CYCLE_H
+#define HOMING_CYCLE_H
+
+#include <Arduino.h>
+#include "HomingConfiguration.h"
+#include "StepperMotor.h"
+#include "StepScheduler.h"
+#include "Log.h"
+
+// the longest timing report
+#define HOMING_REPORT_LENGTH 96
+
+class HomingCycle{
+    public:
+        enum Phase : uint8_t{
+            IDLE, // not homing
+            FAST_APPROACH, // running at the switch at the fast speed
+            BACK_OFF, // moving off the switch until it lets go
+            SLOW_APPROACH, // coming back to the switch at the slow speed
+            DONE, // the switch was found at the slow speed and the motor stopped on it
+            FAILED, // the switch wasn't where it should have been
+            PHASE_COUNT
+        };
+
+        /**
+         * @brief Construct a new Homing Cycle object
+         * @param motor The motor of the axis being homed
+         * @param scheduler The step scheduler whose lock is held while the motor is changed
+         * @param configuration How the axis finds its switch
+        */
+        HomingCycle(StepperMotor *motor, StepScheduler *scheduler, const HomingConfiguration &configuration) :
+            motor(motor),
+            scheduler(scheduler),
+            configuration(configuration){}
+
+        /**
+         * @brief Start the fast approach
+         * @param isTriggered true if the switch is already triggered, in which case the cycle starts by backing off
+         * @note The planner must be cleared first, so nothing else is stepping the motor
+        */
+        void Start(bool isTriggered);
+
+        /**
+         * @brief Stop the cycle where it is, without moving the motor
+         * @note Call this once a finished or failed cycle has been dealt with. The times are kept for the report
+        */
+        void Stop();
+
+        /**
+         * @brief Move to the next phase when the one running is finished
+         * @param isTriggered true if the home switch is triggered
+         * @return The phase the cycle is in after the update
+         * @note This must be called every loop while homing. How precisely home repeats depends on how often it's called
+        */
+        Phase Update(bool isTriggered);
+
+        /**
+         * @brief Get the phase the cycle is in
+        */
+        Phase GetPhase(){ return phase; }
+
+        /**
+         * @brief Returns true if the cycle has started and hasn't been stopped
+        */
+        bool IsRunning(){ return phase != IDLE; }
+
+        /**
+         * @brief Get how long a phase of the last cycle took
+         * @param phase FAST_APPROACH, BACK_OFF or SLOW_APPROACH
+         * @return The time in ms. 0 if the phase hasn't finished
+        */
+        uint32_t GetPhaseTime(Phase phase){ return phaseTimes[phase]; }
+
+        /**
+         * @brief Get how long the last cycle took
+         * @return The time in ms. 0 if it hasn't finished
+        */
+        uint32_t GetTotalTime(){ return totalTime; }
+
+        /**
+         * @brief Print how long each phase of the last cycle took as !<command>,HOMING,F<fast>,B<back off>,S<slow>,T<total>;
+         * @param output Where to print it
+         * @param command The command the report is for, like G28 or M881
+         * @note The times are in ms. A phase that didn't finish is 0
+        */
+        void Report(Print &output, const char *command);
+
+        /**
+         * @brief Get the name of a phase
+         * @param phase The phase
+        */
+        static const char * GetPhaseName(Phase phase);
+
+    private:
+        StepperMotor *motor;
+        StepScheduler *scheduler;
+        const HomingConfiguration configuration;
+
+        Phase phase{IDLE};
+        uint32_t timeStarted{0}; // when the cycle started in ms
+        uint32_t timePhaseStarted{0}; // when the phase that's running started in ms
+        uint32_t phaseTimes[PHASE_COUNT]{}; // how long each phase took in ms
+        uint32_t totalTime{0}; // how long the whole cycle took in ms. 0 until it's done or failed
+
+        /**
+         * @brief Finish the phase that's running and start another
+         * @param next The phase to start
+         * @param distance How far to move from where the motor is, in units. 0 to stop it where it is
+         * @param speed The speed to move at in units per minute
+        */
+        void startPhase(Phase next, int32_t distance, uint32_t speed);
+};
+
+#endif // HOMING_CYCLE_H
@@ -13,9 +13,9 @@ I2CDigitalIO::I2CDigitalIO(const I2CPin& pin, bool initialState) : pin(pin) {
 }
 
 void I2CDigitalIO::Set(bool value) {
-    this->pin.i2cPort->write(this->pin.number, value);
+    this->pin.i2cPort->Write(this->pin.number, value);
 }
 
 bool I2CDigitalIO::Get() {
-    return this->pin.i2cPort->read(this->pin.number);
+    return this->pin.i2cPort->Read(this->pin.number);
 }
\ No newline at end of file
@@ -22,6 +22,7 @@ class I2CDigitalIO {
     /**
      * @brief Set the state of the pin
      * @param value The value to set the pin to
+     * @note The new value is sent to the expander the next time its port is flushed
     */
     void Set(bool value);
 
@@ -10,15 +10,15 @@
 #define I2C_PIN_H
 
 #include <cstdint>
-#include <PCF8574.h>
+#include "I2CPort.h"
 
 struct I2CPin{
     // the pin number
     uint8_t number;
     // a pointer to the I2C port that the pin is connected to
-    PCF8574* i2cPort;
+    I2CPort* i2cPort;
 
-    I2CPin(uint8_t pin, PCF8574* i2cPort) : number(pin), i2cPort(i2cPort){}
+    constexpr I2CPin(uint8_t pin, I2CPort* i2cPort) : number(pin), i2cPort(i2cPort){}
 };
 
 #endif // I2C_PIN_H
\ No newline at end of file
@@ -0,0 +1,69 @@
+/**
+ * @file I2CPort.cpp
+ * @brief This file contains the I2CPort implimentation
+ * @version 1.0.0
+ * @author Quinn Henthorne. Contact: quinn.henthorne@gmail.com
+*/
+
+#include "I2CPort.h"
+
+bool I2CPort::Begin(uint8_t initialValue){
+    this->shadow = initialValue;
+    this->lastWritten = initialValue;
+    this->pulseMask = 0;
+    this->transactionCount++;
+    return this->expander.begin(initialValue);
+}
+
+void I2CPort::WriteMask(uint8_t mask, bool value){
+    if(value){
+        this->shadow |= mask;
+    }
+    else{
+        this->shadow &= ~mask;
+    }
+}
+
+bool I2CPort::PulseMask(uint8_t mask, bool activeState){
+    uint8_t activeLevel = activeState ? mask : 0;
+    // the pins are still sitting in their active state from the last pulse, so there would be no edge
+    if((this->lastWritten & mask) == activeLevel && (this->shadow & mask) != activeLevel){
+        return false;
+    }
+
+    this->pulseMask |= mask;
+    this->pulseLevels = (this->pulseLevels & ~mask) | activeLevel;
+    return true;
+}
+
+bool I2CPort::Read(uint8_t pin){
+    return this->expander.read(pin);
+}
+
+void I2CPort::WriteBurst(const uint8_t *images, uint8_t count){
+    if(count == 0){
+        return;
+    }
+
+    this->wire->beginTransmission(this->address);
+    this->wire->write(images, count);
+    this->wire->endTransmission();
+
+    this->pulseMask = 0;
+    this->lastWritten = images[count - 1];
+    this->transactionCount++;
+}
+
+void I2CPort::Flush(){
+    uint8_t image = (this->shadow & ~this->pulseMask) | (this->pulseLevels & this->pulseMask);
+    // pulsed pins go back to their shadow value on the next flush
+    this->pulseMask = 0;
+
+    if(image == this->lastWritten){
+        return;
+    }
+
+    this->expander.write8(image);
+    this->lastWritten = image;
+    this->transactionCount++;
+}
@@ -0,0 +1,120 @@
+/**
+ * @file I2CPort.h
+ * @brief This file contains the I2CPort class
+ * @details This file contains the I2CPort class which keeps a shadow copy of a PCF8574 port so that
+ * any number of pin changes can be sent to the expander in a single I2C transaction
+ * @version 1.0.0
+ * @author Quinn Henthorne. Contact: quinn.henthorne@gmail.com
+*/
+
+#ifndef I2C_PORT_H
+#define I2C_PORT_H
+
+#include <stdint.h>
+#include <Wire.h>
+#include <PCF8574.h>
+
+class I2CPort{
+    public:
+        /**
+         * @brief Construct a new I2C Port object
+         * @param address The I2C address of the PCF8574
+         * @param wire A pointer to the I2C bus the PCF8574 is on
+        */
+        I2CPort(uint8_t address, TwoWire *wire) :
+            expander(address, wire),
+            wire(wire),
+            address(address){}
+
+        /**
+         * @brief Initialize the expander and write the initial port value to it
+         * @param initialValue The value to write to all 8 pins
+         * @return true if the expander responded
+        */
+        bool Begin(uint8_t initialValue = 0xFF);
+
+        /**
+         * @brief Set the value of a pin in the shadow register
+         * @param pin The pin number (0-7)
+         * @param value The value to set the pin to
+         * @note Nothing is sent to the expander until Flush() is called
+        */
+        void Write(uint8_t pin, bool value){ WriteMask(1 << pin, value); }
+
+        /**
+         * @brief Set the value of the pins in a mask in the shadow register
+         * @param mask A bit for every pin to set
+         * @param value The value to set the pins to
+         * @note This is Write() for callers that worked out the mask ahead of time
+        */
+        void WriteMask(uint8_t mask, bool value);
+
+        /**
+         * @brief Drive a pin to its active state on the next flush and back to its idle state on the flush after that
+         * @param pin The pin number (0-7)
+         * @param activeState The state the pin should be in for the pulse
+         * @return true if the pulse was scheduled. False if the pin is still in the active state from the last pulse
+         * and hasn't been flushed back to its idle state yet
+        */
+        bool Pulse(uint8_t pin, bool activeState){ return PulseMask(1 << pin, activeState); }
+
+        /**
+         * @brief Pulse the pins in a mask, the same as Pulse()
+         * @param mask A bit for every pin to pulse
+         * @param activeState The state the pins should be in for the pulse
+         * @return true if the pulse was scheduled. False if the pins are still in the active state from the last pulse
+        */
+        bool PulseMask(uint8_t mask, bool activeState);
+
+        /**
+         * @brief Read the value of a pin from the expander
+         * @param pin The pin number (0-7)
+         * @return The value of the pin
+        */
+        bool Read(uint8_t pin);
+
+        /**
+         * @brief Send all pending pin changes to the expander in one write
+         * @note This function must be called in the main loop. It only talks to the bus if something changed
+        */
+        void Flush();
+
+        /**
+         * @brief Get the value every pin is set to, not including pending pulses
+         * @return The shadow register
+        */
+        uint8_t GetShadow(){ return shadow; }
+
+        /**
+         * @brief Stream a sequence of port images to the expander in a single I2C transaction
+         * @param images The port images to write, in order
+         * @param count The number of images to write
+         * @note The PCF8574 latches each byte as it is acknowledged, so every image is held on the pins
+         * for one byte time on the bus (9 clock cycles). Pending pulses are dropped by the burst.
+        */
+        void WriteBurst(const uint8_t *images, uint8_t count);
+
+        /**
+         * @brief Get the number of write transactions this port has put on the bus
+         * @return The number of write transactions since boot
+        */
+        uint32_t GetTransactionCount(){ return transactionCount; }
+
+        /**
+         * @brief Get the I2C address of the PCF8574
+         * @return The address
+        */
+        uint8_t GetAddress(){ return address; }
+
+    private:
+        PCF8574 expander;
+        TwoWire *wire;
+        uint8_t address;
+        uint8_t shadow{0xFF}; // the value every pin should settle at
+        uint8_t pulseMask{0}; // the pins that are pulsed in the next flush
+        uint8_t pulseLevels{0}; // the active levels of the pulsed pins
+        uint8_t lastWritten{0xFF}; // the last value sent to the expander
+        uint32_t transactionCount{0};
+};
+
+#endif // I2C_PORT_H
@@ -0,0 +1,63 @@
+/**
+ * @file MachineSnapshot.h
+ * @brief This file contains the MachineSnapshot class which shares the state of the machine between tasks
+ * @details The main loop publishes where the motors are and what the machine is doing once per pass, and the comms
+ * task reads it to answer status queries without touching the motors. Publishing never waits on a reader, and a
+ * reader that overlaps a publish just reads again, so the main loop is never held up.
+ * @version 1.0.0
+ * @author Quinn Henthorne. Contact: quinn.henthorne@gmail.com
+*/
+
+#ifndef MACHINE_SNAPSHOT_H
+#define MACHINE_SNAPSHOT_H
+
+#include <Arduino.h>
+#include <atomic>
+#include "MotionPlanner.h"
+
+struct MachineStatus{
+    int32_t position[MOTION_PLANNER_AXES]; // the current position of each axis
+    uint32_t speed[MOTION_PLANNER_AXES]; // the speed of each axis in units per minute
+    uint8_t state; // the MachineState::State the machine is in
+    bool isHomed; // true if the machine has been homed at least once
+};
+
+class MachineSnapshot{
+    public:
+        /**
+         * @brief Publish a new status
+         * @param status The status to publish
+         * @note Only one task may publish
+        */
+        void Publish(const MachineStatus &status){
+            uint32_t sequence = this->sequence.load(std::memory_order_relaxed);
+            // an odd sequence tells readers a publish is in progress
+            this->sequence.store(sequence + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            this->status = status;
+            this->sequence.store(sequence + 2, std::memory_order_release);
+        }
+
+        /**
+         * @brief Read the last published status
+         * @return A copy of the status that was never half published
+        */
+        MachineStatus Read() const{
+            MachineStatus status;
+            uint32_t before;
+            uint32_t after;
+            do{
+                before = this->sequence.load(std::memory_order_acquire);
+                status = this->status;
+                std::atomic_thread_fence(std::memory_order_acquire);
+                after = this->sequence.load(std::memory_order_relaxed);
+            } while((before & 1) != 0 || before != after);
+            return status;
+        }
+
+    private:
+        std::atomic<uint32_t> sequence{0};
+        MachineStatus status{};
+};
+
+#endif // MACHINE_SNAPSHOT_H
@@ -9,6 +9,7 @@
 #define MACHINE_STATE_H
 
 #include <Arduino.h>
+#include "Log.h"
 
 namespace MachineState{
     // all possible states of the machine which could interfere with executing another command
@@ -67,7 +68,7 @@ namespace MachineState{
         if(machineState.state == State::WAITING){
             if(millis() - machineState.timeEnteredState >= machineState.waitTime){
                 SetMachineState(State::IDLE);
-                Serial.println("Wait time complete");
+                LOG_INFO("Wait time complete");
             }
         }
     }
@@ -99,10 +100,13 @@ namespace MachineState{
             }
         }
 
-        // for the paused state, only pause/resume commands are valid
+        // for the paused state, only pause/resume, recipe status and abort, and timing report commands are valid
         if(state == State::PAUSED){
             switch(command){
             case GCodeDefinitions::Command::M24:
+            case GCodeDefinitions::Command::M27:
+            case GCodeDefinitions::Command::M524:
+            case GCodeDefinitions::Command::M881:
                 return true;
             default:
                 return false;
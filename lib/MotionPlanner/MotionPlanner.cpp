@@ -0,0 +1,408 @@
+/**
+ * @file MotionPlanner.cpp
+ * @brief This file contains the MotionPlanner class implimentation
+ * @version 1.0.0
+ * @author Quinn Henthorne. Contact: quinn.henthorne@gmail.com
+*/
+
+#include "MotionPlanner.h"
+
+// used as the acceleration of axes that don't have one configured
+#define MOTION_PLANNER_NO_ACCELERATION_LIMIT 1e12f
+
+/**
+ * @brief Work out the time between steps at a rate
+ * @param rate The rate in steps per second
+ * @return The interval in 1/256 us. A rate too slow for the interval to fit is held at the longest one
+*/
+static uint32_t rateToInterval(float rate){
+    float interval = (1000000.0f / rate) * (1 << RAMP_FRACTION_BITS);
+    if(!(interval < static_cast<float>(UINT32_MAX))){
+        return UINT32_MAX;
+    }
+    return static_cast<uint32_t>(interval);
+}
+
+MotionPlanner::MotionPlanner(StepperMotor *const motors[MOTION_PLANNER_AXES], const float maxJerk[MOTION_PLANNER_AXES]){
+    for(uint8_t i = 0; i < MOTION_PLANNER_AXES; i++){
+        this->motors[i] = motors[i];
+        this->maxJerk[i] = maxJerk[i] * motors[i]->GetConfiguration().stepsPerUnit / 60.0f;
+        this->plannedPosition[i] = 0;
+        this->plannedSteps[i] = 0;
+    }
+}
+
+bool MotionPlanner::AddMove(const int32_t target[MOTION_PLANNER_AXES], float feedRate, bool isRelative, uint8_t axisMask){
+    if(this->IsFull()){
+        return false;
+    }
+
+    // the feed rate is modal like in other GCode interpreters, so a move without one goes at the last one given.
+    // If there's never been one there's no speed to go at
+    feedRate = fabsf(feedRate);
+    if(feedRate == 0){
+        feedRate = this->feedRate;
+    }
+    if(feedRate == 0){
+        return false;
+    }
+    this->feedRate = feedRate;
+
+    // if nothing is planned, the motors may have been moved without us, so start from where they're going.
+    // The steps are taken as they are, since a motor that was stopped part way through a move can be between whole units
+    if(this->IsEmpty()){
+        for(uint8_t i = 0; i < MOTION_PLANNER_AXES; i++){
+            this->plannedPosition[i] = this->motors[i]->GetTargetPosition();
+            this->plannedSteps[i] = this->motors[i]->GetTargetSteps();
+        }
+    }
+
+    MotionBlock &block = this->blocks[this->blockIndex(this->count)];
+    block.stepEventCount = 0;
+    for(uint8_t i = 0; i < MOTION_PLANNER_AXES; i++){
+        if((axisMask & (1 << i)) == 0){
+            block.target[i] = this->plannedPosition[i];
+        }
+        else{
+            block.target[i] = isRelative ? this->plannedPosition[i] + target[i] : target[i];
+        }
+        // the motor won't go past its max travel, so we can't plan to either
+        int32_t maxTravel = this->motors[i]->GetMaxTravel();
+        if(maxTravel != 0 && block.target[i] > maxTravel){
+            block.target[i] = maxTravel;
+        }
+        // the motor converts the same way when it's given a target, so the planned steps land exactly where it expects
+        block.steps[i] = this->motors[i]->UnitsToSteps(block.target[i]) - this->plannedSteps[i];
+        uint32_t axisSteps = abs(block.steps[i]);
+        if(axisSteps > block.stepEventCount){
+            block.stepEventCount = axisSteps;
+        }
+    }
+
+    // there's nowhere to go
+    if(block.stepEventCount == 0){
+        return true;
+    }
+
+    // the feed rate is for the first axis that moves
+    uint8_t feedAxis = 0;
+    while(block.steps[feedAxis] == 0){
+        feedAxis++;
+    }
+    float feedAxisRate = feedRate * this->motors[feedAxis]->GetConfiguration().stepsPerUnit / 60.0f;
+    block.nominalRate = feedAxisRate * block.stepEventCount / abs(block.steps[feedAxis]);
+
+    // limit the move so no axis goes faster or accelerates harder than it can
+    block.acceleration = MOTION_PLANNER_NO_ACCELERATION_LIMIT;
+    for(uint8_t i = 0; i < MOTION_PLANNER_AXES; i++){
+        if(block.steps[i] == 0){
+            continue;
+        }
+        const StepperMotorConfiguration &configuration = this->motors[i]->GetConfiguration();
+        float axisShare = static_cast<float>(block.stepEventCount) / abs(block.steps[i]);
+
+        float maxRate = configuration.maxSpeed * configuration.stepsPerUnit / 60.0f * axisShare;
+        if(maxRate > 0 && block.nominalRate > maxRate){
+            block.nominalRate = maxRate;
+        }
+
+        float axisAcceleration = configuration.acceleration * configuration.stepsPerUnit / 3600.0f * axisShare;
+        if(axisAcceleration > 0 && axisAcceleration < block.acceleration){
+            block.acceleration = axisAcceleration;
+        }
+    }
+
+    // a move from a stop has to start from a stop, and so does a move after a compiled one
+    block.isCompiled = false;
+    block.maxEntryRate = 0;
+    if(this->count > 0 && !this->blocks[this->blockIndex(this->count - 1)].isCompiled){
+        block.maxEntryRate = this->junctionRate(this->blocks[this->blockIndex(this->count - 1)], block);
+    }
+    block.entryRate = 0;
+    block.exitRate = 0;
+    block.endEvent = MotionEvent{0, 0};
+
+    for(uint8_t i = 0; i < MOTION_PLANNER_AXES; i++){
+        this->plannedPosition[i] = block.target[i];
+        this->plannedSteps[i] += block.steps[i];
+    }
+    this->count++;
+    this->recalculate();
+    return true;
+}
+
+bool MotionPlanner::AddEvent(uint8_t pinMask, bool value){
+    if(this->count == 0){
+        return false;
+    }
+    MotionEvent event{static_cast<uint8_t>(value ? pinMask : 0), static_cast<uint8_t>(value ? 0 : pinMask)};
+    this->blocks[this->blockIndex(this->count - 1)].endEvent.Merge(event);
+    return true;
+}
+
+float MotionPlanner::junctionRate(const MotionBlock &previous, const MotionBlock &next){
+    // scale both moves down by the same amount until no axis has to change speed by more than its jerk
+    float scale = 1.0f;
+    for(uint8_t i = 0; i < MOTION_PLANNER_AXES; i++){
+        float previousSpeed = previous.nominalRate * previous.steps[i] / previous.stepEventCount;
+        float nextSpeed = next.nominalRate * next.steps[i] / next.stepEventCount;
+        float change = fabsf(previousSpeed - nextSpeed);
+        if(change > this->maxJerk[i] && this->maxJerk[i] / change < scale){
+            scale = this->maxJerk[i] / change;
+        }
+    }
+    return scale * next.nominalRate;
+}
+
+void MotionPlanner::recalculate(){
+    // the move that's running can't be changed, and neither can compiled moves
+    uint8_t first = this->isRunning ? 1 : 0;
+    for(uint8_t offset = first; offset < this->count; offset++){
+        if(this->blocks[this->blockIndex(offset)].isCompiled){
+            first = offset + 1;
+        }
+    }
+    if(this->count <= first){
+        return;
+    }
+
+    // reverse pass: make sure every move can slow down in time for the one after it, and the last move can stop
+    for(int16_t offset = this->count - 1; offset >= first; offset--){
+        MotionBlock &block = this->blocks[this->blockIndex(offset)];
+        float exitRate = 0;
+        if(offset < this->count - 1){
+            MotionBlock &next = this->blocks[this->blockIndex(offset + 1)];
+            exitRate = next.entryRate * block.nominalRate / next.nominalRate;
+        }
+        float entryRate = sqrtf(exitRate * exitRate + 2.0f * block.acceleration * block.stepEventCount);
+        // if the first move isn't running yet, the motors are stopped
+        float maxEntryRate = offset == 0 ? 0 : block.maxEntryRate;
+        block.entryRate = min(maxEntryRate, entryRate);
+    }
+
+    // forward pass: make sure every move can speed up to the entry of the one after it
+    for(uint8_t offset = first; offset < this->count; offset++){
+        MotionBlock &block = this->blocks[this->blockIndex(offset)];
+        if(offset > 0){
+            // the move before this one has already been planned, so we enter at whatever it exits at
+            MotionBlock &previous = this->blocks[this->blockIndex(offset - 1)];
+            block.entryRate = min(block.entryRate, previous.exitRate * block.nominalRate / previous.nominalRate);
+        }
+
+        block.exitRate = 0;
+        if(offset < this->count - 1){
+            MotionBlock &next = this->blocks[this->blockIndex(offset + 1)];
+            float maxExitRate = sqrtf(block.entryRate * block.entryRate + 2.0f * block.acceleration * block.stepEventCount);
+            float nextEntryRate = min(next.entryRate, maxExitRate * next.nominalRate / block.nominalRate);
+            next.entryRate = nextEntryRate;
+            block.exitRate = nextEntryRate * block.nominalRate / next.nominalRate;
+        }
+    }
+}
+
+void MotionPlanner::AdvanceTime(uint32_t elapsed){
+    if(!this->isRunning){
+        if(this->count == 0){
+            return;
+        }
+        // wait for anything that moved the motors directly to finish before we take over
+        for(uint8_t i = 0; i < MOTION_PLANNER_AXES; i++){
+            if(this->motors[i]->IsMoving()){
+                return;
+            }
+        }
+        this->startBlock();
+    }
+
+    // the clock keeps the fraction of a microsecond between steps. Stop counting once a step is due,
+    // and count how late it is instead
+    if(this->stepClock >= this->stepInterval){
+        this->stepLateness = elapsed > UINT32_MAX - this->stepLateness ? UINT32_MAX : this->stepLateness + elapsed;
+        return;
+    }
+    uint64_t stepClock = this->stepClock + (static_cast<uint64_t>(elapsed) << RAMP_FRACTION_BITS);
+    this->stepClock = stepClock > UINT32_MAX ? UINT32_MAX : static_cast<uint32_t>(stepClock);
+    if(this->stepClock >= this->stepInterval){
+        this->stepLateness = (this->stepClock - this->stepInterval) >> RAMP_FRACTION_BITS;
+    }
+}
+
+uint8_t MotionPlanner::Step(){
+    MotionBlock &block = this->blocks[this->head];
+    uint8_t steppedAxes = 0;
+    for(uint8_t i = 0; i < MOTION_PLANNER_AXES; i++){
+        this->axisError[i] += abs(block.steps[i]);
+        if(this->axisError[i] > 0){
+            this->axisError[i] -= block.stepEventCount;
+            this->motors[i]->CountStep();
+            steppedAxes |= 1 << i;
+        }
+    }
+    this->stepIndex++;
+    this->stepLateness = 0;
+
+    // keep the leftover time so we don't lose any rate, but don't try to catch up on more than one step
+    this->stepClock -= this->stepInterval;
+
+    if(this->stepIndex < block.stepEventCount){
+        this->updateRamp();
+    }
+    else{
+        // the move is done, so its pin changes go out with this step, and we go straight into the next one if it's there
+        this->dueEvent.Merge(block.endEvent);
+        this->head = this->blockIndex(1);
+        this->count--;
+        this->isRunning = false;
+        if(this->count > 0){
+            this->startBlock();
+        }
+    }
+
+    if(this->stepClock >= this->stepInterval){
+        this->stepClock = 0;
+    }
+    return steppedAxes;
+}
+
+bool MotionPlanner::AddSegment(const MotionSegment &segment){
+    if(this->IsFull()){
+        return false;
+    }
+    MotionBlock &block = this->blocks[this->blockIndex(this->count)];
+    block.segment = segment;
+    block.isCompiled = true;
+    for(uint8_t i = 0; i < MOTION_PLANNER_AXES; i++){
+        block.target[i] = segment.target[i];
+        block.steps[i] = segment.steps[i];
+        this->plannedPosition[i] = segment.target[i];
+        this->plannedSteps[i] = this->motors[i]->UnitsToSteps(segment.target[i]);
+    }
+    block.stepEventCount = segment.stepEventCount;
+    // a controlled move after this one starts from a stop, so these only need to be safe to divide by
+    block.nominalRate = 1;
+    block.maxEntryRate = 0;
+    block.entryRate = 0;
+    block.exitRate = 0;
+    block.endEvent = MotionEvent{0, 0};
+    this->count++;
+    return true;
+}
+
+bool MotionPlanner::NextSegment(MotionSegment &segment){
+    if(this->isRunning){
+        this->dueEvent.Merge(this->blocks[this->head].endEvent);
+        this->head = this->blockIndex(1);
+        this->count--;
+        this->isRunning = false;
+    }
+    if(this->count == 0){
+        return false;
+    }
+    this->startBlock();
+    segment = this->blocks[this->head].segment;
+    return true;
+}
+
+void MotionPlanner::planSegment(MotionBlock &block){
+    MotionSegment &segment = block.segment;
+    for(uint8_t i = 0; i < MOTION_PLANNER_AXES; i++){
+        segment.target[i] = block.target[i];
+        segment.steps[i] = block.steps[i];
+    }
+    segment.stepEventCount = block.stepEventCount;
+
+    segment.cruiseInterval = rateToInterval(block.nominalRate);
+    segment.exitInterval = 0;
+    if(block.exitRate > 0){
+        segment.exitInterval = rateToInterval(block.exitRate);
+    }
+
+    // it takes v^2 / 2a steps to get from a stop to a rate v, which is where in the ramp the entry rate is
+    float acceleration = block.acceleration;
+    if(block.entryRate > 0){
+        segment.initialInterval = rateToInterval(block.entryRate);
+        segment.initialRampStep = static_cast<int32_t>(block.entryRate * block.entryRate / (2.0f * acceleration));
+    }
+    else{
+        // the first step of a ramp from a stop. 0.676 corrects for the error in the first step of the approximation
+        segment.initialInterval = static_cast<uint32_t>(0.676f * sqrtf(2.0f / acceleration) * 1000000.0f * (1 << RAMP_FRACTION_BITS));
+        segment.initialRampStep = 0;
+    }
+    if(segment.initialInterval < segment.cruiseInterval){
+        segment.initialInterval = segment.cruiseInterval;
+    }
+
+    // work out where to start slowing down. If we can't reach the nominal rate, it's where the
+    // acceleration and deceleration meet
+    float nominalSquared = block.nominalRate * block.nominalRate;
+    float entrySquared = block.entryRate * block.entryRate;
+    float exitSquared = block.exitRate * block.exitRate;
+    float accelerateSteps = (nominalSquared - entrySquared) / (2.0f * acceleration);
+    float decelerateSteps = (nominalSquared - exitSquared) / (2.0f * acceleration);
+    if(accelerateSteps + decelerateSteps > block.stepEventCount){
+        accelerateSteps = (2.0f * acceleration * block.stepEventCount + exitSquared - entrySquared) / (4.0f * acceleration);
+        accelerateSteps = constrain(accelerateSteps, 0.0f, static_cast<float>(block.stepEventCount));
+        decelerateSteps = block.stepEventCount - accelerateSteps;
+    }
+    segment.decelerateAfter = block.stepEventCount - static_cast<uint32_t>(decelerateSteps);
+}
+
+void MotionPlanner::startBlock(){
+    MotionBlock &block = this->blocks[this->head];
+    if(!block.isCompiled){
+        this->planSegment(block);
+    }
+
+    const MotionSegment &segment = block.segment;
+    this->stepInterval = segment.initialInterval;
+    this->rampStep = segment.initialRampStep;
+    this->cruiseInterval = segment.cruiseInterval;
+    this->exitInterval = segment.exitInterval;
+    this->decelerateAfter = segment.decelerateAfter;
+
+    for(uint8_t i = 0; i < MOTION_PLANNER_AXES; i++){
+        this->axisError[i] = -static_cast<int32_t>(block.stepEventCount / 2);
+        // this sets the direction pin. The planner does the stepping
+        this->motors[i]->SetTargetPosition(block.target[i]);
+    }
+    this->stepIndex = 0;
+    this->isRunning = true;
+}
+
+void MotionPlanner::updateRamp(){
+    if(this->stepIndex >= this->decelerateAfter && this->rampStep > 0){
+        this->rampStep = -this->rampStep;
+    }
+
+    if(this->rampStep >= 0){
+        // we're at the nominal rate, so stay there without counting up the ramp
+        if(this->stepInterval <= this->cruiseInterval){
+            return;
+        }
+        this->rampStep++;
+        int32_t nextInterval = static_cast<int32_t>(this->stepInterval) - (2 * static_cast<int32_t>(this->stepInterval)) / (4 * this->rampStep + 1);
+        this->stepInterval = max(static_cast<uint32_t>(nextInterval), this->cruiseInterval);
+        return;
+    }
+
+    // we're slowing down. Don't go below the exit rate, or past the bottom of the ramp
+    if(this->rampStep == -1 || (this->exitInterval != 0 && this->stepInterval >= this->exitInterval)){
+        return;
+    }
+    int32_t nextInterval = static_cast<int32_t>(this->stepInterval) - (2 * static_cast<int32_t>(this->stepInterval)) / (4 * this->rampStep + 1);
+    this->stepInterval = static_cast<uint32_t>(nextInterval);
+    if(this->exitInterval != 0 && this->stepInterval > this->exitInterval){
+        this->stepInterval = this->exitInterval;
+    }
+    this->rampStep++;
+}
+
+void MotionPlanner::Clear(){
+    // the pin changes would have happened as the moves finished, so they happen now in the same order
+    for(uint8_t offset = 0; offset < this->count; offset++){
+        this->dueEvent.Merge(this->blocks[this->blockIndex(offset)].endEvent);
+    }
+    this->head = 0;
+    this->count = 0;
+    this->isRunning = false;
+}
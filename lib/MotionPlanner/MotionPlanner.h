@@ -0,0 +1,265 @@
+/**
+ * @file MotionPlanner.h
+ * @brief This file contains the MotionPlanner class
+ * @details This file contains the MotionPlanner class which buffers controlled moves and plans the entry and exit
+ * speed of each one across the whole buffer, so consecutive moves blend together instead of stopping at every boundary.
+ * The planner also steps its moves. The axis with the most steps sets the pace from one master tick, and the other axes
+ * follow it with Bresenham's line algorithm, so every axis finishes a move on the same tick.
+ * Output pin changes can be tied to the end of a planned move, so they happen on the move's last step instead of
+ * when the command is read, without the moves having to stop for them.
+ * Moves are added from the main loop and executed by the step scheduler, so both sides must hold the scheduler's lock.
+ * @version 1.0.0
+ * @author Quinn Henthorne. Contact: quinn.henthorne@gmail.com
+*/
+
+#ifndef MOTION_PLANNER_H
+#define MOTION_PLANNER_H
+
+#include <Arduino.h>
+#include "StepperMotor.h"
+#include "MACHINE-AXES.h"
+
+// The number of moves that can be planned ahead
+#define MOTION_PLANNER_BUFFER_SIZE 16
+// The number of axes in a move, in the order the machine's axes are listed in MACHINE_AXES
+#define MOTION_PLANNER_AXES MACHINE_AXIS_COUNT
+// a mask with a bit set for every axis
+#define MOTION_PLANNER_ALL_AXES ((1 << MOTION_PLANNER_AXES) - 1)
+
+// a move with everything worked out that stepping it needs, so it can be run with integer math only.
+// Intervals are in 1/256 us
+struct MotionSegment{
+    int32_t target[MOTION_PLANNER_AXES]; // the position at the end of the move in units
+    int32_t steps[MOTION_PLANNER_AXES]; // the number of steps each axis takes. Negative if it goes backwards
+    uint32_t stepEventCount; // the number of steps the leading axis takes
+    uint32_t initialInterval; // the interval before the first master step
+    int32_t initialRampStep; // where in the acceleration ramp the move starts
+    uint32_t cruiseInterval; // the master step interval at the nominal rate
+    uint32_t exitInterval; // the master step interval at the exit rate. 0 to slow down to a stop
+    uint32_t decelerateAfter; // the master step to start slowing down at
+};
+
+// a change to the output pins on the motors' port, made on the last step of a move
+struct MotionEvent{
+    uint8_t setMask; // the pins that go high
+    uint8_t clearMask; // the pins that go low
+
+    /**
+     * @brief Add a change that comes after this one, so both can be made at once
+     * @param next The later change. It wins for any pin both change
+    */
+    void Merge(const MotionEvent &next){
+        this->setMask = (this->setMask & ~next.clearMask) | next.setMask;
+        this->clearMask = (this->clearMask & ~next.setMask) | next.clearMask;
+    }
+
+    /**
+     * @brief Returns true if no pin changes
+    */
+    bool IsEmpty() const { return setMask == 0 && clearMask == 0; }
+};
+
+// a single planned move. Rates are in steps per second of the axis that takes the most steps
+struct MotionBlock{
+    int32_t target[MOTION_PLANNER_AXES]; // the position at the end of the move in units
+    int32_t steps[MOTION_PLANNER_AXES]; // the number of steps each axis takes. Negative if it goes backwards
+    uint32_t stepEventCount; // the number of steps the leading axis takes
+    float nominalRate; // the cruise rate of the move
+    float acceleration; // the acceleration of the leading axis in steps per second^2
+    float maxEntryRate; // the fastest we can go through the junction into this move
+    float entryRate; // the planned rate at the start of the move
+    float exitRate; // the planned rate at the end of the move
+    bool isCompiled; // true if the segment was worked out ahead of time and the rates above aren't used
+    MotionEvent endEvent; // the pins to change on the last step of the move
+    MotionSegment segment; // how the move is stepped. This is worked out when the move starts unless it is compiled
+};
+
+class MotionPlanner{
+    public:
+        /**
+         * @brief Construct a new Motion Planner object
+         * @param motors The motor for each axis
+         * @param maxJerk The biggest instant speed change each axis can take at a junction in units per minute
+        */
+        MotionPlanner(StepperMotor *const motors[MOTION_PLANNER_AXES], const float maxJerk[MOTION_PLANNER_AXES]);
+
+        /**
+         * @brief Plan a controlled move to the given position
+         * @param target The position to move to in units for each axis
+         * @param feedRate The speed of the first axis that moves in units per minute. 0 to go at the last feed rate given
+         * @param isRelative True if the target is relative to the end of the last planned move
+         * @param axisMask A bit for every axis the target is given for. The others stay where they are
+         * @return true if the move was added. False if the buffer is full, or if no feed rate has been given yet
+         * @note Every planned move that hasn't started yet is replanned to include the new move.
+         * If nothing is planned, planning starts from wherever the motors are headed
+        */
+        bool AddMove(const int32_t target[MOTION_PLANNER_AXES], float feedRate, bool isRelative = false, uint8_t axisMask = MOTION_PLANNER_ALL_AXES);
+
+        /**
+         * @brief Add a move that has already been planned, like one from a compiled recipe
+         * @param segment The planned move
+         * @return true if the move was added. False if the buffer is full
+         * @note Compiled moves are never replanned. A controlled move added after one starts from a stop
+        */
+        bool AddSegment(const MotionSegment &segment);
+
+        /**
+         * @brief Change output pins on the last step of the last planned move
+         * @param pinMask The pins to change, on the port the motors step on
+         * @param value The level to set them to
+         * @return true if the change was tied to a move. False if nothing is planned, so it should be made now
+         * @note The move can still be blended into the ones after it, so nothing stops for the change.
+         * If the moves are thrown away, the changes tied to them are made straight away instead, so the pins end up
+         * where the commands left them
+        */
+        bool AddEvent(uint8_t pinMask, bool value);
+
+        /**
+         * @brief Take the pin changes that are due
+         * @return Every change that is due, merged in order. Empty if there aren't any
+         * @note The step waveform calls this after every step, and makes the changes in the same port image
+        */
+        MotionEvent TakeEvent(){
+            MotionEvent event = this->dueEvent;
+            this->dueEvent = MotionEvent{0, 0};
+            return event;
+        }
+
+        /**
+         * @brief Finish the running move and start the next one without stepping either
+         * @param segment Where to put how the next move is stepped
+         * @return true if there was another move. False if the buffer is empty
+         * @note This is how the recipe compiler turns planned moves into segments. It must not be used
+         * while the step scheduler is running
+        */
+        bool NextSegment(MotionSegment &segment);
+
+        /**
+         * @brief Advance the master step clock, and start the next move if nothing is running
+         * @param elapsed The time that has passed in microseconds
+         * @note This is called by the step waveform every slot, so it has to be quick
+        */
+        void AdvanceTime(uint32_t elapsed);
+
+        /**
+         * @brief Returns true if a move is running and it's time for its next step
+         * @return true if Step() should be called
+        */
+        bool IsStepDue(){ return isRunning && stepClock >= stepInterval; }
+
+        /**
+         * @brief Get how long the master step that is due has been waiting
+         * @return The time past when the step was due in microseconds
+         * @note Call this before Step(), which clears it
+        */
+        uint32_t GetStepLateness(){ return stepLateness; }
+
+        /**
+         * @brief Take one master step of the running move
+         * @return A mask of the axes that step. Bit n is set if axis n steps
+         * @note This only uses integer math. The motors' positions are updated, but their step pins are left to the caller
+        */
+        uint8_t Step();
+
+        /**
+         * @brief Returns true if a planned move is being stepped
+         * @return true if the planner is driving the motors
+        */
+        bool IsRunning(){ return isRunning; }
+
+        /**
+         * @brief Get the motor for an axis
+         * @param axis The axis to get
+         * @return A pointer to the motor
+        */
+        StepperMotor * GetMotor(uint8_t axis){ return motors[axis]; }
+
+        /**
+         * @brief Throw away every planned move
+         * @note This doesn't stop the motors. Anything that moves the motors without the planner must call this first.
+         * The pin changes tied to the moves are made due, so they still happen
+        */
+        void Clear();
+
+        /**
+         * @brief Get the position at the end of the last planned move
+         * @param axis The axis to get
+         * @return The position in units
+        */
+        int32_t GetPlannedPosition(uint8_t axis){ return plannedPosition[axis]; }
+
+        /**
+         * @brief Returns true if there are no moves planned or running
+         * @return true if the planner is empty
+        */
+        bool IsEmpty(){ return count == 0; }
+
+        /**
+         * @brief Returns true if no more moves can be added
+         * @return true if the planner is full
+        */
+        bool IsFull(){ return count == MOTION_PLANNER_BUFFER_SIZE; }
+
+    private:
+        StepperMotor *motors[MOTION_PLANNER_AXES];
+        float maxJerk[MOTION_PLANNER_AXES]; // in steps per second
+        MotionBlock blocks[MOTION_PLANNER_BUFFER_SIZE];
+        uint8_t head{0}; // the index of the oldest move
+        uint8_t count{0}; // the number of moves in the buffer, including the one running
+        bool isRunning{false}; // true if the move at the head has been given to the motors
+        int32_t plannedPosition[MOTION_PLANNER_AXES]; // the position at the end of the last planned move
+        int32_t plannedSteps[MOTION_PLANNER_AXES]; // the same position in steps. A stopped motor can be between whole units
+        float feedRate{0}; // the last feed rate given in units per minute. Moves without one go at this
+        MotionEvent dueEvent{0, 0}; // the pin changes of the moves that have finished, waiting to be made
+
+        // the state of the running move. Intervals are in 1/256 us
+        uint32_t stepIndex{0}; // the number of master steps taken
+        uint32_t decelerateAfter{0}; // the master step to start slowing down at
+        uint32_t stepInterval{0}; // the time until the next master step
+        uint32_t cruiseInterval{0}; // the master step interval at the nominal rate
+        uint32_t exitInterval{0}; // the master step interval at the exit rate. 0 to slow down to a stop
+        int32_t rampStep{0}; // the step number in the ramp. Positive while accelerating, negative while decelerating
+        int32_t axisError[MOTION_PLANNER_AXES]; // the Bresenham error of each axis
+        uint32_t stepClock{0}; // the time since the last master step. The fraction carries over between steps
+        uint32_t stepLateness{0}; // the time the due master step has been waiting in microseconds
+
+        /**
+         * @brief Get the index of a block in the ring
+         * @param offset The number of blocks after the head
+         * @return The index of the block in the blocks array
+        */
+        uint8_t blockIndex(uint8_t offset){ return (head + offset) % MOTION_PLANNER_BUFFER_SIZE; }
+
+        /**
+         * @brief Work out how fast we can go through the junction between two moves
+         * @param previous The move before the junction
+         * @param next The move after the junction
+         * @return The maximum entry rate of the next move
+        */
+        float junctionRate(const MotionBlock &previous, const MotionBlock &next);
+
+        /**
+         * @brief Plan the entry and exit rates of every move that hasn't started yet
+        */
+        void recalculate();
+
+        /**
+         * @brief Work out how a planned move is stepped
+         * @param block The move
+         * @note This is the only place a move uses floats. Everything per step is integer
+        */
+        void planSegment(MotionBlock &block);
+
+        /**
+         * @brief Set up the running state for the move at the head of the buffer
+        */
+        void startBlock();
+
+        /**
+         * @brief Work out the interval until the next master step
+         * @note This uses the same integer ramp as StepperMotor: c(n) = c(n-1) - 2c(n-1) / (4n + 1)
+        */
+        void updateRamp();
+};
+
+#endif // MOTION_PLANNER_H
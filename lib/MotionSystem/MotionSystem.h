@@ -0,0 +1,282 @@
+/**
+ * @file MotionSystem.h
+ * @brief This file contains the MotionSystem class template, which owns every motor of the machine and their planner
+ * @details The axes are picked when the firmware is built, as MotionSystem<MotionAxis<...>, MotionAxis<...>, ...>.
+ * Each axis is given by its GCode letter, its constexpr motor configuration and its max jerk. The system makes a motor
+ * for each one, plans moves across all of them, and puts every motor on the same step waveform, so one scheduler steps them all.
+ * The configurations are checked and their fixed point step constants worked out when the firmware is built,
+ * so the motors never do float math while they step.
+ * Everything the main loop does to the motors goes through here and holds the scheduler's lock while it does.
+ * The step path is the same StepWaveform and MotionPlanner as before, working through arrays of motors,
+ * so there are no virtual calls or per-axis branches added to it.
+ * @version 1.0.0
+ * @author Quinn Henthorne. Contact: quinn.henthorne@gmail.com
+*/
+
+#ifndef MOTION_SYSTEM_H
+#define MOTION_SYSTEM_H
+
+#include <Arduino.h>
+#include <utility>
+#include "GCODE-DEFINITIONS.h"
+#include "StepperMotor.h"
+#include "MotionPlanner.h"
+#include "StepWaveform.h"
+#include "StepScheduler.h"
+
+/**
+ * @brief One axis of a motion system
+ * @tparam Letter The GCode letter of the axis. It has to be listed in GCODE_AXES
+ * @tparam Configuration The configuration of the axis's motor. It has to be constexpr
+ * @tparam MaxJerk The biggest instant speed change the axis can take at a junction in units per minute
+*/
+template<char Letter, const StepperMotorConfiguration &Configuration, uint32_t MaxJerk>
+struct MotionAxis{
+    static constexpr char letter = Letter;
+    static constexpr uint8_t gcodeAxis = GCodeDefinitions::AxisIndex(Letter); // where the axis is in a GCode
+    static_assert(gcodeAxis < GCodeDefinitions::AXIS_COUNT, "The axis letter has to be listed in GCODE_AXES");
+    static constexpr float maxJerk = MaxJerk;
+
+    // the motor keeps the rest of its step constants in its configuration. This one is for checking the axes against each other
+    static constexpr uint8_t stepMask = Configuration.stepMask;
+    static_assert(Configuration.stepsPerUnit >= 1.0f, "The motor needs at least one step per unit, or a position in steps could overflow");
+    static_assert(Configuration.maxSpeed > 0 && Configuration.minStepInterval > 0, "The motor needs a max speed");
+    static_assert(Configuration.stepPin.number < 8 && Configuration.directionPin.number < 8 && Configuration.enablePin.number < 8, "The motor's pins have to be on a PCF8574 port");
+    static_assert((Configuration.stepMask & (Configuration.directionMask | Configuration.enableMask)) == 0, "The step pin can't be shared with the motor's other pins");
+
+    static const StepperMotorConfiguration & GetConfiguration(){ return Configuration; }
+};
+
+template<typename... Axes>
+class MotionSystem{
+    public:
+        static constexpr uint8_t AXES = sizeof...(Axes);
+        static_assert(AXES == MOTION_PLANNER_AXES, "The motion system has to have the axes in MACHINE_AXES");
+
+        // the letter of each axis, in the order they are listed
+        static constexpr char letters[AXES] = {Axes::letter...};
+
+        // every axis is stepped in the same port image, so no two can share a step pin.
+        // Each mask is one bit, so they only add up to the same as they combine to if none of them overlap
+        static_assert((0 + ... + Axes::stepMask) == (0 | ... | Axes::stepMask), "Every axis needs its own step pin");
+
+        /**
+         * @brief Construct a new Motion System object
+         * @param scheduler The step scheduler whose lock is held while the motors are changed
+        */
+        MotionSystem(StepScheduler *scheduler) :
+            MotionSystem(scheduler, std::index_sequence_for<Axes...>{}){}
+
+        /**
+         * @brief Start every motor and put them all on a waveform
+         * @param waveform The waveform that steps the motors. Every axis's step pin has to be on its port
+         * @note This must be called before the waveform is initialized
+        */
+        void Begin(StepWaveform *waveform){
+            for(uint8_t i = 0; i < AXES; i++){
+                this->motors[i].Init();
+                this->motors[i].SetEnabled(true);
+                waveform->AddMotor(&this->motors[i]);
+            }
+            waveform->SetPlanner(&this->planner);
+        }
+
+        /**
+         * @brief Find an axis by its letter
+         * @param letter The GCode letter of the axis
+         * @return The axis, or AXES if the system doesn't have one with that letter
+        */
+        static constexpr uint8_t IndexOf(char letter){
+            for(uint8_t i = 0; i < AXES; i++){
+                if(letters[i] == letter){
+                    return i;
+                }
+            }
+            return AXES;
+        }
+
+        /**
+         * @brief Get the motor of an axis
+         * @param axis The axis, in the order they are listed
+        */
+        StepperMotor & GetMotor(uint8_t axis){ return motors[axis]; }
+
+        /**
+         * @brief Get the planner for controlled moves
+        */
+        MotionPlanner & GetPlanner(){ return planner; }
+
+        /**
+         * @brief Plan a controlled move to the axes given in a command
+         * @param gcode The command. Axes it doesn't give stay where they are
+         * @param isRelative True if the positions are relative to the end of the last planned move
+         * @return true if the move was planned. False if the planner is full
+        */
+        bool PlanMove(const GCodeDefinitions::GCode &gcode, bool isRelative){
+            int32_t target[AXES] = {gcode.axes[Axes::gcodeAxis]...};
+            uint8_t axisMask = this->getAxisMask(gcode);
+            this->scheduler->Lock();
+            bool isPlanned = this->planner.AddMove(target, gcode.F, isRelative, axisMask);
+            this->scheduler->Unlock();
+            return isPlanned;
+        }
+
+        /**
+         * @brief Move the axes straight to their targets, each at its own speed, without planning
+         * @param target The target of each axis in units
+         * @param speed The speed of each axis in units per minute
+         * @param isRelative True if the targets are relative to where the motors are
+         * @param axisMask A bit for every axis to move. The others keep going where they were going
+         * @note Anything planned is thrown away
+        */
+        void MoveTo(const int32_t target[AXES], const uint32_t speed[AXES], bool isRelative = false, uint8_t axisMask = MOTION_PLANNER_ALL_AXES){
+            this->scheduler->Lock();
+            this->planner.Clear();
+            for(uint8_t i = 0; i < AXES; i++){
+                if(axisMask & (1 << i)){
+                    this->motors[i].SetTargetPosition(isRelative ? this->motors[i].GetCurrentPosition() + target[i] : target[i]);
+                    this->motors[i].SetSpeed(speed[i]);
+                }
+            }
+            this->scheduler->Unlock();
+        }
+
+        /**
+         * @brief Move the axes given in a command straight to their targets, without planning
+         * @param gcode The command. The first axis moves at F and every other axis at P
+         * @param isRelative True if the positions are relative to where the motors are
+        */
+        void Move(const GCodeDefinitions::GCode &gcode, bool isRelative){
+            int32_t target[AXES] = {gcode.axes[Axes::gcodeAxis]...};
+            uint32_t speed[AXES];
+            for(uint8_t i = 0; i < AXES; i++){
+                speed[i] = i == 0 ? gcode.F : gcode.P;
+            }
+            this->MoveTo(target, speed, isRelative, this->getAxisMask(gcode));
+        }
+
+        /**
+         * @brief Stop every motor on the step it's on
+         * @note Anything planned is thrown away
+        */
+        void Stop(){
+            this->scheduler->Lock();
+            this->planner.Clear();
+            for(uint8_t i = 0; i < AXES; i++){
+                // a planned move's motors don't step on their own, so a target rounded to a unit would never be reached
+                this->motors[i].Stop();
+            }
+            this->scheduler->Unlock();
+        }
+
+        /**
+         * @brief Returns true if any axis hasn't reached its target
+         * @param axisMask A bit for every axis to check
+        */
+        bool IsMoving(uint8_t axisMask = MOTION_PLANNER_ALL_AXES){
+            bool isMoving = false;
+            this->scheduler->Lock();
+            for(uint8_t i = 0; i < AXES; i++){
+                if(axisMask & (1 << i)){
+                    isMoving |= this->motors[i].IsMoving();
+                }
+            }
+            this->scheduler->Unlock();
+            return isMoving;
+        }
+
+        /**
+         * @brief Tell an axis where it is and stop it there
+         * @param axis The axis, in the order they are listed
+         * @param position The position in units
+         * @note Anything planned is thrown away
+        */
+        void SetPosition(uint8_t axis, int32_t position){
+            this->scheduler->Lock();
+            this->planner.Clear();
+            this->motors[axis].SetTargetPosition(position);
+            this->motors[axis].SetCurrentPosition(position);
+            this->scheduler->Unlock();
+        }
+
+        /**
+         * @brief Tell every axis where it is and stop it there
+         * @param position The position in units
+         * @note Anything planned is thrown away
+        */
+        void SetAllPositions(int32_t position){
+            this->scheduler->Lock();
+            this->planner.Clear();
+            for(uint8_t i = 0; i < AXES; i++){
+                this->motors[i].SetTargetPosition(position);
+                this->motors[i].SetCurrentPosition(position);
+            }
+            this->scheduler->Unlock();
+        }
+
+        /**
+         * @brief Enable or disable every motor
+         * @param enabled True to enable them
+         * @note Anything planned is thrown away
+        */
+        void SetEnabled(bool enabled){
+            this->scheduler->Lock();
+            this->planner.Clear();
+            for(uint8_t i = 0; i < AXES; i++){
+                this->motors[i].SetEnabled(enabled);
+            }
+            this->scheduler->Unlock();
+        }
+
+        /**
+         * @brief Set how far the axes given in a command can go
+         * @param gcode The command. Axes it doesn't give keep their max travel
+        */
+        void SetMaxTravel(const GCodeDefinitions::GCode &gcode){
+            int32_t maxTravel[AXES] = {gcode.axes[Axes::gcodeAxis]...};
+            uint8_t axisMask = this->getAxisMask(gcode);
+            this->scheduler->Lock();
+            for(uint8_t i = 0; i < AXES; i++){
+                if(axisMask & (1 << i)){
+                    this->motors[i].SetMaxTravel(maxTravel[i]);
+                }
+            }
+            this->scheduler->Unlock();
+        }
+
+    private:
+        StepScheduler *scheduler;
+        StepperMotor motors[AXES];
+        StepperMotor *motorPointers[AXES]; // the planner takes the motors by pointer
+        MotionPlanner planner;
+
+        static constexpr float maxJerk[AXES] = {Axes::maxJerk...};
+
+        template<size_t... Indexes>
+        MotionSystem(StepScheduler *scheduler, std::index_sequence<Indexes...>) :
+            scheduler(scheduler),
+            motors{StepperMotor(Axes::GetConfiguration())...},
+            motorPointers{&motors[Indexes]...},
+            planner(motorPointers, maxJerk){}
+
+        /**
+         * @brief Get which of the system's axes a command gives
+         * @param gcode The command
+         * @return A bit for every axis, in the order they are listed
+        */
+        static uint8_t getAxisMask(const GCodeDefinitions::GCode &gcode){
+            uint8_t axisMask = 0;
+            uint8_t axis = 0;
+            ((axisMask |= gcode.HasAxis(Axes::gcodeAxis) ? 1 << axis : 0, axis++), ...);
+            return axisMask;
+        }
+};
+
+/**
+ * @brief A MotionSystem of every type after the first, so an X macro can put a comma before each axis
+ * @note MACHINE_MOTION_SYSTEM uses this to make the machine's motion system from MACHINE_AXES
+*/
+template<typename Ignored, typename... Axes>
+using MotionSystemOf = MotionSystem<Axes...>;
+
+#endif // MOTION_SYSTEM_H
@@ -0,0 +1,71 @@
+/**
+ * @file Arduino.h
+ * @brief This file stands in for the Arduino core when the firmware is built for the native environment
+ * @details Only the parts of the core the firmware uses are here. Time comes from the VirtualClock, so it can run
+ * with the PC's clock or be moved by hand, and the serial ports are HardwareSerial mocks that keep what is sent to them.
+ * This library is ignored by the ESP32 environments.
+ * @version 1.0.0
+ * @author Quinn Henthorne. Contact: quinn.henthorne@gmail.com
+*/
+
+#ifndef NATIVE_ARDUINO_H
+#define NATIVE_ARDUINO_H
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+
+#define HIGH 0x1
+#define LOW 0x0
+
+#define DEC 10
+#define HEX 16
+#define OCT 8
+#define BIN 2
+
+#define IRAM_ATTR
+
+using std::min;
+using std::max;
+using std::abs;
+
+#define constrain(amount, low, high) ((amount) < (low) ? (low) : ((amount) > (high) ? (high) : (amount)))
+
+/**
+ * @brief Get the time since the program started
+ * @return The time in milliseconds. Like the ESP32 it is 32 bits and wraps around
+*/
+unsigned long millis();
+
+/**
+ * @brief Get the time since the program started
+ * @return The time in microseconds. Like the ESP32 it is 32 bits and wraps around after about 71 minutes
+*/
+unsigned long micros();
+
+/**
+ * @brief Wait for a time, running any timers that go off while we wait
+ * @param ms The time to wait in milliseconds
+*/
+void delay(unsigned long ms);
+
+/**
+ * @brief Wait for a time, running any timers that go off while we wait
+ * @param us The time to wait in microseconds
+*/
+void delayMicroseconds(unsigned int us);
+
+/**
+ * @brief Run any timers that are due
+*/
+void yield();
+
+#include "Print.h"
+#include "Stream.h"
+#include "HardwareSerial.h"
+#include "Esp.h"
+#include "VirtualClock.h"
+
+#endif // NATIVE_ARDUINO_H
@@ -0,0 +1,46 @@
+/**
+ * @file ArduinoMain.cpp
+ * @brief This file contains the entry point of the native build
+ * @details Like the Arduino core it runs setup() once and then loop() forever. The timers are run between loops,
+ * and Serial is connected to the terminal, so the firmware can be driven by hand or by piping a recipe in,
+ * and profiled with perf or valgrind. Unit tests and the simulator have their own entry points, so this one is left out of them.
+ * @version 1.0.0
+ * @author Quinn Henthorne. Contact: quinn.henthorne@gmail.com
+*/
+
+#if !defined(PIO_UNIT_TESTING) && !defined(SIMULATOR)
+
+#include "Arduino.h"
+#include <fcntl.h>
+#include <unistd.h>
+
+void setup();
+void loop();
+
+/**
+ * @brief Pass what was typed to Serial, and what Serial sent to the terminal
+*/
+static void bridgeSerial(){
+    uint8_t buffer[256];
+    ssize_t length = ::read(STDIN_FILENO, buffer, sizeof(buffer));
+    if(length > 0){
+        Serial.Receive(buffer, length);
+    }
+    std::string transmitted = Serial.TakeTransmitted();
+    if(!transmitted.empty()){
+        fwrite(transmitted.data(), 1, transmitted.size(), stdout);
+        fflush(stdout);
+    }
+}
+
+int main(){
+    fcntl(STDIN_FILENO, F_SETFL, fcntl(STDIN_FILENO, F_GETFL) | O_NONBLOCK);
+    setup();
+    while(true){
+        bridgeSerial();
+        loop();
+        VirtualClock::RunTimers();
+    }
+}
+
+#endif // !PIO_UNIT_TESTING && !SIMULATOR
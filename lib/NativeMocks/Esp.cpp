@@ -0,0 +1,21 @@
+/**
+ * @file Esp.cpp
+ * @brief This file contains the native EspClass implimentation
+ * @version 1.0.0
+ * @author Quinn Henthorne. Contact: quinn.henthorne@gmail.com
+*/
+
+#include "Esp.h"
+#include <time.h>
+
+EspClass ESP;
+
+uint32_t EspClass::getCycleCount(){
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return static_cast<uint32_t>(static_cast<uint64_t>(now.tv_sec) * 1000000000 + now.tv_nsec);
+}
+
+uint32_t getCpuFrequencyMhz(){
+    return 1000;
+}
@@ -0,0 +1,32 @@
+/**
+ * @file Esp.h
+ * @brief This file contains the native EspClass
+ * @details There is no cycle counter to read on the PC, so the native one counts the PC's nanoseconds,
+ * and the CPU frequency is reported as 1000MHz to match. Code timed with it measures how long it really takes to run.
+ * @version 1.0.0
+ * @author Quinn Henthorne. Contact: quinn.henthorne@gmail.com
+*/
+
+#ifndef NATIVE_ESP_H
+#define NATIVE_ESP_H
+
+#include <stdint.h>
+
+class EspClass{
+    public:
+        /**
+         * @brief Get the cycle counter
+         * @return The PC's clock in nanoseconds, wrapped to 32 bits
+        */
+        static uint32_t getCycleCount();
+};
+
+extern EspClass ESP;
+
+/**
+ * @brief Get the CPU frequency
+ * @return 1000, so the native cycle counter turns into microseconds like the real one does
+*/
+uint32_t getCpuFrequencyMhz();
+
+#endif // NATIVE_ESP_H
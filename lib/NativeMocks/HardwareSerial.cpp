@@ -0,0 +1,76 @@
+/**
+ * @file HardwareSerial.cpp
+ * @brief This file contains the native HardwareSerial class implimentation
+ * @version 1.0.0
+ * @author Quinn Henthorne. Contact: quinn.henthorne@gmail.com
+*/
+
+#include "HardwareSerial.h"
+#include <string.h>
+
+HardwareSerial Serial(0);
+HardwareSerial Serial1(1);
+HardwareSerial Serial2(2);
+
+void HardwareSerial::begin(unsigned long baud, uint32_t config, int8_t rxPin, int8_t txPin){
+    this->baudRate = baud;
+    this->isBegun = true;
+}
+
+void HardwareSerial::end(){
+    this->isBegun = false;
+}
+
+int HardwareSerial::available(){
+    return this->received.size();
+}
+
+int HardwareSerial::read(){
+    if(this->received.empty()){
+        return -1;
+    }
+    uint8_t byte = this->received.front();
+    this->received.pop_front();
+    return byte;
+}
+
+int HardwareSerial::peek(){
+    if(this->received.empty()){
+        return -1;
+    }
+    return this->received.front();
+}
+
+size_t HardwareSerial::write(uint8_t byte){
+    return this->write(&byte, 1);
+}
+
+size_t HardwareSerial::write(const uint8_t *buffer, size_t size){
+    this->transmitted.append(reinterpret_cast<const char *>(buffer), size);
+    if(this->transmitted.size() > NATIVE_SERIAL_BUFFER_LENGTH){
+        this->transmitted.erase(0, this->transmitted.size() - NATIVE_SERIAL_BUFFER_LENGTH);
+    }
+    return size;
+}
+
+int HardwareSerial::availableForWrite(){
+    // nothing is ever waiting to go out, so there is always a whole FIFO free
+    return 128;
+}
+
+void HardwareSerial::Receive(const uint8_t *data, size_t length){
+    this->received.insert(this->received.end(), data, data + length);
+    while(this->received.size() > NATIVE_SERIAL_BUFFER_LENGTH){
+        this->received.pop_front();
+    }
+}
+
+void HardwareSerial::Receive(const char *text){
+    this->Receive(reinterpret_cast<const uint8_t *>(text), strlen(text));
+}
+
+std::string HardwareSerial::TakeTransmitted(){
+    std::string data;
+    data.swap(this->transmitted);
+    return data;
+}
@@ -0,0 +1,80 @@
+/**
+ * @file HardwareSerial.h
+ * @brief This file contains the native HardwareSerial class
+ * @details The mock port keeps what the firmware sends until it is taken with TakeTransmitted(), and the firmware
+ * reads whatever was given to Receive(), so a test or a host program can stand on the other end of the cable.
+ * @version 1.0.0
+ * @author Quinn Henthorne. Contact: quinn.henthorne@gmail.com
+*/
+
+#ifndef NATIVE_HARDWARE_SERIAL_H
+#define NATIVE_HARDWARE_SERIAL_H
+
+#include <stdint.h>
+#include <deque>
+#include <string>
+#include "Stream.h"
+
+#define SERIAL_8N1 0x800001c
+
+// the most bytes kept for either direction. The oldest are dropped past this, so nothing grows without end
+#define NATIVE_SERIAL_BUFFER_LENGTH 65536
+
+class HardwareSerial : public Stream{
+    public:
+        /**
+         * @brief Construct a new Hardware Serial object
+         * @param uartNumber The UART the port stands in for
+        */
+        HardwareSerial(uint8_t uartNumber) : uartNumber(uartNumber){}
+
+        void begin(unsigned long baud, uint32_t config = SERIAL_8N1, int8_t rxPin = -1, int8_t txPin = -1);
+        void end();
+        operator bool() const { return isBegun; }
+
+        int available() override;
+        int read() override;
+        int peek() override;
+        size_t write(uint8_t byte) override;
+        size_t write(const uint8_t *buffer, size_t size) override;
+        int availableForWrite() override;
+        using Print::write;
+
+        /**
+         * @brief Give the firmware bytes to read, as if they came over the cable
+         * @param data The bytes
+         * @param length The number of bytes
+        */
+        void Receive(const uint8_t *data, size_t length);
+
+        /**
+         * @brief Give the firmware a string to read, as if it came over the cable
+         * @param text The string
+        */
+        void Receive(const char *text);
+
+        /**
+         * @brief Take everything the firmware has sent since the last call
+         * @return The bytes that were sent
+        */
+        std::string TakeTransmitted();
+
+        /**
+         * @brief Get the baud rate the port was started at
+         * @return The baud rate, or 0 if it hasn't been started
+        */
+        unsigned long GetBaudRate(){ return isBegun ? baudRate : 0; }
+
+    private:
+        const uint8_t uartNumber;
+        bool isBegun{false};
+        unsigned long baudRate{0};
+        std::deque<uint8_t> received; // sent to the firmware, waiting to be read
+        std::string transmitted; // sent by the firmware, waiting to be taken
+};
+
+extern HardwareSerial Serial;
+extern HardwareSerial Serial1;
+extern HardwareSerial Serial2;
+
+#endif // NATIVE_HARDWARE_SERIAL_H
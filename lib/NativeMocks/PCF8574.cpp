@@ -0,0 +1,102 @@
+/**
+ * @file PCF8574.cpp
+ * @brief This file contains the native PCF8574 and PCF8574Device class implimentations
+ * @version 1.0.0
+ * @author Quinn Henthorne. Contact: quinn.henthorne@gmail.com
+*/
+
+#include "PCF8574.h"
+
+void PCF8574Device::Receive(const uint8_t *data, size_t length){
+    for(size_t i = 0; i < length; i++){
+        uint8_t previous = this->outputs;
+        this->outputs = data[i];
+        this->writeCount++;
+        if(this->listener != NULL){
+            this->listener(this->outputs, previous, this->context);
+        }
+    }
+}
+
+uint8_t PCF8574Device::Transmit(){
+    // the pins are quasi-bidirectional, so a pin written low reads low whatever is on it
+    return this->outputs & this->inputs;
+}
+
+void PCF8574Device::SetInput(uint8_t pin, bool value){
+    uint8_t mask = 1 << pin;
+    if(value){
+        this->inputs |= mask;
+    }
+    else{
+        this->inputs &= ~mask;
+    }
+}
+
+void PCF8574Device::SetListener(void (*listener)(uint8_t value, uint8_t previous, void *context), void *context){
+    this->listener = listener;
+    this->context = context;
+}
+
+PCF8574::PCF8574(uint8_t address, TwoWire *wire) :
+    address(address),
+    wire(wire){
+    wire->Attach(address, &this->device);
+}
+
+bool PCF8574::begin(uint8_t value){
+    if(!this->isConnected()){
+        return false;
+    }
+    this->write8(value);
+    return this->error == PCF8574_OK;
+}
+
+bool PCF8574::isConnected(){
+    this->wire->beginTransmission(this->address);
+    return this->wire->endTransmission() == 0;
+}
+
+uint8_t PCF8574::read8(){
+    if(this->wire->requestFrom(this->address, 1) != 1){
+        this->error = PCF8574_I2C_ERROR;
+        return 0;
+    }
+    this->error = PCF8574_OK;
+    return this->wire->read();
+}
+
+uint8_t PCF8574::read(uint8_t pin){
+    if(pin > 7){
+        this->error = PCF8574_PIN_ERROR;
+        return 0;
+    }
+    return (this->read8() >> pin) & 1;
+}
+
+void PCF8574::write8(uint8_t value){
+    this->dataOut = value;
+    this->wire->beginTransmission(this->address);
+    this->wire->write(value);
+    this->error = this->wire->endTransmission() == 0 ? PCF8574_OK : PCF8574_I2C_ERROR;
+}
+
+void PCF8574::write(uint8_t pin, uint8_t value){
+    if(pin > 7){
+        this->error = PCF8574_PIN_ERROR;
+        return;
+    }
+    if(value == 0){
+        this->dataOut &= ~(1 << pin);
+    }
+    else{
+        this->dataOut |= (1 << pin);
+    }
+    this->write8(this->dataOut);
+}
+
+int PCF8574::lastError(){
+    int error = this->error;
+    this->error = PCF8574_OK;
+    return error;
+}
@@ -0,0 +1,110 @@
+/**
+ * @file PCF8574.h
+ * @brief This file contains the native PCF8574 class and the PCF8574Device class it talks to
+ * @details The PCF8574 class has the same interface as the driver library the firmware uses, and talks over the mock
+ * bus the same way. Making one puts a PCF8574Device on the bus at its address, which is the simulated chip.
+ * A test or simulator can watch what is written to the chip, and drive its input pins.
+ * @version 1.0.0
+ * @author Quinn Henthorne. Contact: quinn.henthorne@gmail.com
+*/
+
+#ifndef NATIVE_PCF8574_H
+#define NATIVE_PCF8574_H
+
+#include <stdint.h>
+#include "Wire.h"
+
+#define PCF8574_OK 0x00
+#define PCF8574_PIN_ERROR 0x81
+#define PCF8574_I2C_ERROR 0x82
+
+class PCF8574Device : public I2CDevice{
+    public:
+        /**
+         * @brief Take the bytes of a write. Each byte is put on the pins in turn
+         * @param data The bytes
+         * @param length The number of bytes
+        */
+        void Receive(const uint8_t *data, size_t length) override;
+
+        /**
+         * @brief Send the state of the pins
+         * @return The state of the pins
+        */
+        uint8_t Transmit() override;
+
+        /**
+         * @brief Set what is driving the pins from outside the chip
+         * @param inputs The level each pin is pulled to. A pin only reads high if it's written high and pulled high
+        */
+        void SetInputs(uint8_t inputs){ this->inputs = inputs; }
+
+        /**
+         * @brief Set what is driving one pin from outside the chip
+         * @param pin The pin number (0-7)
+         * @param value The level the pin is pulled to
+        */
+        void SetInput(uint8_t pin, bool value);
+
+        /**
+         * @brief Get the value last written to the pins
+         * @return The value of all 8 pins
+        */
+        uint8_t GetOutputs(){ return outputs; }
+
+        /**
+         * @brief Get the number of bytes written to the pins
+         * @return The number of bytes
+        */
+        uint32_t GetWriteCount(){ return writeCount; }
+
+        /**
+         * @brief Call a function every time a byte is put on the pins
+         * @param listener The function. It is given the new and old value of the pins, and the context
+         * @param context Anything the listener needs
+        */
+        void SetListener(void (*listener)(uint8_t value, uint8_t previous, void *context), void *context);
+
+    private:
+        uint8_t outputs{0xFF}; // the chip powers up with every pin high
+        uint8_t inputs{0xFF}; // nothing is pulling the pins low
+        uint32_t writeCount{0};
+        void (*listener)(uint8_t value, uint8_t previous, void *context){NULL};
+        void *context{NULL};
+};
+
+class PCF8574{
+    public:
+        /**
+         * @brief Construct a new PCF8574 object, and put a simulated chip on the bus at its address
+         * @param address The I2C address of the chip
+         * @param wire The bus the chip is on
+        */
+        PCF8574(uint8_t address, TwoWire *wire);
+
+        bool begin(uint8_t value = 0xFF);
+        bool isConnected();
+        uint8_t getAddress(){ return address; }
+
+        uint8_t read8();
+        uint8_t read(uint8_t pin);
+        void write8(uint8_t value);
+        void write(uint8_t pin, uint8_t value);
+        uint8_t valueOut(){ return dataOut; }
+        int lastError();
+
+        /**
+         * @brief Get the simulated chip
+         * @return The chip
+        */
+        PCF8574Device * GetDevice(){ return &device; }
+
+    private:
+        const uint8_t address;
+        TwoWire *wire;
+        PCF8574Device device;
+        uint8_t dataOut{0xFF};
+        int error{PCF8574_OK};
+};
+
+#endif // NATIVE_PCF8574_H
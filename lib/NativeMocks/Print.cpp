@@ -0,0 +1,88 @@
+/**
+ * @file Print.cpp
+ * @brief This file contains the native Print class implimentation
+ * @version 1.0.0
+ * @author Quinn Henthorne. Contact: quinn.henthorne@gmail.com
+*/
+
+#include "Print.h"
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+size_t Print::write(const uint8_t *buffer, size_t size){
+    size_t written = 0;
+    while(size-- > 0){
+        written += this->write(*buffer++);
+    }
+    return written;
+}
+
+size_t Print::print(const char *text){
+    return this->write(text, strlen(text));
+}
+
+size_t Print::print(char character){
+    return this->write(static_cast<uint8_t>(character));
+}
+
+size_t Print::print(unsigned char number, int base){
+    return this->printNumber(number, base);
+}
+
+size_t Print::print(int number, int base){
+    return this->print(static_cast<long long>(number), base);
+}
+
+size_t Print::print(unsigned int number, int base){
+    return this->printNumber(number, base);
+}
+
+size_t Print::print(long number, int base){
+    return this->print(static_cast<long long>(number), base);
+}
+
+size_t Print::print(unsigned long number, int base){
+    return this->printNumber(number, base);
+}
+
+size_t Print::print(long long number, int base){
+    // like the Arduino core, only decimal numbers get a sign
+    if(base == 10 && number < 0){
+        return this->print('-') + this->printNumber(-static_cast<unsigned long long>(number), base);
+    }
+    return this->printNumber(static_cast<unsigned long long>(number), base);
+}
+
+size_t Print::print(unsigned long long number, int base){
+    return this->printNumber(number, base);
+}
+
+size_t Print::print(double number, int digits){
+    if(isnan(number)){
+        return this->print("nan");
+    }
+    if(isinf(number)){
+        return this->print("inf");
+    }
+    char buffer[64];
+    int length = snprintf(buffer, sizeof(buffer), "%.*f", digits, number);
+    return this->write(buffer, length);
+}
+
+size_t Print::println(){
+    return this->write("\r\n", 2);
+}
+
+size_t Print::printNumber(unsigned long long number, int base){
+    if(base < 2 || base > 16){
+        base = 10;
+    }
+    char buffer[8 * sizeof(number) + 1];
+    char *digit = &buffer[sizeof(buffer)];
+    do{
+        *--digit = "0123456789ABCDEF"[number % base];
+        number /= base;
+    } while(number > 0);
+    return this->write(digit, &buffer[sizeof(buffer)] - digit);
+}
@@ -0,0 +1,69 @@
+/**
+ * @file Print.h
+ * @brief This file contains the native Print class
+ * @details Like the Arduino Print class, every print ends up in write(), which the port overrides
+ * @version 1.0.0
+ * @author Quinn Henthorne. Contact: quinn.henthorne@gmail.com
+*/
+
+#ifndef NATIVE_PRINT_H
+#define NATIVE_PRINT_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+class Print{
+    public:
+        virtual ~Print(){}
+
+        /**
+         * @brief Write one byte
+         * @param byte The byte to write
+         * @return The number of bytes written
+        */
+        virtual size_t write(uint8_t byte) = 0;
+
+        /**
+         * @brief Write a buffer
+         * @param buffer The bytes to write
+         * @param size The number of bytes to write
+         * @return The number of bytes written
+        */
+        virtual size_t write(const uint8_t *buffer, size_t size);
+
+        size_t write(const char *buffer, size_t size){ return write(reinterpret_cast<const uint8_t *>(buffer), size); }
+
+        /**
+         * @brief Get how many bytes can be written without blocking
+         * @return The number of bytes
+        */
+        virtual int availableForWrite(){ return 0; }
+
+        virtual void flush(){}
+
+        size_t print(const char *text);
+        size_t print(char character);
+        size_t print(unsigned char number, int base = 10);
+        size_t print(int number, int base = 10);
+        size_t print(unsigned int number, int base = 10);
+        size_t print(long number, int base = 10);
+        size_t print(unsigned long number, int base = 10);
+        size_t print(long long number, int base = 10);
+        size_t print(unsigned long long number, int base = 10);
+        size_t print(double number, int digits = 2);
+
+        size_t println();
+        template<typename T> size_t println(T value){ return print(value) + println(); }
+        template<typename T> size_t println(T value, int format){ return print(value, format) + println(); }
+
+    private:
+        /**
+         * @brief Write a number in a base
+         * @param number The number to write
+         * @param base The base to write it in (2-16)
+         * @return The number of bytes written
+        */
+        size_t printNumber(unsigned long long number, int base);
+};
+
+#endif // NATIVE_PRINT_H
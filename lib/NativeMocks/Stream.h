@@ -0,0 +1,34 @@
+/**
+ * @file Stream.h
+ * @brief This file contains the native Stream class
+ * @version 1.0.0
+ * @author Quinn Henthorne. Contact: quinn.henthorne@gmail.com
+*/
+
+#ifndef NATIVE_STREAM_H
+#define NATIVE_STREAM_H
+
+#include "Print.h"
+
+class Stream : public Print{
+    public:
+        /**
+         * @brief Get the number of bytes that can be read
+         * @return The number of bytes
+        */
+        virtual int available() = 0;
+
+        /**
+         * @brief Read a byte
+         * @return The byte, or -1 if there isn't one
+        */
+        virtual int read() = 0;
+
+        /**
+         * @brief Look at the next byte without reading it
+         * @return The byte, or -1 if there isn't one
+        */
+        virtual int peek() = 0;
+};
+
+#endif // NATIVE_STREAM_H
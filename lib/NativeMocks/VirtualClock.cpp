@@ -0,0 +1,136 @@
+/**
+ * @file VirtualClock.cpp
+ * @brief This file contains the VirtualClock class implimentation, and the Arduino time functions that use it
+ * @version 1.0.0
+ * @author Quinn Henthorne. Contact: quinn.henthorne@gmail.com
+*/
+
+#include "VirtualClock.h"
+#include "Arduino.h"
+#include <time.h>
+
+bool VirtualClock::isRealTime = true;
+uint64_t VirtualClock::time = 0;
+uint64_t VirtualClock::realTimeStart = 0;
+float VirtualClock::speed = 1.0f;
+VirtualClock::Timer VirtualClock::timers[VIRTUAL_CLOCK_MAX_TIMERS] = {};
+
+uint64_t VirtualClock::Now(){
+    if(!isRealTime){
+        return time;
+    }
+    uint64_t elapsed = hostMicros() - realTimeStart;
+    if(speed != 1.0f){
+        elapsed = static_cast<uint64_t>(elapsed * static_cast<double>(speed));
+    }
+    return time + elapsed;
+}
+
+void VirtualClock::Set(uint64_t time){
+    VirtualClock::time = time;
+    isRealTime = false;
+}
+
+void VirtualClock::Advance(uint64_t elapsed){
+    uint64_t end = Now() + elapsed;
+    isRealTime = false;
+
+    // run the timers in the order they go off, with the clock at the time each one is due
+    while(true){
+        Timer *next = NULL;
+        for(uint8_t i = 0; i < VIRTUAL_CLOCK_MAX_TIMERS; i++){
+            Timer &timer = timers[i];
+            if(timer.callback != NULL && timer.nextAlarm <= end && (next == NULL || timer.nextAlarm < next->nextAlarm)){
+                next = &timer;
+            }
+        }
+        if(next == NULL){
+            break;
+        }
+        if(next->nextAlarm > time){
+            time = next->nextAlarm;
+        }
+        next->nextAlarm += next->period;
+        next->callback();
+    }
+    time = end;
+}
+
+void VirtualClock::RunInRealTime(float speed){
+    time = Now();
+    realTimeStart = hostMicros();
+    VirtualClock::speed = speed > 0 ? speed : 1.0f;
+    isRealTime = true;
+}
+
+int8_t VirtualClock::AddTimer(uint32_t period, void (*callback)()){
+    if(period == 0 || callback == NULL){
+        return -1;
+    }
+    for(uint8_t i = 0; i < VIRTUAL_CLOCK_MAX_TIMERS; i++){
+        if(timers[i].callback == NULL){
+            timers[i] = {period, callback, Now() + period};
+            return i;
+        }
+    }
+    return -1;
+}
+
+void VirtualClock::RemoveTimer(int8_t timer){
+    if(timer < 0 || timer >= VIRTUAL_CLOCK_MAX_TIMERS){
+        return;
+    }
+    timers[timer].callback = NULL;
+}
+
+void VirtualClock::RunTimers(){
+    uint64_t now = Now();
+    for(uint8_t i = 0; i < VIRTUAL_CLOCK_MAX_TIMERS; i++){
+        Timer &timer = timers[i];
+        if(timer.callback == NULL || timer.nextAlarm > now){
+            continue;
+        }
+        // a missed alarm isn't made up for, the next one is just a period from now
+        timer.nextAlarm += timer.period;
+        if(timer.nextAlarm <= now){
+            timer.nextAlarm = now + timer.period;
+        }
+        timer.callback();
+    }
+}
+
+uint64_t VirtualClock::hostMicros(){
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    uint64_t micros = static_cast<uint64_t>(now.tv_sec) * 1000000 + now.tv_nsec / 1000;
+    // counted from the first time it's asked for, since that can be before any static is set up
+    static const uint64_t start = micros;
+    return micros - start;
+}
+
+unsigned long millis(){
+    return static_cast<uint32_t>(VirtualClock::Now() / 1000);
+}
+
+unsigned long micros(){
+    return static_cast<uint32_t>(VirtualClock::Now());
+}
+
+void delay(unsigned long ms){
+    delayMicroseconds(ms * 1000);
+}
+
+void delayMicroseconds(unsigned int us){
+    if(!VirtualClock::IsRealTime()){
+        VirtualClock::Advance(us);
+        return;
+    }
+    uint64_t end = VirtualClock::Now() + us;
+    while(VirtualClock::Now() < end){
+        VirtualClock::RunTimers();
+    }
+}
+
+void yield(){
+    VirtualClock::RunTimers();
+}
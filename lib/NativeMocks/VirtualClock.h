@@ -0,0 +1,94 @@
+/**
+ * @file VirtualClock.h
+ * @brief This file contains the VirtualClock class
+ * @details The virtual clock is where millis() and micros() get their time on the native build. It starts out following
+ * the PC's clock. Once it is set or advanced by hand it stops, and only moves when it's told to, so a test can put the
+ * firmware at an exact time. Timers are run off the clock too. When it is advanced by hand every timer goes off
+ * at the exact time it is due, in order.
+ * @version 1.0.0
+ * @author Quinn Henthorne. Contact: quinn.henthorne@gmail.com
+*/
+
+#ifndef VIRTUAL_CLOCK_H
+#define VIRTUAL_CLOCK_H
+
+#include <stdint.h>
+
+// the most timers that can be running at once
+#define VIRTUAL_CLOCK_MAX_TIMERS 4
+
+class VirtualClock{
+    public:
+        /**
+         * @brief Get the time since the program started
+         * @return The time in microseconds. This doesn't wrap around like micros() does
+        */
+        static uint64_t Now();
+
+        /**
+         * @brief Stop the clock at a time
+         * @param time The time in microseconds
+         * @note Timers don't go off. Use Advance() to run them
+        */
+        static void Set(uint64_t time);
+
+        /**
+         * @brief Stop the clock and move it forward, running every timer that goes off on the way
+         * @param elapsed The time to move forward in microseconds
+        */
+        static void Advance(uint64_t elapsed);
+
+        /**
+         * @brief Start following the PC's clock again from the current time
+         * @param speed How many times faster than the PC's clock to run. More than 1 runs faster than real time
+        */
+        static void RunInRealTime(float speed = 1.0f);
+
+        /**
+         * @brief Returns true if the clock is following the PC's clock
+         * @return true if the clock is running in real time
+        */
+        static bool IsRealTime(){ return isRealTime; }
+
+        /**
+         * @brief Call a function every period, like a hardware timer alarm
+         * @param period The time between calls in microseconds
+         * @param callback The function to call
+         * @return The timer, or -1 if there are too many timers
+        */
+        static int8_t AddTimer(uint32_t period, void (*callback)());
+
+        /**
+         * @brief Stop a timer
+         * @param timer The timer from AddTimer()
+        */
+        static void RemoveTimer(int8_t timer);
+
+        /**
+         * @brief Run every timer that is due at the current time
+         * @note A timer that is more than one period behind only goes off once, like a hardware timer interrupt
+         * that wasn't serviced in time
+        */
+        static void RunTimers();
+
+    private:
+        struct Timer{
+            uint32_t period;
+            void (*callback)();
+            uint64_t nextAlarm;
+        };
+
+        static bool isRealTime;
+        static uint64_t time; // the time when the clock was stopped, or when it last started following the PC's clock
+        static uint64_t realTimeStart; // the PC's clock when the clock last started following it
+        static float speed; // how many times faster than the PC's clock to run
+        static Timer timers[VIRTUAL_CLOCK_MAX_TIMERS];
+
+        /**
+         * @brief Get the PC's clock
+         * @return The time in microseconds since the clock was first read
+        */
+        static uint64_t hostMicros();
+};
+
+#endif // VIRTUAL_CLOCK_H
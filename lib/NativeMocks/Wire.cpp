@@ -0,0 +1,106 @@
+/**
+ * @file Wire.cpp
+ * @brief This file contains the native TwoWire class implimentation
+ * @version 1.0.0
+ * @author Quinn Henthorne. Contact: quinn.henthorne@gmail.com
+*/
+
+#include "Wire.h"
+
+// the clocks a transaction takes on top of its data bytes: the start, the address byte and the stop
+#define TRANSACTION_OVERHEAD_CLOCKS (1 + 9 + 1)
+
+bool TwoWire::begin(int sda, int scl, uint32_t frequency){
+    if(frequency != 0){
+        this->frequency = frequency;
+    }
+    return true;
+}
+
+bool TwoWire::end(){
+    return true;
+}
+
+bool TwoWire::setClock(uint32_t frequency){
+    this->frequency = frequency;
+    return true;
+}
+
+void TwoWire::beginTransmission(uint8_t address){
+    this->address = address & (I2C_ADDRESS_COUNT - 1);
+    this->length = 0;
+    this->isOverflowed = false;
+}
+
+size_t TwoWire::write(uint8_t data){
+    if(this->length == I2C_BUFFER_LENGTH){
+        this->isOverflowed = true;
+        return 0;
+    }
+    this->buffer[this->length++] = data;
+    return 1;
+}
+
+size_t TwoWire::write(const uint8_t *data, size_t length){
+    size_t written = 0;
+    while(written < length && this->write(data[written]) == 1){
+        written++;
+    }
+    return written;
+}
+
+uint8_t TwoWire::endTransmission(bool sendStop){
+    I2CDevice *device = this->devices[this->address];
+    if(device == NULL){
+        return 2;
+    }
+    if(this->isOverflowed){
+        return 1;
+    }
+    device->Receive(this->buffer, this->length);
+    this->transactionCount++;
+    this->clocks += TRANSACTION_OVERHEAD_CLOCKS + 9 * this->length;
+    return 0;
+}
+
+uint8_t TwoWire::requestFrom(uint8_t address, uint8_t quantity){
+    this->readLength = 0;
+    this->readIndex = 0;
+    I2CDevice *device = this->devices[address & (I2C_ADDRESS_COUNT - 1)];
+    if(device == NULL){
+        return 0;
+    }
+    if(quantity > I2C_BUFFER_LENGTH){
+        quantity = I2C_BUFFER_LENGTH;
+    }
+    for(uint8_t i = 0; i < quantity; i++){
+        this->readBuffer[i] = device->Transmit();
+    }
+    this->readLength = quantity;
+    this->transactionCount++;
+    this->clocks += TRANSACTION_OVERHEAD_CLOCKS + 9 * quantity;
+    return quantity;
+}
+
+int TwoWire::available(){
+    return this->readLength - this->readIndex;
+}
+
+int TwoWire::read(){
+    if(this->readIndex >= this->readLength){
+        return -1;
+    }
+    return this->readBuffer[this->readIndex++];
+}
+
+void TwoWire::Attach(uint8_t address, I2CDevice *device){
+    this->devices[address & (I2C_ADDRESS_COUNT - 1)] = device;
+}
+
+I2CDevice * TwoWire::GetDevice(uint8_t address){
+    return this->devices[address & (I2C_ADDRESS_COUNT - 1)];
+}
+
+uint64_t TwoWire::GetBusyTime(){
+    return this->clocks * 1000000 / this->frequency;
+}
@@ -0,0 +1,115 @@
+/**
+ * @file Wire.h
+ * @brief This file contains the native TwoWire class and the I2CDevice class for the devices on its bus
+ * @details The mock bus passes every transaction to the device at its address, so a write is seen by the device
+ * the same way it would be over the wire. An address with no device on it doesn't acknowledge.
+ * @version 1.0.0
+ * @author Quinn Henthorne. Contact: quinn.henthorne@gmail.com
+*/
+
+#ifndef NATIVE_WIRE_H
+#define NATIVE_WIRE_H
+
+#include "Arduino.h"
+
+// the most bytes in one transaction, the same as the ESP32's buffer
+#define I2C_BUFFER_LENGTH 128
+
+// the number of 7 bit addresses
+#define I2C_ADDRESS_COUNT 128
+
+class I2CDevice{
+    public:
+        virtual ~I2CDevice(){}
+
+        /**
+         * @brief Take the bytes of a write to this device
+         * @param data The bytes, in the order they were sent
+         * @param length The number of bytes
+        */
+        virtual void Receive(const uint8_t *data, size_t length) = 0;
+
+        /**
+         * @brief Send one byte of a read from this device
+         * @return The byte
+        */
+        virtual uint8_t Transmit() = 0;
+};
+
+class TwoWire{
+    public:
+        /**
+         * @brief Construct a new Two Wire object
+         * @param busNumber The I2C peripheral the bus stands in for
+        */
+        TwoWire(uint8_t busNumber) : busNumber(busNumber){}
+
+        bool begin(int sda = -1, int scl = -1, uint32_t frequency = 0);
+        bool end();
+        bool setClock(uint32_t frequency);
+        uint32_t getClock(){ return frequency; }
+
+        void beginTransmission(uint8_t address);
+        size_t write(uint8_t data);
+        size_t write(const uint8_t *data, size_t length);
+
+        /**
+         * @brief Send the bytes written since beginTransmission() to the device
+         * @param sendStop Unused
+         * @return 0 on success, 2 if there is no device at the address, 1 if there were too many bytes
+        */
+        uint8_t endTransmission(bool sendStop = true);
+
+        /**
+         * @brief Read bytes from a device
+         * @param address The address of the device
+         * @param quantity The number of bytes to read
+         * @return The number of bytes read. 0 if there is no device at the address
+        */
+        uint8_t requestFrom(uint8_t address, uint8_t quantity);
+        int available();
+        int read();
+
+        /**
+         * @brief Put a device on the bus
+         * @param address The 7 bit address of the device
+         * @param device The device. NULL takes the device at the address off the bus
+        */
+        void Attach(uint8_t address, I2CDevice *device);
+
+        /**
+         * @brief Get the device at an address
+         * @param address The 7 bit address
+         * @return The device, or NULL if there isn't one
+        */
+        I2CDevice * GetDevice(uint8_t address);
+
+        /**
+         * @brief Get the number of transactions on the bus
+         * @return The number of writes and reads that were acknowledged
+        */
+        uint32_t GetTransactionCount(){ return transactionCount; }
+
+        /**
+         * @brief Get the time the bus has been busy, at the clock frequency it was started at
+         * @return The time in microseconds
+         * @note Each byte takes 9 clocks, and each transaction has an address byte and a start and stop
+        */
+        uint64_t GetBusyTime();
+
+    private:
+        const uint8_t busNumber;
+        uint32_t frequency{100000};
+        I2CDevice *devices[I2C_ADDRESS_COUNT]{};
+        uint8_t address{0};
+        uint8_t buffer[I2C_BUFFER_LENGTH];
+        size_t length{0};
+        bool isOverflowed{false};
+        uint8_t readBuffer[I2C_BUFFER_LENGTH];
+        size_t readLength{0};
+        size_t readIndex{0};
+        uint32_t transactionCount{0};
+        uint64_t clocks{0}; // the bus clocks of every transaction so far
+};
+
+#endif // NATIVE_WIRE_H
@@ -0,0 +1,42 @@
+/**
+ * @file CycleTimer.h
+ * @brief This file contains the CycleTimer class
+ * @details The cycle timer times code with the CPU's cycle counter, which is a single register read,
+ * so it can be wrapped around anything in the step path. The counter wraps around every 17 seconds at 240MHz,
+ * so it is only good for timing things shorter than that. The counter is per core, so a time has to be started
+ * and stopped on the same task.
+ * @version 1.0.0
+ * @author Quinn Henthorne. Contact: quinn.henthorne@gmail.com
+*/
+
+#ifndef CYCLE_TIMER_H
+#define CYCLE_TIMER_H
+
+#include <Arduino.h>
+
+class CycleTimer{
+    public:
+        /**
+         * @brief Read the CPU clock frequency, which is needed to turn cycles into time
+         * @note Call this again if the CPU frequency is changed
+        */
+        static void Begin(){ cyclesPerMicrosecond = getCpuFrequencyMhz(); }
+
+        /**
+         * @brief Get the cycle counter
+         * @return The number of CPU cycles since boot, wrapped to 32 bits
+        */
+        static uint32_t Now(){ return ESP.getCycleCount(); }
+
+        /**
+         * @brief Get the time since a cycle count
+         * @param start The cycle count from Now() to time from
+         * @return The time in microseconds
+        */
+        static uint32_t MicrosSince(uint32_t start){ return (Now() - start) / cyclesPerMicrosecond; }
+
+    private:
+        static uint32_t cyclesPerMicrosecond;
+};
+
+#endif // CYCLE_TIMER_H
@@ -0,0 +1,39 @@
+/**
+ * @file Histogram.cpp
+ * @brief This file contains the Histogram and CycleTimer class implimentations
+ * @version 1.0.0
+ * @author Quinn Henthorne. Contact: quinn.henthorne@gmail.com
+*/
+
+#include "Histogram.h"
+#include <stdio.h>
+
+uint32_t CycleTimer::cyclesPerMicrosecond = 240; // the ESP32's default until Begin() reads it
+
+void Histogram::Reset(){
+    for(uint8_t i = 0; i < HISTOGRAM_BUCKETS; i++){
+        this->buckets[i] = 0;
+    }
+    this->count = 0;
+    this->max = 0;
+    this->total = 0;
+}
+
+void Histogram::Report(Print &output, const char *command, const char *name){
+    // take a copy first, since the step task can record while we print
+    Histogram copy = *this;
+
+    // the report is built first and printed in one write, so nothing else sent on the port can land in the middle of it
+    char report[HISTOGRAM_REPORT_LENGTH];
+    int length = snprintf(report, sizeof(report), "!%s,%s,N%lu,A%lu,M%lu,B", command, name,
+        static_cast<unsigned long>(copy.count),
+        static_cast<unsigned long>(copy.count == 0 ? 0 : static_cast<uint32_t>(copy.total / copy.count)),
+        static_cast<unsigned long>(copy.max));
+    for(uint8_t i = 0; i < HISTOGRAM_BUCKETS && length < static_cast<int>(sizeof(report)); i++){
+        length += snprintf(report + length, sizeof(report) - length, i > 0 ? ":%lu" : "%lu", static_cast<unsigned long>(copy.buckets[i]));
+    }
+    if(length < static_cast<int>(sizeof(report))){
+        snprintf(report + length, sizeof(report) - length, ";\r\n");
+    }
+    output.print(report);
+}
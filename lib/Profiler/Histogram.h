@@ -0,0 +1,77 @@
+/**
+ * @file Histogram.h
+ * @brief This file contains the Histogram class
+ * @details A histogram counts times in microseconds into fixed buckets that double in width, so one histogram
+ * covers everything from a fast loop to a stalled I2C bus. Bucket 0 counts times under 1us, bucket n counts times
+ * from 2^(n-1) up to 2^n us, and the last bucket counts everything longer. Recording is a few instructions and
+ * never allocates, so it can be used in the step path.
+ * @version 1.0.0
+ * @author Quinn Henthorne. Contact: quinn.henthorne@gmail.com
+*/
+
+#ifndef HISTOGRAM_H
+#define HISTOGRAM_H
+
+#include <Arduino.h>
+#include "CycleTimer.h"
+
+// the number of buckets. The last one counts everything from 2^(HISTOGRAM_BUCKETS - 2) us, which is 16ms
+#define HISTOGRAM_BUCKETS 16
+// the longest report, with every count at its largest
+#define HISTOGRAM_REPORT_LENGTH 256
+
+class Histogram{
+    public:
+        /**
+         * @brief Count a time
+         * @param time The time in microseconds
+        */
+        void Record(uint32_t time){
+            uint8_t bucket = time == 0 ? 0 : 32 - __builtin_clz(time);
+            this->buckets[bucket < HISTOGRAM_BUCKETS ? bucket : HISTOGRAM_BUCKETS - 1]++;
+            this->count++;
+            this->total += time;
+            if(time > this->max){
+                this->max = time;
+            }
+        }
+
+        /**
+         * @brief Count the time since a cycle count
+         * @param start The cycle count from CycleTimer::Now() when the thing being timed started
+        */
+        void RecordSince(uint32_t start){ this->Record(CycleTimer::MicrosSince(start)); }
+
+        /**
+         * @brief Clear every count
+        */
+        void Reset();
+
+        /**
+         * @brief Get the number of times counted
+         * @return The count since the last reset
+        */
+        uint32_t GetCount(){ return count; }
+
+        /**
+         * @brief Get the longest time counted
+         * @return The longest time since the last reset in microseconds
+        */
+        uint32_t GetMax(){ return max; }
+
+        /**
+         * @brief Print the histogram as !<command>,<name>,N<count>,A<average>,M<max>,B<bucket 0>:<bucket 1>:...;
+         * @param output Where to print it
+         * @param command The command the report is for, like M881
+         * @param name The name of what was timed
+        */
+        void Report(Print &output, const char *command, const char *name);
+
+    private:
+        uint32_t buckets[HISTOGRAM_BUCKETS]{};
+        uint32_t count{0};
+        uint32_t max{0}; // the longest time in microseconds
+        uint64_t total{0}; // every time added up, for the average
+};
+
+#endif // HISTOGRAM_H
@@ -0,0 +1,176 @@
+/**
+ * @file RecipePlayer.cpp
+ * @brief This file contains the RecipePlayer implimentation
+ * @version 1.0.0
+ * @author Quinn Henthorne. Contact: quinn.henthorne@gmail.com
+*/
+
+#include "RecipePlayer.h"
+#include "GCodeParser.h"
+#include "Log.h"
+
+bool RecipePlayer::Start(int32_t slot, Print *replyOutput){
+    this->Stop();
+    this->SetReplyOutput(replyOutput);
+    // a compiled recipe doesn't have to be planned, so it is run if there is one
+    this->file = this->store->OpenCompiled(slot);
+    this->isCompiled = this->file != NULL;
+    if(this->isCompiled){
+        RecipeSegments::Header header;
+        if(!RecipeSegments::ReadHeader(this->file, header) || !this->canRun(header)){
+            fclose(this->file);
+            this->file = NULL;
+            return false;
+        }
+    }
+    else{
+        this->file = this->store->Open(slot);
+    }
+    if(this->file == NULL){
+        return false;
+    }
+    this->slot = slot;
+    this->commandsRun = 0;
+    this->isRunning = true;
+    return true;
+}
+
+void RecipePlayer::Stop(){
+    if(this->file != NULL){
+        fclose(this->file);
+        this->file = NULL;
+    }
+    while(this->queue.size() > 0){
+        this->queue.pop();
+    }
+    this->pendingRecord = RecipeSegments::RecordType::END;
+    this->isRunning = false;
+}
+
+void RecipePlayer::Update(){
+    if(!this->isRunning){
+        return;
+    }
+
+    // keep the queue topped up, a few lines at a time
+    for(uint8_t i = 0; i < RECIPE_LINES_PER_UPDATE && this->file != NULL; i++){
+        if(this->isCompiled){
+            if(!this->readRecord()){
+                break;
+            }
+            continue;
+        }
+        if(this->queue.size() == this->queue.max_size()){
+            break;
+        }
+        if(!this->readLine()){
+            fclose(this->file);
+            this->file = NULL;
+        }
+    }
+
+    // the recipe is done once everything has been read and taken from the queue, and every move has finished
+    if(this->file == NULL && this->queue.size() == 0 && (!this->isCompiled || this->planner->IsEmpty())){
+        this->isRunning = false;
+        // the recipe's own replies go to whoever started it, so that's where it says it's done
+        this->PrintStatus(*this);
+    }
+}
+
+GCodeDefinitions::GCode * RecipePlayer::PopGCode(){
+    this->commandsRun++;
+    return this->queue.pop();
+}
+
+void RecipePlayer::PrintStatus(GCodeSource &source){
+    source.Reply("!M27,P%ld,S%d,N%lu;", static_cast<long>(this->slot), this->isRunning ? 1 : 0, static_cast<unsigned long>(this->commandsRun));
+}
+
+bool RecipePlayer::readLine(){
+    char line[RECIPE_LINE_LENGTH];
+    if(fgets(line, sizeof(line), this->file) == NULL){
+        return false;
+    }
+
+    // a command is between the start and end markers, the same as over serial. Anything else is a comment
+    char *start = strchr(line, '!');
+    if(start == NULL){
+        return true;
+    }
+    start++;
+    char *end = strchr(start, ';');
+    if(end == NULL){
+        return true;
+    }
+
+    GCodeDefinitions::GCode command = GCodeParser::Parse(start, end - start);
+    if(command.command == GCodeDefinitions::Command::M0){
+        this->estopCommandReceived = true;
+    }
+    else{
+        this->queue.push(command);
+    }
+    return true;
+}
+
+bool RecipePlayer::readRecord(){
+    if(this->pendingRecord == RecipeSegments::RecordType::END){
+        this->pendingRecord = RecipeSegments::ReadRecord(this->file, this->pendingSegment, this->pendingCommand);
+        if(this->pendingRecord == RecipeSegments::RecordType::END){
+            fclose(this->file);
+            this->file = NULL;
+            return false;
+        }
+    }
+
+    // nothing goes past a command until it has been run
+    if(this->queue.size() > 0){
+        return false;
+    }
+
+    if(this->pendingRecord == RecipeSegments::RecordType::SEGMENT){
+        this->scheduler->Lock();
+        bool isAdded = this->planner->AddSegment(this->pendingSegment);
+        this->scheduler->Unlock();
+        if(!isAdded){
+            return false;
+        }
+        this->commandsRun++;
+    }
+    else{
+        // a command runs once the moves before it have finished
+        if(!this->planner->IsEmpty()){
+            return false;
+        }
+        if(this->pendingCommand.command == GCodeDefinitions::Command::M0){
+            this->estopCommandReceived = true;
+        }
+        else{
+            this->queue.push(this->pendingCommand);
+        }
+    }
+    this->pendingRecord = RecipeSegments::RecordType::END;
+    return true;
+}
+
+bool RecipePlayer::canRun(const RecipeSegments::Header &header){
+    for(uint8_t i = 0; i < MOTION_PLANNER_AXES; i++){
+        StepperMotor *motor = this->planner->GetMotor(i);
+        if(header.stepsPerUnit[i] != RecipeSegments::FixedStepsPerUnit(motor->GetConfiguration().stepsPerUnit)){
+            LOG_ERROR("The compiled recipe is for a machine with different steps per unit");
+            return false;
+        }
+        // the moves were planned from the start position, so they would all be off from anywhere else
+        if(motor->IsMoving() || motor->GetCurrentPosition() != header.startPosition[i]){
+            char position[MOTION_PLANNER_AXES * 13] = "";
+            int length = 0;
+            for(uint8_t axis = 0; axis < MOTION_PLANNER_AXES; axis++){
+                length += snprintf(position + length, sizeof(position) - length, "%s%c%ld", axis == 0 ? "" : ",",
+                    MACHINE_AXIS_LETTERS[axis], static_cast<long>(header.startPosition[axis]));
+            }
+            LOG_ERROR("The compiled recipe has to start at %s", position);
+            return false;
+        }
+    }
+    return true;
+}
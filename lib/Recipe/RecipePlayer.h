@@ -0,0 +1,138 @@
+/**
+ * @file RecipePlayer.h
+ * @brief This file contains the RecipePlayer class
+ * @details This file contains the RecipePlayer class which runs a recipe from the RecipeStore.
+ * It reads ahead of the running command into its own queue, a few lines each update, so motion never waits on flash
+ * and a loop is never held up reading a whole recipe. Its queue is used like the queue of a serial message.
+ * If the slot has a compiled recipe, that is run instead. Its moves go straight into the motion planner already planned,
+ * and its other commands go in the queue once the moves before them have finished.
+ * @version 1.0.0
+ * @author Quinn Henthorne. Contact: quinn.henthorne@gmail.com
+*/
+
+#ifndef RECIPE_PLAYER_H
+#define RECIPE_PLAYER_H
+
+#include <Arduino.h>
+#include "RecipeStore.h"
+#include "RecipeSegments.h"
+#include "GCodeQueue.h"
+#include "GCodeSource.h"
+#include "MotionPlanner.h"
+#include "StepScheduler.h"
+
+// how many commands are read ahead of the running one
+#define RECIPE_READ_AHEAD_DEPTH 32
+
+// the most lines that are read from flash in one update
+#define RECIPE_LINES_PER_UPDATE 4
+
+class RecipePlayer : public GCodeSource{
+    public:
+        /**
+         * @brief Construct a new Recipe Player object
+         * @param store Where the recipes are kept
+         * @param planner The planner compiled moves are given to
+         * @param scheduler The step scheduler whose lock is held while moves are given to the planner
+        */
+        RecipePlayer(RecipeStore *store, MotionPlanner *planner, StepScheduler *scheduler) :
+            store(store),
+            planner(planner),
+            scheduler(scheduler){}
+
+        /**
+         * @brief Start running a recipe
+         * @param slot The slot the recipe is in
+         * @param replyOutput Where the replies to the recipe's commands go, and its status when it finishes.
+         * This is the channel that started it
+         * @return true if the recipe started. False if there isn't a recipe in the slot,
+         * or it was compiled for a different machine or a different start position
+         * @note A recipe that is already running is stopped first. A compiled recipe is run if there is one
+        */
+        bool Start(int32_t slot, Print *replyOutput);
+
+        /**
+         * @brief Stop running the recipe and throw away the commands that were read ahead
+        */
+        void Stop();
+
+        /**
+         * @brief Read the next few lines of the recipe into the queue
+         * @note Prints the status when the last command of the recipe has been taken from the queue,
+         * and the last compiled move has finished
+        */
+        void Update();
+
+        /**
+         * @brief Returns true if a recipe is running
+         * @return true until the last command of the recipe has been taken from the queue
+        */
+        bool IsRunning(){ return isRunning; }
+
+        /**
+         * @brief Returns the next command of the recipe without removing it from the queue
+         * @return the next command. NULL if there isn't one ready
+        */
+        GCodeDefinitions::GCode * PeekGCode() override{ return queue.peek(); }
+
+        /**
+         * @brief Take the next command of the recipe from the queue
+         * @return the command
+        */
+        GCodeDefinitions::GCode * PopGCode() override;
+
+        /**
+         * @brief Returns true if the recipe has an estop command in it
+         * @return true if an estop command has been read
+         * @post The flag will be set to false
+        */
+        bool EStopCommandReceived(){
+            bool tempVal = this->estopCommandReceived;
+            this->estopCommandReceived = false;
+            return tempVal;
+        }
+
+        /**
+         * @brief Print the status of the recipe
+         * @param source The channel that asked for it. The status is sent as a reply to it
+         * @note The status is !M27,P<slot>,S<1 if running or 0 if not>,N<commands taken from the recipe>;
+        */
+        void PrintStatus(GCodeSource &source);
+
+    private:
+        RecipeStore *store;
+        GCodeQueue<RECIPE_READ_AHEAD_DEPTH> queue; // the commands that have been read ahead
+        FILE *file{NULL}; // the recipe being read. NULL once it has all been read
+        bool isRunning{false};
+        bool estopCommandReceived{false};
+        int32_t slot{0};
+        uint32_t commandsRun{0}; // the number of commands taken from the queue
+
+        MotionPlanner *planner;
+        StepScheduler *scheduler;
+        bool isCompiled{false}; // true if the recipe being run is compiled
+        RecipeSegments::RecordType pendingRecord{RecipeSegments::RecordType::END}; // a record that has been read but not used yet
+        MotionSegment pendingSegment;
+        GCodeDefinitions::GCode pendingCommand;
+
+        /**
+         * @brief Read one line of the recipe into the queue
+         * @return false if there is nothing left to read
+        */
+        bool readLine();
+
+        /**
+         * @brief Hand the next record of a compiled recipe on
+         * @return false if the record has to wait, or there is nothing left to read
+        */
+        bool readRecord();
+
+        /**
+         * @brief Check that a compiled recipe is for this machine and it is where the recipe starts
+         * @param header The header of the recipe
+         * @return true if the recipe can be run
+        */
+        bool canRun(const RecipeSegments::Header &header);
+};
+
+#endif // RECIPE_PLAYER_H
@@ -0,0 +1,152 @@
+/**
+ * @file RecipeSegments.cpp
+ * @brief This file contains the reading and writing of compiled recipes
+ * @version 1.0.0
+ * @author Quinn Henthorne. Contact: quinn.henthorne@gmail.com
+*/
+
+#include "RecipeSegments.h"
+#include <string.h>
+#include "BinaryFrame.h"
+#include "GCodeParser.h"
+
+// the file starts with these so a text recipe is never run as a compiled one
+static const uint8_t magic[4] = {'M', 'C', 'S', 'G'};
+
+// the number of 32 bit values in a segment record
+#define SEGMENT_VALUES (2 * MOTION_PLANNER_AXES + 6)
+
+/**
+ * @brief Write 32 bit values as little endian bytes
+ * @param file The file to write to
+ * @param values The values to write
+ * @param count The number of values
+ * @return true if they were all written
+*/
+static bool writeValues(FILE *file, const int32_t *values, uint8_t count){
+    uint8_t bytes[4];
+    for(uint8_t i = 0; i < count; i++){
+        BinaryFrame::WriteInt32(values[i], bytes);
+        if(fwrite(bytes, 1, sizeof(bytes), file) != sizeof(bytes)){
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Read 32 bit values from little endian bytes
+ * @param file The file to read from
+ * @param values Where to put the values
+ * @param count The number of values
+ * @return true if they were all read
+*/
+static bool readValues(FILE *file, int32_t *values, uint8_t count){
+    uint8_t bytes[4];
+    for(uint8_t i = 0; i < count; i++){
+        if(fread(bytes, 1, sizeof(bytes), file) != sizeof(bytes)){
+            return false;
+        }
+        values[i] = BinaryFrame::ReadInt32(bytes);
+    }
+    return true;
+}
+
+uint32_t RecipeSegments::FixedStepsPerUnit(float stepsPerUnit){
+    return static_cast<uint32_t>(stepsPerUnit * (1UL << STEP_RATE_FRACTION_BITS) + 0.5f);
+}
+
+bool RecipeSegments::WriteHeader(FILE *file, const Header &header){
+    const uint8_t format[4] = {RECIPE_SEGMENTS_VERSION, MOTION_PLANNER_AXES, 0, 0};
+    int32_t values[2 * MOTION_PLANNER_AXES];
+    for(uint8_t i = 0; i < MOTION_PLANNER_AXES; i++){
+        values[i] = static_cast<int32_t>(header.stepsPerUnit[i]);
+        values[MOTION_PLANNER_AXES + i] = header.startPosition[i];
+    }
+    return fwrite(magic, 1, sizeof(magic), file) == sizeof(magic)
+        && fwrite(format, 1, sizeof(format), file) == sizeof(format)
+        && writeValues(file, values, 2 * MOTION_PLANNER_AXES);
+}
+
+bool RecipeSegments::ReadHeader(FILE *file, Header &header){
+    uint8_t fileMagic[4];
+    uint8_t format[4];
+    int32_t values[2 * MOTION_PLANNER_AXES];
+    if(fread(fileMagic, 1, sizeof(fileMagic), file) != sizeof(fileMagic) || memcmp(fileMagic, magic, sizeof(magic)) != 0){
+        return false;
+    }
+    if(fread(format, 1, sizeof(format), file) != sizeof(format)
+        || format[0] != RECIPE_SEGMENTS_VERSION || format[1] != MOTION_PLANNER_AXES){
+        return false;
+    }
+    if(!readValues(file, values, 2 * MOTION_PLANNER_AXES)){
+        return false;
+    }
+    for(uint8_t i = 0; i < MOTION_PLANNER_AXES; i++){
+        header.stepsPerUnit[i] = static_cast<uint32_t>(values[i]);
+        header.startPosition[i] = values[MOTION_PLANNER_AXES + i];
+    }
+    return true;
+}
+
+bool RecipeSegments::WriteSegment(FILE *file, const MotionSegment &segment){
+    int32_t values[SEGMENT_VALUES];
+    uint8_t n = 0;
+    for(uint8_t i = 0; i < MOTION_PLANNER_AXES; i++){
+        values[n++] = segment.target[i];
+    }
+    for(uint8_t i = 0; i < MOTION_PLANNER_AXES; i++){
+        values[n++] = segment.steps[i];
+    }
+    values[n++] = static_cast<int32_t>(segment.stepEventCount);
+    values[n++] = static_cast<int32_t>(segment.initialInterval);
+    values[n++] = segment.initialRampStep;
+    values[n++] = static_cast<int32_t>(segment.cruiseInterval);
+    values[n++] = static_cast<int32_t>(segment.exitInterval);
+    values[n++] = static_cast<int32_t>(segment.decelerateAfter);
+    return fputc(RecordType::SEGMENT, file) != EOF && writeValues(file, values, n);
+}
+
+bool RecipeSegments::WriteCommand(FILE *file, const GCodeDefinitions::GCode &command){
+    char text[UINT8_MAX + 1];
+    uint16_t length = GCodeParser::Format(command, text, sizeof(text));
+    if(length == 0){
+        return false;
+    }
+    return fputc(RecordType::COMMAND, file) != EOF && fputc(length, file) != EOF
+        && fwrite(text, 1, length, file) == length;
+}
+
+RecipeSegments::RecordType RecipeSegments::ReadRecord(FILE *file, MotionSegment &segment, GCodeDefinitions::GCode &command){
+    int type = fgetc(file);
+    if(type == RecordType::SEGMENT){
+        int32_t values[SEGMENT_VALUES];
+        if(!readValues(file, values, SEGMENT_VALUES)){
+            return RecordType::END;
+        }
+        uint8_t n = 0;
+        for(uint8_t i = 0; i < MOTION_PLANNER_AXES; i++){
+            segment.target[i] = values[n++];
+        }
+        for(uint8_t i = 0; i < MOTION_PLANNER_AXES; i++){
+            segment.steps[i] = values[n++];
+        }
+        segment.stepEventCount = static_cast<uint32_t>(values[n++]);
+        segment.initialInterval = static_cast<uint32_t>(values[n++]);
+        segment.initialRampStep = values[n++];
+        segment.cruiseInterval = static_cast<uint32_t>(values[n++]);
+        segment.exitInterval = static_cast<uint32_t>(values[n++]);
+        segment.decelerateAfter = static_cast<uint32_t>(values[n++]);
+        return RecordType::SEGMENT;
+    }
+    if(type == RecordType::COMMAND){
+        int length = fgetc(file);
+        char text[UINT8_MAX];
+        if(length == EOF || fread(text, 1, length, file) != static_cast<size_t>(length)){
+            return RecordType::END;
+        }
+        command = GCodeParser::Parse(text, length);
+        return RecordType::COMMAND;
+    }
+    return RecordType::END;
+}
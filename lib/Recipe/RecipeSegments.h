@@ -0,0 +1,86 @@
+/**
+ * @file RecipeSegments.h
+ * @brief This file contains the format of compiled recipes
+ * @details A compiled recipe is a recipe that has been through the motion planner ahead of time, so the controller
+ * only has to step it. The file is a header, then records in the order they run. A segment record is one planned move
+ * with its step intervals and ramp already worked out. A command record is any other command, written the way
+ * the parser reads it. Commands run once every move before them has finished. Values are little endian.
+ * The recipe compiler in tools/ writes these files with the same planner code the controller runs.
+ * @version 1.0.0
+ * @author Quinn Henthorne. Contact: quinn.henthorne@gmail.com
+*/
+
+#ifndef RECIPE_SEGMENTS_H
+#define RECIPE_SEGMENTS_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include "GCODE-DEFINITIONS.h"
+#include "MotionPlanner.h"
+
+// the version of the file format. A file with a different version can't be run
+#define RECIPE_SEGMENTS_VERSION 1
+
+namespace RecipeSegments{
+    enum RecordType : uint8_t{
+        END = 0x00, // there are no more records, or the next one couldn't be read
+        SEGMENT = 0x01, // a planned move
+        COMMAND = 0x02 // the length of a command string, then the string
+    };
+
+    // the machine a recipe was compiled for
+    struct Header{
+        uint32_t stepsPerUnit[MOTION_PLANNER_AXES]; // with STEP_RATE_FRACTION_BITS fractional bits
+        int32_t startPosition[MOTION_PLANNER_AXES]; // where the motors have to be when the recipe starts, in units
+    };
+
+    /**
+     * @brief Convert steps per unit to the fixed point value in the header
+     * @param stepsPerUnit The steps per unit of an axis
+     * @return The steps per unit with STEP_RATE_FRACTION_BITS fractional bits
+    */
+    uint32_t FixedStepsPerUnit(float stepsPerUnit);
+
+    /**
+     * @brief Write the header at the start of a compiled recipe
+     * @param file The file to write to
+     * @param header The header
+     * @return true if it was written
+    */
+    bool WriteHeader(FILE *file, const Header &header);
+
+    /**
+     * @brief Read the header of a compiled recipe
+     * @param file The file to read from
+     * @param header Where to put the header
+     * @return true if the file is a compiled recipe of this version with the same number of axes
+    */
+    bool ReadHeader(FILE *file, Header &header);
+
+    /**
+     * @brief Write a planned move
+     * @param file The file to write to
+     * @param segment The move
+     * @return true if it was written
+    */
+    bool WriteSegment(FILE *file, const MotionSegment &segment);
+
+    /**
+     * @brief Write a command that isn't a planned move
+     * @param file The file to write to
+     * @param command The command
+     * @return true if it was written
+    */
+    bool WriteCommand(FILE *file, const GCodeDefinitions::GCode &command);
+
+    /**
+     * @brief Read the next record
+     * @param file The file to read from
+     * @param segment Where to put the move if the record is a segment
+     * @param command Where to put the command if the record is a command
+     * @return The type of the record. END if there are no more or the record is cut short
+    */
+    RecordType ReadRecord(FILE *file, MotionSegment &segment, GCodeDefinitions::GCode &command);
+};
+
+#endif // RECIPE_SEGMENTS_H
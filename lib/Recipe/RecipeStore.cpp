@@ -0,0 +1,97 @@
+/**
+ * @file RecipeStore.cpp
+ * @brief This file contains the RecipeStore implimentation
+ * @version 1.0.0
+ * @author Quinn Henthorne. Contact: quinn.henthorne@gmail.com
+*/
+
+#include "RecipeStore.h"
+#include "GCodeParser.h"
+
+#ifdef ARDUINO_ARCH_ESP32
+#include <LittleFS.h>
+#else
+#include <sys/stat.h>
+#endif
+
+bool RecipeStore::Begin(){
+#ifdef ARDUINO_ARCH_ESP32
+    // LittleFS goes into the VFS at the base path, so the files can be used with the C file functions
+    return LittleFS.begin(true, this->basePath);
+#else
+    struct stat info;
+    return mkdir(this->basePath, 0755) == 0 || (stat(this->basePath, &info) == 0 && S_ISDIR(info.st_mode));
+#endif
+}
+
+bool RecipeStore::BeginUpload(int32_t slot){
+    if(this->IsUploading()){
+        return false;
+    }
+    char path[RECIPE_PATH_LENGTH];
+    this->getPath(slot, "tmp", path);
+    this->uploadFile = fopen(path, "w");
+    this->uploadSlot = slot;
+    this->uploadLength = 0;
+    return this->uploadFile != NULL;
+}
+
+bool RecipeStore::Write(const GCodeDefinitions::GCode &command){
+    if(!this->IsUploading()){
+        return false;
+    }
+    char line[RECIPE_LINE_LENGTH];
+    uint16_t length = GCodeParser::Format(command, line, sizeof(line));
+    if(length == 0 || fprintf(this->uploadFile, "!%s;\n", line) < 0){
+        return false;
+    }
+    this->uploadLength++;
+    return true;
+}
+
+int32_t RecipeStore::EndUpload(){
+    if(!this->IsUploading()){
+        return -1;
+    }
+    bool isSaved = fclose(this->uploadFile) == 0;
+    this->uploadFile = NULL;
+
+    // only now does the new recipe replace the old one
+    char uploadPath[RECIPE_PATH_LENGTH];
+    char recipePath[RECIPE_PATH_LENGTH];
+    this->getPath(this->uploadSlot, "tmp", uploadPath);
+    this->getPath(this->uploadSlot, "gcode", recipePath);
+    remove(recipePath);
+    if(!isSaved || rename(uploadPath, recipePath) != 0){
+        remove(uploadPath);
+        return -1;
+    }
+    return this->uploadLength;
+}
+
+void RecipeStore::AbortUpload(){
+    if(!this->IsUploading()){
+        return;
+    }
+    fclose(this->uploadFile);
+    this->uploadFile = NULL;
+    char uploadPath[RECIPE_PATH_LENGTH];
+    this->getPath(this->uploadSlot, "tmp", uploadPath);
+    remove(uploadPath);
+}
+
+FILE * RecipeStore::Open(int32_t slot){
+    char path[RECIPE_PATH_LENGTH];
+    this->getPath(slot, "gcode", path);
+    return fopen(path, "r");
+}
+
+FILE * RecipeStore::OpenCompiled(int32_t slot){
+    char path[RECIPE_PATH_LENGTH];
+    this->getPath(slot, "seg", path);
+    return fopen(path, "rb");
+}
+
+void RecipeStore::getPath(int32_t slot, const char *extension, char *path){
+    snprintf(path, RECIPE_PATH_LENGTH, "%s/recipe_%ld.%s", this->basePath, static_cast<long>(slot), extension);
+}
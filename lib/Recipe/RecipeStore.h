@@ -0,0 +1,114 @@
+/**
+ * @file RecipeStore.h
+ * @brief This file contains the RecipeStore class
+ * @details This file contains the RecipeStore class which keeps recipes in flash so they can be run without a host.
+ * Each recipe is kept in its own numbered slot as a file of "!COMMAND,X###,...;" lines, the same as the
+ * recipes that are streamed over serial. On the ESP32 the files are on LittleFS. When building for anything
+ * else they are in a directory on the host, so uploads and playback can be tested there.
+ * @version 1.0.0
+ * @author Quinn Henthorne. Contact: quinn.henthorne@gmail.com
+*/
+
+#ifndef RECIPE_STORE_H
+#define RECIPE_STORE_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include "GCODE-DEFINITIONS.h"
+
+// where the recipe files are kept
+#ifdef ARDUINO_ARCH_ESP32
+#define RECIPE_STORE_PATH "/littlefs"
+#else
+#define RECIPE_STORE_PATH "recipes"
+#endif
+
+// the longest path to a recipe file
+#define RECIPE_PATH_LENGTH 64
+
+// the longest line in a recipe file
+#define RECIPE_LINE_LENGTH 128
+
+class RecipeStore{
+    public:
+        /**
+         * @brief Construct a new Recipe Store object
+         * @param basePath The directory the recipe files go in
+        */
+        RecipeStore(const char *basePath = RECIPE_STORE_PATH) : basePath(basePath){}
+
+        /**
+         * @brief Mount the filesystem, formatting it if it has never been used
+         * @return true if recipes can be stored
+        */
+        bool Begin();
+
+        /**
+         * @brief Start writing a recipe
+         * @param slot The slot to put the recipe in
+         * @return true if the upload started. False if another upload is going or the file couldn't be made
+         * @note The recipe in the slot is only replaced when the upload is finished
+        */
+        bool BeginUpload(int32_t slot);
+
+        /**
+         * @brief Add a command to the end of the recipe being uploaded
+         * @param command The command to add
+         * @return true if the command was written
+        */
+        bool Write(const GCodeDefinitions::GCode &command);
+
+        /**
+         * @brief Finish the upload and put the recipe in its slot
+         * @return The number of commands in the recipe. -1 if there wasn't an upload or it couldn't be saved
+        */
+        int32_t EndUpload();
+
+        /**
+         * @brief Throw away the recipe being uploaded. The recipe already in the slot is kept
+        */
+        void AbortUpload();
+
+        /**
+         * @brief Returns true if a recipe is being uploaded
+         * @return true if a recipe is being uploaded
+        */
+        bool IsUploading(){ return uploadFile != NULL; }
+
+        /**
+         * @brief Returns the slot being uploaded to
+         * @return The slot. Only valid while IsUploading() is true
+        */
+        int32_t GetUploadSlot(){ return uploadSlot; }
+
+        /**
+         * @brief Open a recipe to run it
+         * @param slot The slot the recipe is in
+         * @return The file, or NULL if there isn't a recipe in the slot. The caller closes it
+        */
+        FILE * Open(int32_t slot);
+
+        /**
+         * @brief Open a compiled recipe to run it
+         * @param slot The slot the recipe is in
+         * @return The file, or NULL if there isn't a compiled recipe in the slot. The caller closes it
+         * @note Compiled recipes are made by the recipe compiler and put on the filesystem as recipe_<slot>.seg
+        */
+        FILE * OpenCompiled(int32_t slot);
+
+    private:
+        const char *basePath;
+        FILE *uploadFile{NULL}; // the file being uploaded to. NULL if there isn't an upload
+        int32_t uploadSlot{0};
+        int32_t uploadLength{0}; // the number of commands written to the upload
+
+        /**
+         * @brief Work out the path to a recipe file
+         * @param slot The slot of the recipe
+         * @param extension The extension of the file, so an upload can go somewhere else until it is done
+         * @param path Where to write the path. It must be RECIPE_PATH_LENGTH long
+        */
+        void getPath(int32_t slot, const char *extension, char *path);
+};
+
+#endif // RECIPE_STORE_H
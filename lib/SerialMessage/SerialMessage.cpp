@@ -9,10 +9,17 @@
 #include "SerialMessage.h"
 
 SerialMessage::SerialMessage(HardwareSerial *serial) :
-    serial(serial){}
+    serial(serial),
+    hardwareSerial(serial){}
+
+SerialMessage::SerialMessage(Stream *stream) :
+    serial(stream),
+    hardwareSerial(NULL){}
 
 void SerialMessage::Init(unsigned int baud_rate){
-    this->serial->begin(baud_rate);
+    if(this->hardwareSerial != NULL){
+        this->hardwareSerial->begin(baud_rate);
+    }
 }
 
 void SerialMessage::readSerial(){
@@ -27,6 +34,7 @@ void SerialMessage::readSerial(){
         if (recvInProgress == true) {
             if (c == endMarker) {
                 data[ndx] = '\0'; // terminate the string
+                dataLength = ndx;
                 recvInProgress = false;
                 ndx = 0;
                 data_recieved = true;
@@ -51,6 +59,9 @@ void SerialMessage::readSerial(){
 }
 
 void SerialMessage::parseData() {      // split the data into its parts
+    // this temporary copy is necessary to protect the original data
+    //   because strtok() replaces the commas with \0
+    strcpy(temp_data, data);
     this->populated_args = 0; // reset the populated args counter
     char * indx; // this is used by strtok() as an index
     int i = 0;
@@ -64,15 +75,16 @@ void SerialMessage::parseData() {      // split the data into its parts
 }
 
 void SerialMessage::Update(){
-    readSerial();
-    if (data_recieved == true) {
+    // parse every message that's waiting, up to a limit so one busy port can't hold up the others
+    for(uint8_t i = 0; i < SERIAL_MESSAGE_MAX_PER_UPDATE; i++){
+        readSerial();
+        if (data_recieved == false) {
+            break;
+        }
         // for debug only:
         // Serial.print("Received:");
         // Serial.print(data);
         // Serial.println(":End");
-        strcpy(temp_data, data);
-        // this temporary copy is necessary to protect the original data
-        //   because strtok() used in parseData() replaces the commas with \0
         parseData();
         //PrintArgs();
         data_recieved = false;
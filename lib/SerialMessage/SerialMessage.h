@@ -13,6 +13,9 @@
 
 #define num_chars 500
 
+// the most messages parsed in one update
+#define SERIAL_MESSAGE_MAX_PER_UPDATE 16
+
 class SerialMessage{
     public:
         /**
@@ -20,6 +23,13 @@ class SerialMessage{
          */
         SerialMessage(HardwareSerial *serial = &Serial);
 
+        /**
+         * @brief Construct a new Serial Message object that reads from any stream, like a network client
+         * @param stream The stream to read messages from and send replies to
+         * @note Init() does nothing for a stream, it has to be started by whatever owns it
+         */
+        SerialMessage(Stream *stream);
+
         /**
          * @brief Initialize the SerialMessage object
          */
@@ -27,6 +37,7 @@ class SerialMessage{
 
         /**
          * @brief Update the SerialMessage object and parse any data that's available
+         * @note Every message that has arrived is parsed, up to SERIAL_MESSAGE_MAX_PER_UPDATE
          */
         void Update();
 
@@ -74,14 +85,16 @@ class SerialMessage{
         char data[num_chars]; // an array to store the received data
         char temp_data[num_chars]; // an array that will be used with strtok()
         uint16_t ndx = 0;
+        uint16_t dataLength = 0; // the length of the string in data
         const static int args_length = 30;
         int populated_args = 0; // the number of args that have been populated for the current message
         int args[args_length];
         const char startMarker = '!';
         const char endMarker = ';';
+        Stream *serial; // where messages are read from and replies are sent
     
     private:
-        HardwareSerial *serial;
+        HardwareSerial *hardwareSerial; // the serial port to start in Init(). NULL if the stream isn't a serial port
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,84 @@
+/**
+ * @file PtySerial.cpp
+ * @brief This file contains the PtySerial class implimentation
+ * @version 1.0.0
+ * @author Quinn Henthorne. Contact: quinn.henthorne@gmail.com
+*/
+
+#include "PtySerial.h"
+#include <fcntl.h>
+#include <stdlib.h>
+#include <termios.h>
+#include <unistd.h>
+
+bool PtySerial::Begin(const char *linkPath){
+    this->controller = posix_openpt(O_RDWR | O_NOCTTY);
+    if(this->controller < 0){
+        return false;
+    }
+    if(grantpt(this->controller) != 0 || unlockpt(this->controller) != 0){
+        this->End();
+        return false;
+    }
+    this->path = ptsname(this->controller);
+
+    this->device = open(this->path.c_str(), O_RDWR | O_NOCTTY);
+    if(this->device < 0){
+        this->End();
+        return false;
+    }
+    struct termios settings;
+    tcgetattr(this->device, &settings);
+    cfmakeraw(&settings);
+    tcsetattr(this->device, TCSANOW, &settings);
+    fcntl(this->controller, F_SETFL, fcntl(this->controller, F_GETFL) | O_NONBLOCK);
+
+    if(linkPath != NULL){
+        unlink(linkPath);
+        if(symlink(this->path.c_str(), linkPath) != 0){
+            this->End();
+            return false;
+        }
+        this->linkPath = linkPath;
+    }
+    return true;
+}
+
+void PtySerial::End(){
+    if(!this->linkPath.empty()){
+        unlink(this->linkPath.c_str());
+        this->linkPath.clear();
+    }
+    if(this->device >= 0){
+        close(this->device);
+        this->device = -1;
+    }
+    if(this->controller >= 0){
+        close(this->controller);
+        this->controller = -1;
+    }
+}
+
+void PtySerial::Update(){
+    if(this->controller < 0){
+        return;
+    }
+
+    uint8_t buffer[PTY_SERIAL_READ_LENGTH];
+    ssize_t length = read(this->controller, buffer, sizeof(buffer));
+    if(length > 0){
+        this->port->Receive(buffer, length);
+    }
+
+    this->pending += this->port->TakeTransmitted();
+    if(this->pending.empty()){
+        return;
+    }
+    ssize_t written = write(this->controller, this->pending.data(), this->pending.size());
+    if(written > 0){
+        this->pending.erase(0, written);
+    }
+    if(this->pending.size() > NATIVE_SERIAL_BUFFER_LENGTH){
+        this->pending.erase(0, this->pending.size() - NATIVE_SERIAL_BUFFER_LENGTH);
+    }
+}
@@ -0,0 +1,62 @@
+/**
+ * @file PtySerial.h
+ * @brief This file contains the PtySerial class
+ * @details A PtySerial connects a mock HardwareSerial to a pseudo-terminal, so a program on the PC can open it
+ * like the coater's serial port. The pseudo-terminal is raw, so bytes go through it untouched.
+ * @version 1.0.0
+ * @author Quinn Henthorne. Contact: quinn.henthorne@gmail.com
+*/
+
+#ifndef PTY_SERIAL_H
+#define PTY_SERIAL_H
+
+#include <string>
+#include "Arduino.h"
+
+// the most bytes read from the pseudo-terminal each update
+#define PTY_SERIAL_READ_LENGTH 256
+
+class PtySerial{
+    public:
+        /**
+         * @brief Construct a new Pty Serial object
+         * @param port The mock serial port to connect
+        */
+        PtySerial(HardwareSerial *port) : port(port){}
+        ~PtySerial(){ End(); }
+
+        /**
+         * @brief Open the pseudo-terminal
+         * @param linkPath A path to make a link to the pseudo-terminal at, so it is always in the same place. Can be NULL
+         * @return true if the pseudo-terminal was opened
+        */
+        bool Begin(const char *linkPath = NULL);
+
+        /**
+         * @brief Close the pseudo-terminal and remove its link
+        */
+        void End();
+
+        /**
+         * @brief Pass what was written to the pseudo-terminal to the port, and what the port sent to the pseudo-terminal
+         * @note Nothing waits. If nothing has the pseudo-terminal open, what the port sends is kept until it's full
+         * and then the oldest is dropped
+        */
+        void Update();
+
+        /**
+         * @brief Get the path of the pseudo-terminal
+         * @return The path, like /dev/pts/3
+        */
+        const char * GetPath(){ return path.c_str(); }
+
+    private:
+        HardwareSerial *port;
+        int controller{-1}; // our end of the pseudo-terminal
+        int device{-1}; // the end programs open. It is held open so reads don't fail while nothing else has it
+        std::string path;
+        std::string linkPath;
+        std::string pending; // sent by the port, waiting for room in the pseudo-terminal
+};
+
+#endif // PTY_SERIAL_H
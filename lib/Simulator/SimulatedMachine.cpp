@@ -0,0 +1,72 @@
+/**
+ * @file SimulatedMachine.cpp
+ * @brief This file contains the SimulatedMachine class implimentation
+ * @version 1.0.0
+ * @author Quinn Henthorne. Contact: quinn.henthorne@gmail.com
+*/
+
+#include "SimulatedMachine.h"
+#include "MACHINE-PARAMETERS.h"
+
+// the axis the carriage moves on. Only it can hit a switch
+#define CARRIAGE_AXIS MachineAxisIndex('X')
+static_assert(CARRIAGE_AXIS < MACHINE_AXIS_COUNT, "The simulated machine needs an X axis for the carriage");
+
+void SimulatedMachine::Begin(){
+    #define SIMULATED_AXIS_CONFIGURATION(letter, configuration, maxJerk) &configuration,
+    const StepperMotorConfiguration *const configurations[MACHINE_AXIS_COUNT] = {MACHINE_AXES(SIMULATED_AXIS_CONFIGURATION)};
+    #undef SIMULATED_AXIS_CONFIGURATION
+    for(uint8_t i = 0; i < MACHINE_AXIS_COUNT; i++){
+        this->axes[i] = {configurations[i], 0};
+        getDevice(this->axes[i].configuration->stepPin.i2cPort)->SetListener(onOutputWrite, this);
+    }
+    this->updateInputs();
+}
+
+void SimulatedMachine::SetEStop(bool isPressed){
+    this->isEStopPressed = isPressed;
+    this->updateInputs();
+}
+
+float SimulatedMachine::GetPosition(uint8_t axis){
+    float position = this->axes[axis].steps / this->axes[axis].configuration->stepsPerUnit;
+    if(axis == CARRIAGE_AXIS){
+        position += this->linearStartPosition;
+    }
+    return position;
+}
+
+void SimulatedMachine::onOutputWrite(uint8_t value, uint8_t previous, void *context){
+    SimulatedMachine *machine = static_cast<SimulatedMachine *>(context);
+    bool isLinearStepped = false;
+    for(uint8_t i = 0; i < MACHINE_AXIS_COUNT; i++){
+        Axis &axis = machine->axes[i];
+        const StepperMotorConfiguration &configuration = *axis.configuration;
+        // the driver steps on the rising edge, when the pin goes back high after the firmware pulled it low
+        uint8_t stepMask = 1 << configuration.stepPin.number;
+        if((previous & stepMask) != 0 || (value & stepMask) == 0){
+            continue;
+        }
+        bool directionLevel = (value >> configuration.directionPin.number) & 1;
+        axis.steps += directionLevel != configuration.invertDirection ? 1 : -1;
+        isLinearStepped |= i == CARRIAGE_AXIS;
+    }
+    // only the carriage can hit a switch
+    if(isLinearStepped){
+        machine->updateInputs();
+    }
+}
+
+void SimulatedMachine::updateInputs(){
+    float position = this->GetPosition(CARRIAGE_AXIS);
+    bool triggered = LIMIT_SWITCH_TRIGGERED_STATE;
+    getDevice(HOME_STOP_PIN.i2cPort)->SetInput(HOME_STOP_PIN.number, position <= HOME_SWITCH_POSITION ? triggered : !triggered);
+    getDevice(ENDSTOP_1_PIN.i2cPort)->SetInput(ENDSTOP_1_PIN.number, position <= ENDSTOP_1_POSITION ? triggered : !triggered);
+    getDevice(ENDSTOP_2_PIN.i2cPort)->SetInput(ENDSTOP_2_PIN.number, position >= ENDSTOP_2_POSITION ? triggered : !triggered);
+    // the estop input is pulled low while the button is out
+    getDevice(ESTOP_PIN.i2cPort)->SetInput(ESTOP_PIN.number, this->isEStopPressed);
+}
+
+PCF8574Device * SimulatedMachine::getDevice(I2CPort *port){
+    return static_cast<PCF8574Device *>(I2C_BUS.GetDevice(port->GetAddress()));
+}
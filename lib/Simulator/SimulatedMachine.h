@@ -0,0 +1,84 @@
+/**
+ * @file SimulatedMachine.h
+ * @brief This file contains the SimulatedMachine class
+ * @details The simulated machine sits behind the mock PCF8574s. It moves a motor every time its step pin is pulsed,
+ * in the direction its direction pin says, and drives the endstop and estop inputs from where the carriage is.
+ * The carriage doesn't have to start at zero, so homing finds the home switch the same way it does on the coater.
+ * @version 1.0.0
+ * @author Quinn Henthorne. Contact: quinn.henthorne@gmail.com
+*/
+
+#ifndef SIMULATED_MACHINE_H
+#define SIMULATED_MACHINE_H
+
+#include <stdint.h>
+#include "StepperMotorConfiguration.h"
+#include "PCF8574.h"
+#include "MACHINE-AXES.h"
+
+class SimulatedMachine{
+    public:
+        /**
+         * @brief Construct a new Simulated Machine object
+         * @param linearStartPosition Where the carriage is when the machine is turned on, in mm. The carriage is the X axis
+        */
+        SimulatedMachine(float linearStartPosition = 0) : linearStartPosition(linearStartPosition){}
+
+        /**
+         * @brief Connect the machine to the mock expanders, and set the inputs to match where the carriage is
+         * @note This must be called before setup()
+        */
+        void Begin();
+
+        /**
+         * @brief Press or release the estop button
+         * @param isPressed true if the button is pressed
+        */
+        void SetEStop(bool isPressed);
+
+        /**
+         * @brief Get where a motor is
+         * @param axis The motor, in the order MACHINE_AXES lists them
+         * @return The position in units. The carriage's position includes where it started
+        */
+        float GetPosition(uint8_t axis);
+
+        /**
+         * @brief Get the number of steps a motor has taken in each direction, added up
+         * @param axis The motor, in the order MACHINE_AXES lists them
+         * @return The steps
+        */
+        int32_t GetSteps(uint8_t axis){ return axes[axis].steps; }
+
+    private:
+        struct Axis{
+            const StepperMotorConfiguration *configuration;
+            int32_t steps;
+        };
+
+        const float linearStartPosition;
+        Axis axes[MACHINE_AXIS_COUNT];
+        bool isEStopPressed{false};
+
+        /**
+         * @brief Watch an output expander for step pulses
+         * @param value The new value of the pins
+         * @param previous The value of the pins before the write
+         * @param context The machine
+        */
+        static void onOutputWrite(uint8_t value, uint8_t previous, void *context);
+
+        /**
+         * @brief Set the endstop and estop inputs to match the machine
+        */
+        void updateInputs();
+
+        /**
+         * @brief Get the simulated chip behind a port
+         * @param port The port
+         * @return The chip
+        */
+        static PCF8574Device * getDevice(I2CPort *port);
+};
+
+#endif // SIMULATED_MACHINE_H
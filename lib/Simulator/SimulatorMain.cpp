@@ -0,0 +1,124 @@
+/**
+ * @file SimulatorMain.cpp
+ * @brief This file contains the entry point of the simulator build
+ * @details The simulator runs the whole firmware, setup() and loop() as they are, against a simulated machine.
+ * Serial and Serial2 are pseudo-terminals, so host software can open them like the coater's ports.
+ * Time can run with the PC's clock, a number of times faster, or in fixed steps per loop as fast as the PC can go.
+ * The GCode server listens on 127.0.0.1.
+ * Usage: program [--serial PATH] [--serial2 PATH] [--port PORT] [--speed N | --step US] [--start MM]
+ * SIGUSR1 presses the estop button, and releases it the next time.
+ * @version 1.0.0
+ * @author Quinn Henthorne. Contact: quinn.henthorne@gmail.com
+*/
+
+#ifdef SIMULATOR
+
+#include "Arduino.h"
+#include "PtySerial.h"
+#include "SimulatedMachine.h"
+#include "LoopbackSocket.h"
+#include <getopt.h>
+#include <signal.h>
+#include <stdio.h>
+
+void setup();
+void loop();
+
+static volatile sig_atomic_t isRunning = 1;
+static volatile sig_atomic_t isEStopPressed = 0;
+
+static void stop(int signal){
+    isRunning = 0;
+}
+
+static void toggleEStop(int signal){
+    // the same signal presses and releases the button
+    isEStopPressed = !isEStopPressed;
+}
+
+int main(int argc, char **argv){
+    const char *serialLink = NULL;
+    const char *serial2Link = NULL;
+    float speed = 1.0f;
+    uint32_t step = 0;
+    float start = 0;
+    uint16_t port = 0;
+
+    static const struct option options[] = {
+        {"serial", required_argument, NULL, 'u'},
+        {"serial2", required_argument, NULL, 'd'},
+        {"speed", required_argument, NULL, 's'},
+        {"step", required_argument, NULL, 't'},
+        {"start", required_argument, NULL, 'x'},
+        {"port", required_argument, NULL, 'p'},
+        {NULL, 0, NULL, 0}
+    };
+    int option;
+    while((option = getopt_long(argc, argv, "", options, NULL)) != -1){
+        switch(option){
+            case 'u': serialLink = optarg; break;
+            case 'd': serial2Link = optarg; break;
+            case 's': speed = atof(optarg); break;
+            case 't': step = atoi(optarg); break;
+            case 'x': start = atof(optarg); break;
+            case 'p': port = atoi(optarg); break;
+            default:
+                fprintf(stderr, "Usage: %s [--serial PATH] [--serial2 PATH] [--port PORT] [--speed N | --step US] [--start MM]\n", argv[0]);
+                return 2;
+        }
+    }
+
+    // the server is made with its port before main() runs, so a different one is given before it starts
+    LoopbackServer::SetPortOverride(port);
+
+    SimulatedMachine machine(start);
+    machine.Begin();
+
+    PtySerial usbSerial(&Serial);
+    PtySerial displaySerial(&Serial2);
+    if(!usbSerial.Begin(serialLink) || !displaySerial.Begin(serial2Link)){
+        perror("Could not open the pseudo-terminals");
+        return 1;
+    }
+    fprintf(stderr, "Serial is %s\nSerial2 is %s\n", usbSerial.GetPath(), displaySerial.GetPath());
+
+    signal(SIGINT, stop);
+    signal(SIGTERM, stop);
+    signal(SIGUSR1, toggleEStop);
+
+    // a fixed step per loop is exact, since every timer goes off when it's due. A faster clock can miss some
+    if(step > 0){
+        VirtualClock::Set(0);
+    }
+    else{
+        VirtualClock::RunInRealTime(speed);
+    }
+
+    setup();
+    bool isEStopApplied = false;
+    while(isRunning){
+        if(isEStopPressed != isEStopApplied){
+            isEStopApplied = isEStopPressed;
+            machine.SetEStop(isEStopApplied);
+        }
+        usbSerial.Update();
+        displaySerial.Update();
+        loop();
+        if(step > 0){
+            VirtualClock::Advance(step);
+        }
+        else{
+            VirtualClock::RunTimers();
+        }
+    }
+    usbSerial.Update();
+
+    fprintf(stderr, "Stopped at %.3fs.", VirtualClock::Now() / 1e6);
+    for(uint8_t i = 0; i < MACHINE_AXIS_COUNT; i++){
+        fprintf(stderr, " %c%.3f", MACHINE_AXIS_LETTERS[i], machine.GetPosition(i));
+    }
+    fprintf(stderr, "\n");
+    return 0;
+}
+
+#endif // SIMULATOR
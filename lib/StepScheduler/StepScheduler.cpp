@@ -0,0 +1,115 @@
+/**
+ * @file StepScheduler.cpp
+ * @brief This file contains the StepScheduler class implimentation
+ * @version 1.0.0
+ * @author Quinn Henthorne. Contact: quinn.henthorne@gmail.com
+*/
+
+#include "StepScheduler.h"
+
+StepScheduler *StepScheduler::instance = NULL;
+
+void StepScheduler::Begin(){
+    instance = this;
+    this->ResetStatistics();
+
+#ifdef ARDUINO_ARCH_ESP32
+    this->mutex = xSemaphoreCreateMutex();
+    xTaskCreatePinnedToCore(
+        stepTask,
+        "step",
+        STEP_SCHEDULER_TASK_STACK_SIZE,
+        this,
+        STEP_SCHEDULER_TASK_PRIORITY,
+        &this->taskHandle,
+        STEP_SCHEDULER_TASK_CORE
+    );
+#endif
+
+    this->timer.Begin(this->GetPeriod(), onTimer);
+}
+
+void StepScheduler::Lock(){
+#ifdef ARDUINO_ARCH_ESP32
+    xSemaphoreTake(this->mutex, portMAX_DELAY);
+#endif
+}
+
+void StepScheduler::Unlock(){
+#ifdef ARDUINO_ARCH_ESP32
+    xSemaphoreGive(this->mutex);
+#endif
+}
+
+void StepScheduler::RunTick(){
+    uint32_t now = micros();
+    uint32_t period = this->timer.GetPeriod();
+    // the timer never wakes us early, so anything past the expected time is lateness
+    uint32_t lateness = now - this->expectedTickTime;
+    if(static_cast<int32_t>(lateness) < 0){
+        lateness = 0;
+    }
+    if(lateness > this->maxLateness){
+        this->maxLateness = lateness;
+    }
+    this->tickLateness.Record(lateness);
+    this->expectedTickTime += period;
+    // if we've fallen a whole period behind, start counting from now again
+    if(lateness >= period){
+        this->missedTicks++;
+        this->expectedTickTime = now + period;
+    }
+    this->tickCount++;
+
+    this->Lock();
+    bool hasBurst = false;
+    if(this->paused){
+        this->waveform->Pause();
+    }
+    else{
+        hasBurst = this->waveform->Generate();
+    }
+    this->Unlock();
+
+    if(hasBurst){
+        uint32_t start = CycleTimer::Now();
+        this->waveform->Send();
+        this->burstTime.RecordSince(start);
+    }
+}
+
+void StepScheduler::ResetStatistics(){
+    this->expectedTickTime = micros() + this->GetPeriod();
+    this->maxLateness = 0;
+    this->tickCount = 0;
+    this->missedTicks = 0;
+    this->tickLateness.Reset();
+    this->burstTime.Reset();
+}
+
+#ifdef ARDUINO_ARCH_ESP32
+
+void IRAM_ATTR StepScheduler::onTimer(){
+    BaseType_t higherPriorityTaskWoken = pdFALSE;
+    vTaskNotifyGiveFromISR(instance->taskHandle, &higherPriorityTaskWoken);
+    if(higherPriorityTaskWoken == pdTRUE){
+        portYIELD_FROM_ISR();
+    }
+}
+
+void StepScheduler::stepTask(void *parameter){
+    StepScheduler *scheduler = static_cast<StepScheduler *>(parameter);
+    while(true){
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        scheduler->RunTick();
+    }
+}
+
+#else
+
+void StepScheduler::onTimer(){
+    // there is no task on the native build, so the tick runs inline when the mock timer fires
+    instance->RunTick();
+}
+
+#endif
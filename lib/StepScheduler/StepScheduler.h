@@ -0,0 +1,153 @@
+/**
+ * @file StepScheduler.h
+ * @brief This file contains the StepScheduler class
+ * @details This file contains the StepScheduler class which owns step emission for every motor in a StepWaveform.
+ * A hardware timer wakes a high priority task once per burst, so step timing no longer depends on how long
+ * the main loop takes. The main loop only commands the motors, and must hold the scheduler's lock while it does.
+ * @version 1.0.0
+ * @author Quinn Henthorne. Contact: quinn.henthorne@gmail.com
+*/
+
+#ifndef STEP_SCHEDULER_H
+#define STEP_SCHEDULER_H
+
+#include <Arduino.h>
+#include "StepTimer.h"
+#include "StepWaveform.h"
+#include "Histogram.h"
+
+// the priority and core of the step task. The Arduino loop runs on core 1 at priority 1
+#define STEP_SCHEDULER_TASK_PRIORITY (configMAX_PRIORITIES - 1)
+#define STEP_SCHEDULER_TASK_CORE 1
+#define STEP_SCHEDULER_TASK_STACK_SIZE 4096
+// the one byte transactions the bus is left free for every tick, so the main loop's input reads and flushes
+// still get through while the motors are moving
+#define STEP_SCHEDULER_FREE_TRANSACTIONS 2
+
+class StepScheduler{
+    public:
+        /**
+         * @brief Construct a new Step Scheduler object
+         * @param waveform The waveform to generate and send every tick
+         * @param timerNumber The hardware timer to use
+        */
+        StepScheduler(StepWaveform *waveform, uint8_t timerNumber = 0) :
+            waveform(waveform),
+            timer(timerNumber){}
+
+        /**
+         * @brief Start the step task and the timer
+         * @note The motors and the waveform must be initialized before this is called.
+         * Only one scheduler can be running at a time.
+        */
+        void Begin();
+
+        /**
+         * @brief Take the lock on the motors
+         * @note Hold this while changing anything the step task reads: motor targets, speeds, positions
+         * and pins on the waveform's port. Don't talk to the I2C bus while holding it.
+        */
+        void Lock();
+
+        /**
+         * @brief Release the lock on the motors
+        */
+        void Unlock();
+
+        /**
+         * @brief Stop or start sending steps
+         * @param paused True to hold every motor where it is
+        */
+        void SetPaused(bool paused){ this->paused = paused; }
+
+        /**
+         * @brief Generate and send one burst of steps and record how late it was
+         * @note This is called by the step task. It is public so a mock timer can run the scheduler inline
+        */
+        void RunTick();
+
+        /**
+         * @brief Get the timer that drives the scheduler
+         * @return A pointer to the timer. On the native build this can be fired by hand
+        */
+        StepTimer * GetTimer(){ return &timer; }
+
+        /**
+         * @brief Get the time between ticks
+         * @return The period in microseconds
+         * @note A burst holds the bus for longer than it is on the pins, since the address, start and stop go out too.
+         * The period covers that and leaves room for STEP_SCHEDULER_FREE_TRANSACTIONS more, so the step task never
+         * hogs the bus. The waveform counts the time between bursts, so the step rates are kept
+        */
+        uint32_t GetPeriod(){
+            return this->waveform->GetTransactionDuration(STEP_WAVEFORM_BURST_LENGTH)
+                + STEP_SCHEDULER_FREE_TRANSACTIONS * this->waveform->GetTransactionDuration(1);
+        }
+
+        /**
+         * @brief Get the latest a tick has started since the statistics were reset
+         * @return The maximum lateness in microseconds
+        */
+        uint32_t GetMaxLateness(){ return maxLateness; }
+
+        /**
+         * @brief Get how late the ticks have started
+         * @return The histogram of tick lateness since the statistics were reset
+        */
+        Histogram * GetTickLateness(){ return &tickLateness; }
+
+        /**
+         * @brief Get how long each burst took to send over I2C
+         * @return The histogram of burst times since the statistics were reset
+        */
+        Histogram * GetBurstTime(){ return &burstTime; }
+
+        /**
+         * @brief Get the number of ticks since the statistics were reset
+         * @return The number of ticks
+        */
+        uint32_t GetTickCount(){ return tickCount; }
+
+        /**
+         * @brief Get the number of ticks that were a whole period late since the statistics were reset
+         * @return The number of missed ticks
+        */
+        uint32_t GetMissedTicks(){ return missedTicks; }
+
+        /**
+         * @brief Reset the jitter statistics
+        */
+        void ResetStatistics();
+
+    private:
+        StepWaveform *waveform;
+        StepTimer timer;
+        volatile bool paused{false};
+
+        uint32_t expectedTickTime{0}; // the time the next tick should start in microseconds
+        uint32_t maxLateness{0};
+        uint32_t tickCount{0};
+        uint32_t missedTicks{0};
+        Histogram tickLateness;
+        Histogram burstTime;
+
+#ifdef ARDUINO_ARCH_ESP32
+        TaskHandle_t taskHandle{NULL};
+        SemaphoreHandle_t mutex{NULL};
+
+        /**
+         * @brief The step task. Waits for the timer and runs a tick
+         * @param parameter A pointer to the scheduler
+        */
+        static void stepTask(void *parameter);
+#endif
+
+        /**
+         * @brief The timer callback. Wakes the step task
+        */
+        static void onTimer();
+
+        static StepScheduler *instance; // the scheduler the timer wakes up
+};
+
+#endif // STEP_SCHEDULER_H
@@ -0,0 +1,57 @@
+/**
+ * @file StepTimer.cpp
+ * @brief This file contains the StepTimer class implimentation
+ * @version 1.0.0
+ * @author Quinn Henthorne. Contact: quinn.henthorne@gmail.com
+*/
+
+#include "StepTimer.h"
+
+#ifdef ARDUINO_ARCH_ESP32
+
+void StepTimer::Begin(uint32_t period, void (*callback)()){
+    this->period = period;
+    this->callback = callback;
+#if ESP_ARDUINO_VERSION_MAJOR >= 3
+    // count in microseconds
+    this->timer = timerBegin(1000000);
+    timerAttachInterrupt(this->timer, callback);
+    timerAlarm(this->timer, period, true, 0);
+#else
+    // the timers run off the 80MHz APB clock, so a divider of 80 counts in microseconds
+    this->timer = timerBegin(this->timerNumber, 80, true);
+    timerAttachInterrupt(this->timer, callback, true);
+    timerAlarmWrite(this->timer, period, true);
+    timerAlarmEnable(this->timer);
+#endif
+}
+
+void StepTimer::End(){
+    if(this->timer == NULL){
+        return;
+    }
+    timerEnd(this->timer);
+    this->timer = NULL;
+}
+
+#else
+
+void StepTimer::Begin(uint32_t period, void (*callback)()){
+    this->period = period;
+    this->callback = callback;
+    this->timer = VirtualClock::AddTimer(period, callback);
+}
+
+void StepTimer::End(){
+    VirtualClock::RemoveTimer(this->timer);
+    this->timer = -1;
+    this->callback = NULL;
+}
+
+void StepTimer::Fire(){
+    if(this->callback != NULL){
+        this->callback();
+    }
+}
+
+#endif
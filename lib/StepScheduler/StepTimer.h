@@ -0,0 +1,62 @@
+/**
+ * @file StepTimer.h
+ * @brief This file contains the StepTimer class
+ * @details This file contains the StepTimer class which calls a function at a fixed period from a hardware timer interrupt.
+ * When building for anything other than the ESP32 the timer runs off the native VirtualClock, so it goes off
+ * at exact times when the clock is advanced by hand. It can also be fired directly with Fire().
+ * @version 1.0.0
+ * @author Quinn Henthorne. Contact: quinn.henthorne@gmail.com
+*/
+
+#ifndef STEP_TIMER_H
+#define STEP_TIMER_H
+
+#include <Arduino.h>
+
+class StepTimer{
+    public:
+        /**
+         * @brief Construct a new Step Timer object
+         * @param timerNumber The hardware timer to use (0-3 on the ESP32)
+        */
+        StepTimer(uint8_t timerNumber = 0) : timerNumber(timerNumber){}
+
+        /**
+         * @brief Start the timer
+         * @param period The time between callbacks in microseconds
+         * @param callback The function to call every period. On the ESP32 this is called from an interrupt,
+         * so it must be in IRAM and must not block
+        */
+        void Begin(uint32_t period, void (*callback)());
+
+        /**
+         * @brief Stop the timer
+        */
+        void End();
+
+        /**
+         * @brief Get the period of the timer
+         * @return The period in microseconds
+        */
+        uint32_t GetPeriod(){ return period; }
+
+#ifndef ARDUINO_ARCH_ESP32
+        /**
+         * @brief Run the callback as if the timer alarm went off
+         * @note This only exists on the mock timer
+        */
+        void Fire();
+#endif
+
+    private:
+        const uint8_t timerNumber;
+        uint32_t period{0};
+        void (*callback)(){NULL};
+#ifdef ARDUINO_ARCH_ESP32
+        hw_timer_t *timer{NULL};
+#else
+        int8_t timer{-1}; // the virtual clock's timer
+#endif
+};
+
+#endif // STEP_TIMER_H
@@ -0,0 +1,189 @@
+/**
+ * @file StepWaveform.cpp
+ * @brief This file contains the StepWaveform class implimentation
+ * @version 1.0.0
+ * @author Quinn Henthorne. Contact: quinn.henthorne@gmail.com
+*/
+
+#include "StepWaveform.h"
+#include <Arduino.h>
+
+bool StepWaveform::AddMotor(StepperMotor *motor){
+    if(this->motorCount == STEP_WAVEFORM_MAX_MOTORS || motor->GetI2CPort() != this->port){
+        return false;
+    }
+
+    this->motors[this->motorCount] = motor;
+    this->motorCount++;
+    return true;
+}
+
+void StepWaveform::Init(){
+    // work out which of our motors the planner steps, and where their step pins are
+    this->plannerMotors = 0;
+    if(this->planner != NULL){
+        for(uint8_t axis = 0; axis < MOTION_PLANNER_AXES; axis++){
+            StepperMotor *motor = this->planner->GetMotor(axis);
+            this->plannerStepMasks[axis] = motor->GetStepPinMask();
+            for(uint8_t i = 0; i < this->motorCount; i++){
+                if(this->motors[i] == motor){
+                    this->plannerMotors |= 1 << i;
+                    this->plannerMotorIndexes[axis] = i;
+                }
+            }
+        }
+    }
+
+    this->lastImage = this->port->GetShadow();
+    this->waveformEndTime = micros();
+}
+
+void StepWaveform::Update(){
+    if(this->Generate()){
+        this->Send();
+    }
+}
+
+bool StepWaveform::Generate(){
+    // changes from moves that were thrown away are made before anything else
+    if(this->planner != NULL){
+        uint8_t image = this->port->GetShadow();
+        this->applyPlannerEvent(image);
+    }
+
+    bool isMoving = this->planner != NULL && !this->planner->IsEmpty();
+    for(uint8_t i = 0; i < this->motorCount; i++){
+        isMoving |= this->motors[i]->IsMoving();
+    }
+
+    if(!isMoving){
+        this->Pause();
+        return false;
+    }
+
+    // the bus was idle between the end of the last burst and now, so count that time too to keep the average step rate.
+    // The last burst's own slots were counted when it was generated, so the time it took to send isn't counted again.
+    // If it is still going out, the next one carries straight on from it
+    uint32_t now = micros();
+    uint32_t idleTime = now - this->waveformEndTime;
+    if(static_cast<int32_t>(idleTime) < 0){
+        idleTime = 0;
+        now = this->waveformEndTime;
+    }
+    for(uint8_t i = 0; i < this->motorCount; i++){
+        this->motors[i]->AdvanceTime(idleTime);
+    }
+    if(this->planner != NULL){
+        this->planner->AdvanceTime(idleTime);
+    }
+
+    this->generateBurst();
+    this->waveformEndTime = now + this->GetBurstDuration();
+    return true;
+}
+
+void StepWaveform::Pause(){
+    // a step pin that was left low goes back high with the direction it was pulled low with, before any new one goes out
+    uint8_t image = this->holdDirections(this->port->GetShadow(), this->lastImage);
+    if(image != this->port->GetShadow()){
+        this->port->WriteBurst(&image, 1);
+    }
+    this->port->Flush();
+    this->lastImage = this->port->GetShadow();
+    this->waveformEndTime = micros();
+}
+
+void StepWaveform::Send(){
+    // this blocks until the whole burst is on the pins
+    this->port->WriteBurst(this->images, STEP_WAVEFORM_BURST_LENGTH);
+}
+
+void StepWaveform::generatePlannerSlot(uint8_t &image, uint8_t previousImage){
+    this->planner->AdvanceTime(this->slotLength);
+    if(!this->planner->IsStepDue()){
+        return;
+    }
+
+    // every axis might step on a master step, so they all have to be ready first
+    for(uint8_t axis = 0; axis < MOTION_PLANNER_AXES; axis++){
+        if(!this->canStep(this->planner->GetMotor(axis), image, previousImage)){
+            return;
+        }
+    }
+
+    uint32_t lateness = this->planner->GetStepLateness();
+    uint8_t steppedAxes = this->planner->Step();
+    for(uint8_t axis = 0; axis < MOTION_PLANNER_AXES; axis++){
+        if(steppedAxes & (1 << axis)){
+            image &= ~this->plannerStepMasks[axis];
+            this->stepLateness[this->plannerMotorIndexes[axis]].Record(lateness);
+        }
+    }
+    this->applyPlannerEvent(image);
+}
+
+void StepWaveform::applyPlannerEvent(uint8_t &image){
+    MotionEvent event = this->planner->TakeEvent();
+    if(event.IsEmpty()){
+        return;
+    }
+    this->port->WriteMask(event.setMask, HIGH);
+    this->port->WriteMask(event.clearMask, LOW);
+    image = (image | event.setMask) & ~event.clearMask;
+}
+
+uint8_t StepWaveform::holdDirections(uint8_t image, uint8_t previousImage){
+    for(uint8_t i = 0; i < this->motorCount; i++){
+        StepperMotor *motor = this->motors[i];
+        if((previousImage & motor->GetStepPinMask()) == 0){
+            uint8_t directionMask = motor->GetDirectionPinMask();
+            image = (image & ~directionMask) | (previousImage & directionMask);
+        }
+    }
+    return image;
+}
+
+bool StepWaveform::canStep(StepperMotor *motor, uint8_t image, uint8_t previousImage){
+    // the step pin has to go back high for at least one image before the next step
+    if((previousImage & motor->GetStepPinMask()) == 0){
+        return false;
+    }
+    // and a new direction has to be on the pin for a whole image before the step starts
+    return ((image ^ previousImage) & motor->GetDirectionPinMask()) == 0;
+}
+
+void StepWaveform::generateBurst(){
+    uint8_t previousImage = this->lastImage;
+
+    for(uint8_t slot = 0; slot < STEP_WAVEFORM_BURST_LENGTH; slot++){
+        // starting a planned move can change direction pins, so this is read every slot
+        uint8_t image = this->holdDirections(this->port->GetShadow(), previousImage);
+        bool plannerIsRunning = this->planner != NULL && this->planner->IsRunning();
+        for(uint8_t i = 0; i < this->motorCount; i++){
+            // the planner steps its own motors while it's running a move
+            if(plannerIsRunning && (this->plannerMotors & (1 << i))){
+                continue;
+            }
+            StepperMotor *motor = this->motors[i];
+            motor->AdvanceTime(this->slotLength);
+            if(!this->canStep(motor, image, previousImage)){
+                continue;
+            }
+
+            // steps are taken on the rising edge, so pull the pin low for this image
+            if(motor->IsStepDue()){
+                image &= ~motor->GetStepPinMask();
+                this->stepLateness[i].Record(motor->GetStepLateness());
+                motor->RecordStep();
+            }
+        }
+        if(this->planner != NULL){
+            this->generatePlannerSlot(image, previousImage);
+        }
+
+        this->images[slot] = image;
+        previousImage = image;
+    }
+
+    this->lastImage = previousImage;
+}
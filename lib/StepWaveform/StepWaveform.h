@@ -0,0 +1,176 @@
+/**
+ * @file StepWaveform.h
+ * @brief This file contains the StepWaveform class
+ * @details This file contains the StepWaveform class which turns the planned steps of every motor on an
+ * I2C port into a sequence of port images and streams them to the expander as one long I2C write.
+ * Each image is held on the pins for one byte time on the bus, so the I2C clock is the step timebase.
+ * Pin changes tied to the end of a planned move go out in the same image as the move's last step.
+ * A direction change waits until the motor's step pin is back high, and the motor doesn't step in the image it goes out in.
+ * @version 1.0.0
+ * @author Quinn Henthorne. Contact: quinn.henthorne@gmail.com
+*/
+
+#ifndef STEP_WAVEFORM_H
+#define STEP_WAVEFORM_H
+
+#include "I2CPort.h"
+#include "StepperMotor.h"
+#include "MotionPlanner.h"
+#include "Histogram.h"
+
+// The number of port images sent in one I2C transaction. The ESP32 Wire buffer is 128 bytes.
+// At 100kHz one burst is 32 * 90us = 2.88ms of waveform.
+#define STEP_WAVEFORM_BURST_LENGTH 32
+// The maximum number of motors that can share one waveform
+#define STEP_WAVEFORM_MAX_MOTORS 4
+// The number of bus clock cycles it takes to send one byte to the expander (8 data bits and an ack)
+#define STEP_WAVEFORM_CLOCKS_PER_IMAGE 9
+// The bus clock cycles every transaction takes on top of its data: the start, the address byte and the stop
+#define STEP_WAVEFORM_TRANSACTION_OVERHEAD_CLOCKS (1 + STEP_WAVEFORM_CLOCKS_PER_IMAGE + 1)
+
+class StepWaveform{
+    public:
+        /**
+         * @brief Construct a new Step Waveform object
+         * @param port The I2C port all of the step pins are on
+         * @param busFrequency The I2C bus clock frequency in Hz
+        */
+        StepWaveform(I2CPort *port, uint32_t busFrequency) :
+            port(port),
+            busFrequency(busFrequency),
+            slotLength(STEP_WAVEFORM_CLOCKS_PER_IMAGE * 1000000UL / busFrequency){}
+
+        /**
+         * @brief Add a motor to the waveform
+         * @param motor The motor to add
+         * @return true if the motor was added. False if there is no room or the motor's step pin is on a different port
+        */
+        bool AddMotor(StepperMotor *motor);
+
+        /**
+         * @brief Set the planner that feeds moves to the motors
+         * @param planner The planner. Its motors must have been added to this waveform. While it is running a move,
+         * the planner steps them every slot instead of the motors stepping themselves
+         * @note This must be called before Init()
+        */
+        void SetPlanner(MotionPlanner *planner){ this->planner = planner; }
+
+        /**
+         * @brief Initialize the waveform timing
+         * @note This function must be called after the motors have been initialized
+        */
+        void Init();
+
+        /**
+         * @brief Generate the next burst of steps for every motor and send it to the expander
+         * @note This function must be called in the main loop instead of StepperMotor::Update().
+         * If no motor is moving, the port is just flushed.
+        */
+        void Update();
+
+        /**
+         * @brief Generate the next burst of steps without sending it
+         * @return true if there is a burst to send. False if no motor is moving, in which case the port has been flushed
+         * @note This is the part of Update() that touches the motors, so it is the only part that needs to be
+         * protected when the motors are commanded from another task
+        */
+        bool Generate();
+
+        /**
+         * @brief Flush the port without stepping any motors
+         * @note The time spent paused doesn't count towards the motors' next steps
+        */
+        void Pause();
+
+        /**
+         * @brief Send the last generated burst to the expander
+         * @note This blocks until the whole burst is on the pins
+        */
+        void Send();
+
+        /**
+         * @brief Get the time each port image is held on the pins
+         * @return The length of one image in microseconds
+        */
+        uint32_t GetSlotLength(){ return slotLength; }
+
+        /**
+         * @brief Get the time one burst is on the pins
+         * @return The length of one burst in microseconds
+        */
+        uint32_t GetBurstDuration(){ return slotLength * STEP_WAVEFORM_BURST_LENGTH; }
+
+        /**
+         * @brief Get the time one transaction holds the bus
+         * @param length The number of bytes written or read
+         * @return The length of the transaction in microseconds, rounded up
+         * @note This is longer than the bytes alone, since the address, start and stop go out too.
+         * A whole burst is GetTransactionDuration(STEP_WAVEFORM_BURST_LENGTH)
+        */
+        uint32_t GetTransactionDuration(uint8_t length){
+            uint32_t clocks = STEP_WAVEFORM_TRANSACTION_OVERHEAD_CLOCKS + STEP_WAVEFORM_CLOCKS_PER_IMAGE * length;
+            return (clocks * 1000000UL + busFrequency - 1) / busFrequency;
+        }
+
+        /**
+         * @brief Get how late the steps of a motor have been
+         * @param motor The motor, in the order they were added
+         * @return The histogram of the time from when each step was due to the slot it was put in
+         * @note A step can be held back by the one before it, since the pin has to go back high first,
+         * or by a burst starting late
+        */
+        Histogram * GetStepLateness(uint8_t motor){ return &stepLateness[motor]; }
+
+    private:
+        I2CPort *port;
+        StepperMotor *motors[STEP_WAVEFORM_MAX_MOTORS];
+        uint8_t motorCount{0};
+        MotionPlanner *planner{NULL};
+        uint8_t plannerMotors{0}; // bit n is set if motor n belongs to the planner
+        uint8_t plannerStepMasks[MOTION_PLANNER_AXES]; // the step pin mask of each planner axis
+        uint8_t plannerMotorIndexes[MOTION_PLANNER_AXES]; // the motor each planner axis is
+        Histogram stepLateness[STEP_WAVEFORM_MAX_MOTORS];
+        uint8_t images[STEP_WAVEFORM_BURST_LENGTH];
+        uint8_t lastImage{0xFF}; // the last image of the previous burst
+        const uint32_t busFrequency; // the I2C bus clock frequency in Hz
+        const uint32_t slotLength; // the time one image is held on the pins in microseconds
+        uint32_t waveformEndTime{0}; // the time the last generated burst is done on the pins in microseconds, counted from when it was generated
+
+        /**
+         * @brief Take a master step of the planner's running move in one slot, if one is due
+         * @param image The image for this slot. The step pins of the axes that step are pulled low
+         * @param previousImage The image of the slot before this one
+        */
+        void generatePlannerSlot(uint8_t &image, uint8_t previousImage);
+
+        /**
+         * @brief Make the planner's pin changes that are due
+         * @param image The image they go out in. They are written to the port too, so they stay after this burst
+        */
+        void applyPlannerEvent(uint8_t &image);
+
+        /**
+         * @brief Keep the direction pins of the motors that are mid step the way they were
+         * @param image The image for this slot
+         * @param previousImage The image of the slot before this one
+         * @return The image with the direction pin of every motor whose step pin was low in the previous image put back.
+         * The driver reads the direction on the rising edge, so it can't change until the pin has gone back high
+        */
+        uint8_t holdDirections(uint8_t image, uint8_t previousImage);
+
+        /**
+         * @brief Check if a motor can be pulled low for a step in this slot
+         * @param motor The motor
+         * @param image The image for this slot
+         * @param previousImage The image of the slot before this one
+         * @return true if its step pin is back high and its direction pin hasn't just changed
+        */
+        bool canStep(StepperMotor *motor, uint8_t image, uint8_t previousImage);
+
+        /**
+         * @brief Fill the image buffer with the next burst of steps
+        */
+        void generateBurst();
+};
+
+#endif // STEP_WAVEFORM_H
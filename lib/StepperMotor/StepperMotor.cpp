@@ -9,89 +9,258 @@
 #include "StepperMotor.h"
 #include <Arduino.h>
 
+StepperMotor::StepperMotor(const StepperMotorConfiguration &configuration) :
+    i2cPort(configuration.stepPin.i2cPort),
+    configuration(configuration){
+    // the ramp and the speed limits were worked out when the configuration was built
+    this->ResetRamp();
+}
+
 void StepperMotor::Init(){
-    this->i2cPort->write(this->configuration.enablePin.number, HIGH);
-    this->i2cPort->write(this->configuration.directionPin.number, LOW);
-    this->i2cPort->write(this->configuration.stepPin.number, HIGH);
+    this->i2cPort->WriteMask(this->configuration.enableMask, HIGH);
+    this->i2cPort->WriteMask(this->configuration.directionMask, LOW);
+    this->i2cPort->WriteMask(this->configuration.stepMask, HIGH);
+    this->i2cPort->Flush();
 
     this->timeOfLastStep = micros();
 }
 
-void StepperMotor::SetSpeed(float speed) {
-    speed = static_cast<uint32_t>(abs(speed));
-    // convert units per minute to steps per microsecond
-    this->period = 60 * 1000000 / (speed * this->configuration.stepsPerUnit);
+void StepperMotor::SetSpeed(uint32_t speed) {
+    // anything over the max speed is cut down first, which also keeps the product from overflowing
+    if(speed > this->configuration.maxSpeedUnits){
+        speed = this->configuration.maxSpeedUnits;
+    }
+    // convert units per minute to fixed point steps per second with the conversion worked out at compile time
+    uint64_t stepRate = static_cast<uint64_t>(speed) * this->configuration.speedToStepRate;
+    stepRate = (stepRate + (1ULL << (SPEED_TO_STEP_RATE_FRACTION_BITS - 1))) >> SPEED_TO_STEP_RATE_FRACTION_BITS;
+    this->SetStepRate(stepRate > UINT32_MAX ? UINT32_MAX : static_cast<uint32_t>(stepRate));
+}
+
+void StepperMotor::SetStepRate(uint32_t stepRate){
+    if(stepRate > this->configuration.maxStepRate){
+        stepRate = this->configuration.maxStepRate;
+    }
+    this->stepRate = stepRate;
+    // the interval is 1000000 / rate us, with the fractional bits of both taken into account.
+    // A rate of 0 never steps
+    this->cruiseInterval = UINT32_MAX;
+    if(stepRate != 0){
+        uint64_t interval = ((1000000ULL << (STEP_RATE_FRACTION_BITS + RAMP_FRACTION_BITS)) + stepRate / 2) / stepRate;
+        this->cruiseInterval = interval > UINT32_MAX ? UINT32_MAX : static_cast<uint32_t>(interval);
+        // the rate was limited above, but rounding can still put the interval a hair under the bound
+        if(this->cruiseInterval < this->configuration.minStepInterval){
+            this->cruiseInterval = this->configuration.minStepInterval;
+        }
+    }
+
+    // if we're already going faster than the new speed, drop straight down to it
+    if(this->rampStep != 0 && this->stepInterval < this->cruiseInterval){
+        this->stepInterval = this->cruiseInterval;
+    }
+    if(this->rampStep == 0){
+        this->ResetRamp();
+    }
 }
 
 void StepperMotor::updateDirectionPin(){
-    uint8_t motorIsReversed = this->configuration.invertDirection ? 1 : -1;
+    int8_t previousDirection = this->direction;
+    // the step count always goes towards the target. The pin level takes care of the motor being inverted
     // set direction to move forward
     if(this->targetSteps > this->currentSteps){
-        this->direction = motorIsReversed;
-        this->i2cPort->write(this->configuration.directionPin.number, !(this->configuration.invertDirection));
+        this->direction = 1;
+        this->i2cPort->WriteMask(this->configuration.directionMask, !(this->configuration.invertDirection));
     // set direction to move backward
     } else {
-        this->direction = -motorIsReversed;
-        this->i2cPort->write(this->configuration.directionPin.number, (this->configuration.invertDirection));
+        this->direction = -1;
+        this->i2cPort->WriteMask(this->configuration.directionMask, (this->configuration.invertDirection));
+    }
+
+    // we can't carry our speed through a change of direction
+    if(this->direction != previousDirection){
+        this->ResetRamp();
     }
 
 }
 
 void StepperMotor::SetTargetPosition(int32_t position) {
+    this->SetTargetSteps(this->UnitsToSteps(position));
+}
+
+void StepperMotor::SetTargetSteps(int32_t steps){
     // check if a maximum travel has been set
     if(this->maxTravel != 0){
         // minimum travel is always 0, so we only care about the maximum travel
         // if the target position is greater than the maximum travel, set it to the maximum travel
-        if(position > this->maxTravel){
-            position = this->maxTravel;
+        int32_t maxTravelSteps = this->UnitsToSteps(this->maxTravel);
+        if(steps > maxTravelSteps){
+            steps = maxTravelSteps;
         }
     }
 
-    this->targetSteps = position * this->configuration.stepsPerUnit;
+    this->targetSteps = steps;
     this->updateDirectionPin();
 }
 
+void StepperMotor::Stop(){
+    this->targetSteps = this->currentSteps;
+    this->ResetRamp();
+}
+
 void StepperMotor::SetCurrentPosition(int32_t position) {
-    this->currentSteps = position * this->configuration.stepsPerUnit;
+    this->currentSteps = this->UnitsToSteps(position);
     this->updateDirectionPin();
 }
 
 void StepperMotor::Update() {
-    // if we are within 5 steps of the target position, stop
-    if(abs(this->targetSteps - this->currentSteps) < 5){
+    if(!this->IsMoving()){
         return;
     }
 
-    uint32_t timeSinceLastStep = micros() - this->timeOfLastStep;
-    // do one step if it is time
-    if(timeSinceLastStep >= this->period){
-        this->currentSteps += this->direction;
-        this->i2cPort->write(this->configuration.stepPin.number, LOW);
-        this->i2cPort->write(this->configuration.stepPin.number, HIGH);
-        this->timeOfLastStep = micros();
+    uint32_t now = micros();
+    this->AdvanceTime(now - this->timeOfLastStep);
+    this->timeOfLastStep = now;
+    // do one step if it is time. The step pin is pulled low on the next flush of the port
+    // and goes back high on the flush after that, which is when the driver sees the step.
+    // If the last pulse hasn't been released yet we try again next update.
+    if(this->IsStepDue() && this->i2cPort->PulseMask(this->configuration.stepMask, LOW)){
+        this->RecordStep();
+    }
+}
+
+void StepperMotor::AdvanceTime(uint32_t elapsed){
+    // stop counting once a step is due, which keeps the fixed point clock of an idle motor from overflowing.
+    // A due step that hasn't been taken is late, so that time goes on the lateness instead
+    if(this->stepClock >= this->stepInterval){
+        if(this->IsStepDue()){
+            this->stepLateness = elapsed > UINT32_MAX - this->stepLateness ? UINT32_MAX : this->stepLateness + elapsed;
+        }
+        return;
+    }
+    uint64_t stepClock = this->stepClock + (static_cast<uint64_t>(elapsed) << RAMP_FRACTION_BITS);
+    this->stepClock = stepClock > UINT32_MAX ? UINT32_MAX : static_cast<uint32_t>(stepClock);
+    if(this->stepClock >= this->stepInterval){
+        this->stepLateness = (this->stepClock - this->stepInterval) >> RAMP_FRACTION_BITS;
     }
 }
 
+bool StepperMotor::IsStepDue(){
+    // a motor without a speed never steps on its own
+    return this->IsMoving() && this->stepRate != 0 && this->stepClock >= this->stepInterval;
+}
+
+void StepperMotor::RecordStep(){
+    this->currentSteps += this->direction;
+    this->stepLateness = 0;
+    uint32_t interval = this->stepInterval;
+    this->updateRamp();
+    // keep the leftover time so we don't lose any rate, but don't try to catch up on more than one step
+    this->stepClock -= interval;
+    if(this->stepClock >= this->stepInterval){
+        this->stepClock = 0;
+    }
+}
+
+void StepperMotor::updateRamp(){
+    uint32_t cruiseInterval = this->cruiseInterval;
+    // no acceleration configured, so just run at the commanded speed
+    if(this->configuration.rampStartInterval == 0){
+        this->stepInterval = cruiseInterval;
+        return;
+    }
+
+    int32_t stepsToGo = abs(this->targetSteps - this->currentSteps);
+    if(!this->IsMoving()){
+        this->ResetRamp();
+        return;
+    }
+
+    // accelerating from a stop takes the same number of steps as stopping again,
+    // so once the steps we have left reach the steps we've accelerated for, start slowing down
+    if(this->rampStep > 0 && this->rampStep >= stepsToGo){
+        this->rampStep = -this->rampStep;
+    }
+
+    // we're going as slow as the ramp goes, so start accelerating again
+    if(this->rampStep == 0){
+        this->ResetRamp();
+        if(this->stepInterval != cruiseInterval){
+            this->rampStep++;
+        }
+        return;
+    }
+
+    int32_t nextInterval = static_cast<int32_t>(this->stepInterval) - (2 * static_cast<int32_t>(this->stepInterval)) / (4 * this->rampStep + 1);
+    // we've reached the cruise speed, so stay there without counting up the ramp
+    if(this->rampStep > 0 && static_cast<uint32_t>(nextInterval) <= cruiseInterval){
+        this->stepInterval = cruiseInterval;
+        return;
+    }
+
+    this->stepInterval = static_cast<uint32_t>(nextInterval);
+    this->rampStep++;
+}
+
+void StepperMotor::ResetRamp(){
+    this->rampStep = 0;
+    uint32_t cruiseInterval = this->cruiseInterval;
+    // never start slower than the cruise speed
+    uint32_t rampStartInterval = this->configuration.rampStartInterval;
+    if(rampStartInterval == 0 || rampStartInterval < cruiseInterval){
+        this->stepInterval = cruiseInterval;
+    }
+    else{
+        this->stepInterval = rampStartInterval;
+    }
+}
+
+void StepperMotor::CountStep(){
+    this->currentSteps += this->direction;
+}
+
+bool StepperMotor::IsMoving(){
+    // every step is accounted for, so we only stop when we're exactly at the target
+    return this->targetSteps != this->currentSteps;
+}
+
+I2CPort * StepperMotor::GetI2CPort(){
+    return this->i2cPort;
+}
+
 void StepperMotor::SetEnabled(bool enabled) {
-    this->i2cPort->write(this->configuration.enablePin.number, enabled);
+    this->i2cPort->WriteMask(this->configuration.enableMask, enabled);
 }
 
 
 int32_t StepperMotor::GetCurrentPosition(){
-    return this->currentSteps / this->configuration.stepsPerUnit;
+    return this->StepsToUnits(this->currentSteps);
 }
 
 int32_t StepperMotor::GetTargetPosition(){
-    return this->targetSteps / this->configuration.stepsPerUnit;
+    return this->StepsToUnits(this->targetSteps);
+}
+
+int32_t StepperMotor::UnitsToSteps(int32_t units){
+    // work with the magnitude so the result rounds towards 0 either way
+    uint64_t magnitude = units < 0 ? -static_cast<int64_t>(units) : units;
+    int64_t steps = static_cast<int64_t>((magnitude * this->configuration.fixedStepsPerUnit) >> STEP_RATE_FRACTION_BITS);
+    return static_cast<int32_t>(units < 0 ? -steps : steps);
+}
+
+int32_t StepperMotor::StepsToUnits(int32_t steps){
+    // multiplying by the reciprocal is exact for whole steps per unit, since the reciprocal is rounded up
+    uint64_t magnitude = steps < 0 ? -static_cast<int64_t>(steps) : steps;
+    int64_t units = static_cast<int64_t>((magnitude * this->configuration.unitsPerStep) >> UNITS_PER_STEP_FRACTION_BITS);
+    return static_cast<int32_t>(steps < 0 ? -units : units);
 }
 
 uint32_t StepperMotor::GetSpeed(){
-    if(this->period == 0){
+    uint32_t stepsPerUnit = this->configuration.fixedStepsPerUnit;
+    if(stepsPerUnit == 0){
         return 0;
     }
-    float floatPeriod = static_cast<float>(period);
-    float floatStepsPerUnit = static_cast<float>(configuration.stepsPerUnit);
-    return static_cast<uint32_t>(60.0f * 1000000.0f / (floatPeriod * floatStepsPerUnit));
+    // both are fixed point with the same fractional bits, so they cancel out
+    uint64_t stepsPerMinute = static_cast<uint64_t>(this->stepRate) * 60;
+    return static_cast<uint32_t>((stepsPerMinute + stepsPerUnit / 2) / stepsPerUnit);
 }
 
 void StepperMotor::SetMaxTravel(int32_t maxTravel){
@@ -9,7 +9,7 @@
 #ifndef STEPPER_MOTOR_H
 #define STEPPER_MOTOR_H
 
-#include <PCF8574.h>
+#include "I2CPort.h"
 #include "StepperMotorConfiguration.h"
 
 class StepperMotor {
@@ -19,9 +19,7 @@ class StepperMotor {
          * @param I2CPort A pointer to the I2C handler
          * @param configuration The configuration of the motor
         */
-        StepperMotor(StepperMotorConfiguration &configuration) :
-            i2cPort(configuration.stepPin.i2cPort),
-            configuration(configuration){}
+        StepperMotor(const StepperMotorConfiguration &configuration);
 
         /**
          * @brief Initialize the stepper motor
@@ -31,10 +29,23 @@ class StepperMotor {
         /**
          * @brief Set the speed of the motor
          * @param speed The speed of the motor in unites per minute
-         * @note This function currently just changes the maximum speed, so if the 
-         * acceleration is low, you will see slow speed changes
+         * @note This sets the cruise speed of the move. The motor ramps up to it and back down
+         * at the configured acceleration, so if the acceleration is low, you will see slow speed changes.
+         * Speeds over the configured max speed run at the max speed
         */
-        void SetSpeed(float speed);
+        void SetSpeed(uint32_t speed);
+
+        /**
+         * @brief Set the speed of the motor as a step rate
+         * @param stepRate The step rate in steps per second with STEP_RATE_FRACTION_BITS fractional bits
+         * @note This doesn't use any floats. Rates over the configured max speed run at the max speed
+        */
+        void SetStepRate(uint32_t stepRate);
+
+        /**
+         * @brief Start the acceleration ramp again from a stop
+        */
+        void ResetRamp();
 
         /**
          * @brief Set the target position of the motor
@@ -42,6 +53,18 @@ class StepperMotor {
         */
         void SetTargetPosition(int32_t position);
 
+        /**
+         * @brief Set the target position of the motor in steps
+         * @param steps The target position in steps. Unlike SetTargetPosition() this isn't rounded to a whole unit
+        */
+        void SetTargetSteps(int32_t steps);
+
+        /**
+         * @brief Stop the motor on the step it's on
+         * @note Unlike setting the target to the current position, this isn't rounded to a whole unit
+        */
+        void Stop();
+
         /**
          * @brief Set the current position of the motor
          * @param position The current position of the motor
@@ -50,9 +73,74 @@ class StepperMotor {
 
         /**
          * @brief Incriments the motor given the current position and the target position
+         * @note Pin changes are buffered in the motor's I2CPort, so the port must be flushed after this is called
         */
         void Update();
 
+        /**
+         * @brief Advance the motor's step clock
+         * @param elapsed The time that has passed in microseconds
+         * @note This is used instead of Update() when something other than micros() is the timebase for stepping.
+         * The clock stops once a step is due, so a motor that is waiting doesn't build up time to catch up on
+        */
+        void AdvanceTime(uint32_t elapsed);
+
+        /**
+         * @brief Returns true if the motor should take a step now
+         * @return true if the motor isn't at its target and a full step interval has passed since its last step
+        */
+        bool IsStepDue();
+
+        /**
+         * @brief Record that a step has been sent to the driver
+         * @note Use this with AdvanceTime() and IsStepDue(). The step clock keeps the time past the interval,
+         * including the fraction of a microsecond, so the average step rate matches the speed exactly
+        */
+        void RecordStep();
+
+        /**
+         * @brief Get how long the step that is due has been waiting
+         * @return The time past when the step was due in microseconds
+         * @note Call this before RecordStep(), which clears it
+        */
+        uint32_t GetStepLateness(){ return stepLateness; }
+
+        /**
+         * @brief Count a step that something else timed, without touching the motor's own step clock or ramp
+         * @note This is used when the motor is one axis of a coordinated move
+        */
+        void CountStep();
+
+        /**
+         * @brief Returns true if the motor hasn't reached its target position
+         * @return true if the motor is moving
+        */
+        bool IsMoving();
+
+        /**
+         * @brief Returns the bit of the step pin in the motor's I2C port
+         * @return The step pin mask
+        */
+        uint8_t GetStepPinMask(){ return configuration.stepMask; }
+
+        /**
+         * @brief Returns the bit of the direction pin in the motor's I2C port
+         * @return The direction pin mask
+        */
+        uint8_t GetDirectionPinMask(){ return configuration.directionMask; }
+
+        /**
+         * @brief Returns the configuration of the motor
+         * @return The configuration of the motor
+        */
+        const StepperMotorConfiguration & GetConfiguration(){ return configuration; }
+
+        /**
+         * @brief Returns the I2C port the motor is connected to
+         * @return A pointer to the I2C port
+        */
+        I2CPort * GetI2CPort();
+
         /**
          * @brief disable/enable the motor
          * @param enabled True to enable the motor, false to disable the motor
@@ -71,36 +159,87 @@ class StepperMotor {
         */
         int32_t GetTargetPosition();
 
+        /**
+         * @brief Returns the current position of the motor in steps
+         * @return The current position in steps
+        */
+        int32_t GetCurrentSteps(){ return currentSteps; }
+
+        /**
+         * @brief Returns the target position of the motor in steps
+         * @return The target position in steps. Unlike GetTargetPosition() this isn't rounded to a whole unit
+        */
+        int32_t GetTargetSteps(){ return targetSteps; }
+
+        /**
+         * @brief Convert a position to steps
+         * @param units The position in units
+         * @return The position in steps, rounded towards 0
+        */
+        int32_t UnitsToSteps(int32_t units);
+
+        /**
+         * @brief Convert steps to a position
+         * @param steps The position in steps
+         * @return The position in units, rounded towards 0
+        */
+        int32_t StepsToUnits(int32_t steps);
+
         /**
          * @brief Returns the speed of the motor
-         * @return The speed of the motor
+         * @return The speed of the motor in units per minute, rounded to the nearest unit
          */
         uint32_t GetSpeed();
 
+        /**
+         * @brief Returns the commanded step rate of the motor
+         * @return The step rate in steps per second with STEP_RATE_FRACTION_BITS fractional bits
+        */
+        uint32_t GetStepRate(){ return stepRate; }
+
         /**
          * @brief Set the max travel of the motor
          * @param maxTravel The max travel of the motor in units
         */
         void SetMaxTravel(int32_t maxTravel);
 
+        /**
+         * @brief Returns the max travel of the motor
+         * @return The max travel in units. 0 if there is no max travel
+        */
+        int32_t GetMaxTravel(){ return maxTravel; }
+
 
 
     
     private:
-        PCF8574* i2cPort;
+        I2CPort* i2cPort;
         StepperMotorConfiguration configuration;
 
         /**
          * @brief Updates the direction pin
         */
         void updateDirectionPin();
+
+        /**
+         * @brief Work out the interval until the next step so the motor follows a trapezoidal velocity profile
+         * @note This must be called after every step. It uses the integer approximation of the step delay
+         * from AVR446: c(n) = c(n-1) - 2c(n-1) / (4n + 1). While decelerating n is negative, which makes c grow.
+        */
+        void updateRamp();
     
     protected:
         int32_t currentSteps = 0;
         int32_t targetSteps = 0;
         int8_t direction = 1; // The direction of the motor. 1 for forward, -1 for backward
-        uint32_t period = 0; // The period of the square wave to generate in us/step
-        uint32_t timeOfLastStep = 0; // The time of the last step in microseconds
+        uint32_t stepRate = 0; // The commanded step rate in steps/s with STEP_RATE_FRACTION_BITS fractional bits
+        uint32_t cruiseInterval = UINT32_MAX; // The time between steps at the commanded step rate in 1/256 us
+        uint32_t timeOfLastStep = 0; // The last time Update() advanced the step clock in microseconds
+        uint32_t stepClock = 0; // The time since the last step in 1/256 us. The fraction carries over between steps
+        uint32_t stepLateness = 0; // The time the due step has been waiting in microseconds
+
+        uint32_t stepInterval = 0; // The time until the next step in 1/256 us. This follows the ramp up to the cruise interval
+        int32_t rampStep = 0; // The step number in the ramp. Positive while accelerating, negative while decelerating
         int32_t maxTravel = 0; // If this is 0, there is no max travel.
 };
 
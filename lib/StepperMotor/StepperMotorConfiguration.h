@@ -1,6 +1,26 @@
 #pragma once
+#include <stdint.h>
 #include "I2CPin.h"
 
+// the step intervals in acceleration ramps are fixed point with this many fractional bits
+// so the ramp doesn't stall at high speeds
+#define RAMP_FRACTION_BITS 8
+
+// step rates are fixed point steps per second with this many fractional bits
+#define STEP_RATE_FRACTION_BITS 16
+
+// the reciprocal of the steps per unit is fixed point with this many fractional bits
+#define UNITS_PER_STEP_FRACTION_BITS 32
+
+// the conversion from a speed to a step rate has this many fractional bits more than the step rate
+#define SPEED_TO_STEP_RATE_FRACTION_BITS 16
+
+/**
+ * @brief The configuration of a stepper motor
+ * @details The configuration is constexpr, so everything the motor needs while it steps is worked out here
+ * when the firmware is built. The float fields are only read by the planner and the simulator.
+ * The motor itself only uses the fixed point constants, so it never does float math.
+*/
 struct StepperMotorConfiguration{
     const I2CPin stepPin;
     const I2CPin directionPin;
@@ -10,12 +30,55 @@ struct StepperMotorConfiguration{
     const float acceleration;
     const bool invertDirection = false;
 
-    StepperMotorConfiguration(I2CPin &stepPin, I2CPin &directionPin, I2CPin &enablePin, float stepsPerUnit, float maxSpeed, float acceleration, bool invertDirection) : 
-        stepPin(stepPin), 
-        directionPin(directionPin), 
-        enablePin(enablePin), 
-        stepsPerUnit(stepsPerUnit), 
-        maxSpeed(maxSpeed), 
+    // <------constants worked out from the fields above------->
+    const uint8_t stepMask; // the step pin's bit in its port
+    const uint8_t directionMask; // the direction pin's bit in its port
+    const uint8_t enableMask; // the enable pin's bit in its port
+    const uint32_t fixedStepsPerUnit; // steps per unit with STEP_RATE_FRACTION_BITS fractional bits
+    const uint64_t unitsPerStep; // units per step with UNITS_PER_STEP_FRACTION_BITS fractional bits. Rounded up so whole steps per unit divide exactly
+    const uint64_t speedToStepRate; // the step rate of 1 unit per minute with STEP_RATE_FRACTION_BITS + SPEED_TO_STEP_RATE_FRACTION_BITS fractional bits
+    const uint32_t maxSpeedUnits; // the max speed in whole units per minute, rounded up
+    const uint32_t maxStepRate; // the step rate at the max speed with STEP_RATE_FRACTION_BITS fractional bits
+    const uint32_t minStepInterval; // the time between steps at the max speed in 1/256 us
+    const uint32_t rampStartInterval; // the first step interval when accelerating from a stop in 1/256 us. 0 if there is no acceleration
+
+    constexpr StepperMotorConfiguration(const I2CPin &stepPin, const I2CPin &directionPin, const I2CPin &enablePin, float stepsPerUnit, float maxSpeed, float acceleration, bool invertDirection) :
+        stepPin(stepPin),
+        directionPin(directionPin),
+        enablePin(enablePin),
+        stepsPerUnit(stepsPerUnit),
+        maxSpeed(maxSpeed),
         acceleration(acceleration),
-        invertDirection(invertDirection){}
-};
\ No newline at end of file
+        invertDirection(invertDirection),
+        stepMask(1 << stepPin.number),
+        directionMask(1 << directionPin.number),
+        enableMask(1 << enablePin.number),
+        fixedStepsPerUnit(static_cast<uint32_t>(stepsPerUnit * (1UL << STEP_RATE_FRACTION_BITS) + 0.5f)),
+        unitsPerStep(roundUp(static_cast<double>(1ULL << UNITS_PER_STEP_FRACTION_BITS) / stepsPerUnit)),
+        speedToStepRate(static_cast<uint64_t>(static_cast<double>(stepsPerUnit) / 60.0 * (1ULL << (STEP_RATE_FRACTION_BITS + SPEED_TO_STEP_RATE_FRACTION_BITS)) + 0.5)),
+        maxSpeedUnits(saturate(roundUp(maxSpeed))),
+        // rounded up, so a planned rate at the max speed is never cut short by the bound
+        maxStepRate(saturate(roundUp(static_cast<double>(maxSpeed) * stepsPerUnit / 60.0 * (1UL << STEP_RATE_FRACTION_BITS)))),
+        minStepInterval(maxSpeed <= 0 ? 0 : saturate(1000000.0 * (1UL << RAMP_FRACTION_BITS) / (static_cast<double>(maxSpeed) * stepsPerUnit / 60.0))),
+        // 0.676 corrects for the error in the first step of the approximation
+        rampStartInterval(acceleration <= 0 ? 0 : saturate(0.676 * squareRoot(2.0 / (static_cast<double>(acceleration) * stepsPerUnit / 3600.0)) * 1000000.0 * (1 << RAMP_FRACTION_BITS))){}
+
+    private:
+        static constexpr uint64_t roundUp(double value){
+            uint64_t whole = static_cast<uint64_t>(value);
+            return whole < value ? whole + 1 : whole;
+        }
+
+        static constexpr uint32_t saturate(double value){
+            return value >= static_cast<double>(UINT32_MAX) ? UINT32_MAX : static_cast<uint32_t>(value);
+        }
+
+        // sqrt isn't constexpr, so this is Newton's method. It converges well before the limit for any sane configuration
+        static constexpr double squareRoot(double value){
+            double root = value > 1.0 ? value : 1.0;
+            for(uint8_t i = 0; i < 100; i++){
+                root = (root + value / root) / 2.0;
+            }
+            return root;
+        }
+};
@@ -0,0 +1,48 @@
+/**
+ * @file Log.h
+ * @brief This file contains the log macros, which send a message on Serial if it's at or above the log level
+ * @details The level is picked when the firmware is built, and messages below it are taken out of the code
+ * completely, arguments and all. Release builds default to LOG_LEVEL_INFO and every other build to LOG_LEVEL_DEBUG.
+ * Use -D LOG_LEVEL=LOG_LEVEL_... to pick another. Replies to commands are not log messages and are always sent.
+ * @version 1.0.0
+ * @author Quinn Henthorne. Contact: quinn.henthorne@gmail.com
+*/
+
+#ifndef LOG_H
+#define LOG_H
+
+#include "TxBuffer.h"
+
+#define LOG_LEVEL_NONE 0 // nothing is logged
+#define LOG_LEVEL_ERROR 1 // something went wrong and was thrown away
+#define LOG_LEVEL_INFO 2 // something the operator should know happened, like an endstop being hit
+#define LOG_LEVEL_DEBUG 3 // what the firmware is doing step by step, for working on it
+
+#ifndef LOG_LEVEL
+#ifdef RELEASE
+#define LOG_LEVEL LOG_LEVEL_INFO
+#else
+#define LOG_LEVEL LOG_LEVEL_DEBUG
+#endif
+#endif
+
+// each macro takes a printf format and its arguments, and sends them as one line
+#if LOG_LEVEL >= LOG_LEVEL_ERROR
+#define LOG_ERROR(...) SerialTx.Sendf(__VA_ARGS__)
+#else
+#define LOG_ERROR(...) do{}while(0)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_INFO
+#define LOG_INFO(...) SerialTx.Sendf(__VA_ARGS__)
+#else
+#define LOG_INFO(...) do{}while(0)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_DEBUG
+#define LOG_DEBUG(...) SerialTx.Sendf(__VA_ARGS__)
+#else
+#define LOG_DEBUG(...) do{}while(0)
+#endif
+
+#endif // LOG_H
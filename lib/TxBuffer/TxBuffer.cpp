@@ -0,0 +1,110 @@
+/**
+ * @file TxBuffer.cpp
+ * @brief This file contains the TxBuffer class implimentation
+ * @version 1.0.0
+ * @author Quinn Henthorne. Contact: quinn.henthorne@gmail.com
+*/
+
+#include "TxBuffer.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+TxBuffer SerialTx(&Serial);
+
+static const char lineEnding[] = "\r\n";
+
+bool TxBuffer::Send(const char *line){
+    return this->append(line, strlen(line), lineEnding, sizeof(lineEnding) - 1);
+}
+
+bool TxBuffer::Sendf(const char *format, ...){
+    char record[TX_BUFFER_RECORD_LENGTH];
+    va_list args;
+    va_start(args, format);
+    int length = vsnprintf(record, sizeof(record), format, args);
+    va_end(args);
+    if(length < 0){
+        return false;
+    }
+    if(length >= static_cast<int>(sizeof(record))){
+        length = sizeof(record) - 1;
+    }
+    return this->append(record, length, lineEnding, sizeof(lineEnding) - 1);
+}
+
+size_t TxBuffer::write(uint8_t byte){
+    char character = static_cast<char>(byte);
+    return this->append(&character, 1) ? 1 : 0;
+}
+
+size_t TxBuffer::write(const uint8_t *buffer, size_t size){
+    return this->append(reinterpret_cast<const char *>(buffer), size) ? size : 0;
+}
+
+void TxBuffer::Drain(){
+    if(this->GetLength() == 0){
+        return;
+    }
+    int room = this->output->availableForWrite();
+    if(room <= 0){
+        return;
+    }
+    this->Drain(static_cast<size_t>(room));
+}
+
+void TxBuffer::Drain(size_t room){
+    uint16_t tail = this->tail.load(std::memory_order_relaxed);
+    uint16_t length = this->head.load(std::memory_order_acquire) - tail;
+    if(length == 0){
+        return;
+    }
+    if(length > room){
+        length = room;
+    }
+    // only write up to the end of the buffer. The rest goes on the next pass
+    uint16_t start = tail & (TX_BUFFER_LENGTH - 1);
+    if(length > TX_BUFFER_LENGTH - start){
+        length = TX_BUFFER_LENGTH - start;
+    }
+    size_t written = this->output->write(reinterpret_cast<const uint8_t *>(this->buffer + start), length);
+    this->tail.store(tail + written, std::memory_order_release);
+}
+
+bool TxBuffer::append(const char *first, size_t firstLength, const char *second, size_t secondLength){
+    size_t length = firstLength + secondLength;
+    bool isAdded = false;
+
+#ifdef ARDUINO_ARCH_ESP32
+    portENTER_CRITICAL(&this->lock);
+#endif
+    uint16_t head = this->head.load(std::memory_order_relaxed);
+    uint16_t used = head - this->tail.load(std::memory_order_acquire);
+    if(length <= static_cast<size_t>(TX_BUFFER_LENGTH - used)){
+        this->copyIn(head, first, firstLength);
+        this->copyIn(head + firstLength, second, secondLength);
+        this->head.store(head + length, std::memory_order_release);
+        isAdded = true;
+    }
+    else{
+        this->droppedCount++;
+    }
+#ifdef ARDUINO_ARCH_ESP32
+    portEXIT_CRITICAL(&this->lock);
+#endif
+
+    return isAdded;
+}
+
+void TxBuffer::copyIn(uint16_t position, const char *data, size_t length){
+    if(length == 0){
+        return;
+    }
+    uint16_t start = position & (TX_BUFFER_LENGTH - 1);
+    size_t firstPart = TX_BUFFER_LENGTH - start;
+    if(firstPart > length){
+        firstPart = length;
+    }
+    memcpy(this->buffer + start, data, firstPart);
+    memcpy(this->buffer, data + firstPart, length - firstPart);
+}
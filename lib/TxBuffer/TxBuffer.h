@@ -0,0 +1,125 @@
+/**
+ * @file TxBuffer.h
+ * @brief This file contains the TxBuffer class which sends on a serial port without ever waiting for it
+ * @details Anything sent is copied into a ring buffer and the comms task drains it into the port as fast as the
+ * port's own FIFO has room, so a slow or full port never holds up the motion. Every Send() is one record: it is
+ * added whole or, if there isn't room, dropped whole, so replies from both cores never land in the middle of each
+ * other. Printing through the Print interface is kept for reports that are already formatted in one piece.
+ * @version 1.0.0
+ * @author Quinn Henthorne. Contact: quinn.henthorne@gmail.com
+*/
+
+#ifndef TX_BUFFER_H
+#define TX_BUFFER_H
+
+#include <Arduino.h>
+#include <atomic>
+
+// the bytes the buffer holds. This must be a power of 2. It can be overridden with a build flag
+#ifndef TX_BUFFER_LENGTH
+#define TX_BUFFER_LENGTH 4096
+#endif
+
+// the longest record Sendf() formats. Longer ones are cut short
+#define TX_BUFFER_RECORD_LENGTH 128
+
+class TxBuffer : public Print{
+    // the read and write counters run freely and wrap around, which only lines up with the buffer if the length is a power of 2
+    static_assert(TX_BUFFER_LENGTH > 0 && (TX_BUFFER_LENGTH & (TX_BUFFER_LENGTH - 1)) == 0, "TX_BUFFER_LENGTH must be a power of 2");
+    static_assert(TX_BUFFER_LENGTH <= 32768, "TX_BUFFER_LENGTH must fit in the counters");
+
+    public:
+        /**
+         * @brief Construct a new Tx Buffer object
+         * @param output The port the buffer is drained into
+        */
+        TxBuffer(Print *output) :
+            output(output){}
+
+        /**
+         * @brief Send a line
+         * @param line The line, without its line ending
+         * @return true if it was buffered, false if there wasn't room and it was dropped
+        */
+        bool Send(const char *line);
+
+        /**
+         * @brief Format and send a line, like printf()
+         * @param format The printf format of the line, without its line ending
+         * @return true if it was buffered, false if there wasn't room and it was dropped
+        */
+        bool Sendf(const char *format, ...) __attribute__((format(printf, 2, 3)));
+
+        /**
+         * @brief Write as much of the buffer to the port as it can take without blocking
+         * @note Only one task may drain the buffer
+        */
+        void Drain();
+
+        /**
+         * @brief Write up to a number of bytes of the buffer to the port
+         * @param room The most bytes to write. This is for ports that can't say how much room they have, like a network client
+         * @note Only one task may drain the buffer
+        */
+        void Drain(size_t room);
+
+        /**
+         * @brief Throw away everything waiting to be sent
+         * @note This is for when whoever the buffer was sending to has gone. Only the task draining the buffer may call it
+        */
+        void Clear(){
+            this->tail.store(this->head.load(std::memory_order_acquire), std::memory_order_release);
+        }
+
+        /**
+         * @brief Get how many bytes are waiting to be sent
+         * @return The number of bytes in the buffer
+        */
+        uint16_t GetLength(){
+            return this->head.load(std::memory_order_acquire) - this->tail.load(std::memory_order_acquire);
+        }
+
+        /**
+         * @brief Get how many records have been dropped because the buffer was full
+         * @return The number of dropped records
+        */
+        uint32_t GetDroppedCount(){ return droppedCount; }
+
+        size_t write(uint8_t byte) override;
+        size_t write(const uint8_t *buffer, size_t size) override;
+        using Print::write;
+
+    private:
+        Print *output;
+        char buffer[TX_BUFFER_LENGTH];
+        std::atomic<uint16_t> head{0}; // counts every byte added. Only changed while holding the lock
+        std::atomic<uint16_t> tail{0}; // counts every byte drained. Only changed by the task draining
+        uint32_t droppedCount{0};
+
+#ifdef ARDUINO_ARCH_ESP32
+        portMUX_TYPE lock = portMUX_INITIALIZER_UNLOCKED; // taken just long enough to copy a record in
+#endif
+
+        /**
+         * @brief Add a record to the buffer in one piece
+         * @param first The start of the record
+         * @param firstLength The length of the start
+         * @param second The rest of the record. NULL if there is none
+         * @param secondLength The length of the rest
+         * @return true if it was added, false if there wasn't room for all of it
+        */
+        bool append(const char *first, size_t firstLength, const char *second = NULL, size_t secondLength = 0);
+
+        /**
+         * @brief Copy bytes into the buffer from a write counter on
+         * @param position The write counter to copy to
+         * @param data The bytes to copy
+         * @param length The number of bytes
+        */
+        void copyIn(uint16_t position, const char *data, size_t length);
+};
+
+// everything sent on Serial goes through this, so the main loop never waits on the USB port
+extern TxBuffer SerialTx;
+
+#endif // TX_BUFFER_H
@@ -16,19 +16,53 @@
 // internal libraries
 #include "Endstop.h"
 #include "GCodeMessage.h"
+#include "GCodeServer.h"
 #include "I2CDigitalIO.h"
 #include "MachineState.h"
 #include "StepperMotor.h"
+#include "StepWaveform.h"
+#include "StepScheduler.h"
+#include "MotionPlanner.h"
+#include "MotionSystem.h"
+#include "RecipeStore.h"
+#include "RecipePlayer.h"
+#include "Histogram.h"
+#include "TxBuffer.h"
+#include "Log.h"
+#include "CommsTask.h"
+#include "CommandDispatcher.h"
+#include "MachineSnapshot.h"
+#include "HomingCycle.h"
 
 // -------------------------------------------------
 // ---------    GLOBAL OBJECTS    ------------------
 // -------------------------------------------------
-StepperMotor linearMotor(LINEAR_MOTOR_CONFIGURATION);
-StepperMotor rotationMotor(ROTATION_MOTOR_CONFIGURATION);
+// streams the steps for every motor to their output port
+StepWaveform stepWaveform(&i2c_output_port_1, I2C_BUS_FREQUENCY);
+// owns step emission from a hardware timer. Anything that changes the motors must hold its lock
+StepScheduler stepScheduler(&stepWaveform);
+// owns a motor for every axis in MACHINE_AXES and plans G1 moves ahead so they blend together
+MACHINE_MOTION_SYSTEM motion(&stepScheduler);
+constexpr uint8_t LINEAR_AXIS = motion.IndexOf('X');
+// finds the home switch on the linear axis. Every other axis goes back to 0 while it does
+HomingCycle homing(&motion.GetMotor(LINEAR_AXIS), &stepScheduler, LINEAR_HOMING_CONFIGURATION);
+// where the homing result goes. This is the channel the G28 came from
+Print *homingReplyOutput = &SerialTx;
 
 // create Serial Object
 GCodeMessage USBSerialMessage(&Serial);
 GCodeMessage displaySerialMessage(&Serial2);
+// replies on the display port are sent by the comms task, so the main loop never waits on it
+TxBuffer displayTx(&Serial2);
+// takes GCode over Ethernet. Its commands are queued the same way as the serial ones
+GCodeServer networkServer(ETHERNET_CONFIGURATION, GCODE_SERVER_PORT);
+GCodeMessage &networkMessage = networkServer.GetMessage();
+// recipes are uploaded over any channel and run from flash
+RecipeStore recipeStore;
+RecipePlayer recipePlayer(&recipeStore, &motion.GetPlanner(), &stepScheduler);
+
+// where the motors are and what the machine is doing, published by the main loop for the comms task to read
+MachineSnapshot machineSnapshot;
 
 // create Endstop objects
 Endstop homeEndstop(HOME_STOP_PIN, LIMIT_SWITCH_TRIGGERED_STATE);
@@ -40,6 +74,12 @@ I2CDigitalIO estop(ESTOP_PIN);
 I2CDigitalIO sprayer(SPRAYER_PIN);
 I2CDigitalIO heater(HEATER_PIN);
 
+// how long the parts of the loop take, reported by M881. The step timing is kept by the scheduler and waveform
+Histogram loopTime;
+Histogram parseTime;
+Histogram endstopTime;
+Histogram i2cTime;
+
 // -------------------------------------------------
 // ---------    GLOBAL VARIABLES    ----------------
 // -------------------------------------------------
@@ -53,41 +93,25 @@ using namespace MachineState;
  * @brief The handler for when we are homed
  */
 void HOMED(){
-  linearMotor.SetTargetPosition(HOME_SWITCH_POSITION);
-  linearMotor.SetCurrentPosition(HOME_SWITCH_POSITION);
-  rotationMotor.SetTargetPosition(HOME_SWITCH_POSITION);
-  rotationMotor.SetCurrentPosition(HOME_SWITCH_POSITION);
+  motion.SetAllPositions(HOME_SWITCH_POSITION);
   machineState.isHomed = true;
   SetMachineState(State::IDLE);
 }
 
-/**
- * @brief The handler for when the home endstop is triggered
-*/
-void HomeEndstopTriggered(){
-  if (machineState.state == State::HOMING)
-  {
-    HOMED();
-    Serial.println("Homing endstop triggered. Homing Complete.");
-  }
-}
-
 /**
  * @brief The handler for when endstop 1 is triggered
 */
 void Endstop1Triggered(){
-  linearMotor.SetTargetPosition(ENDSTOP_1_POSITION);
-  linearMotor.SetCurrentPosition(ENDSTOP_1_POSITION);
-  Serial.println("Endstop 1 triggered");
+  motion.SetPosition(LINEAR_AXIS, ENDSTOP_1_POSITION);
+  LOG_INFO("Endstop 1 triggered");
 }
 
 /**
  * @brief The handler for when endstop 2 is triggered
 */
 void Endstop2Triggered(){
-  linearMotor.SetTargetPosition(ENDSTOP_2_POSITION);
-  linearMotor.SetCurrentPosition(ENDSTOP_2_POSITION);
-  Serial.println("Endstop 2 triggered");
+  motion.SetPosition(LINEAR_AXIS, ENDSTOP_2_POSITION);
+  LOG_INFO("Endstop 2 triggered");
 }
 
 // -------------------------------------------------
@@ -97,39 +121,20 @@ void Endstop2Triggered(){
  * @brief Emergency stop
 */
 void ESTOP(){
-  linearMotor.SetEnabled(false);
-  rotationMotor.SetEnabled(false);
+  // a recipe or homing can't pick up where it left off after an estop
+  recipePlayer.Stop();
+  homing.Stop();
+  motion.SetEnabled(false);
   SetMachineState(State::EMERGENCY_STOP);
-  Serial.println("ESTOPPED");
+  SerialTx.Send("ESTOPPED");
 }
 
 void RELEASE_ESTOP(){
-  linearMotor.SetCurrentPosition(0);
-  rotationMotor.SetCurrentPosition(0);
-  linearMotor.SetTargetPosition(0);
-  rotationMotor.SetTargetPosition(0);
+  motion.SetAllPositions(0);
+  motion.SetEnabled(true);
   machineState.isHomed = false;
-  linearMotor.SetEnabled(true);
-  rotationMotor.SetEnabled(true);
   SetMachineState(State::IDLE);
-  Serial.println("ESTOP RELEASED");
-}
-
-/**
- * @brief Move the motors to the specified positions at the specified speeds
- * @param args The arguments for the move command
- * @param argsLength The length of the args array
-*/
-void MOVE(int16_t linearMotorPosition, int16_t linearMotorSpeed, int16_t rotationMotorPosition, int16_t rotationMotorSpeed){
-  if(machineState.coordinateSystem == CoordinateSystem::RELATIVE){
-    linearMotorPosition += linearMotor.GetCurrentPosition();
-    rotationMotorPosition += rotationMotor.GetCurrentPosition();
-  }
-
-  linearMotor.SetTargetPosition(linearMotorPosition);
-  linearMotor.SetSpeed(linearMotorSpeed);
-  rotationMotor.SetTargetPosition(rotationMotorPosition);
-  rotationMotor.SetSpeed(rotationMotorSpeed);
+  SerialTx.Send("ESTOP RELEASED");
 }
 
 /**
@@ -137,56 +142,165 @@ void MOVE(int16_t linearMotorPosition, int16_t linearMotorSpeed, int16_t rotatio
  * @note This function sets the motor's target position to their current position
 */
 void STOP_MOVE(){
-  linearMotor.SetTargetPosition(linearMotor.GetCurrentPosition());
-  rotationMotor.SetTargetPosition(rotationMotor.GetCurrentPosition());
+  motion.Stop();
 }
 
 /**
  * @brief Move the motors to their home positions
+ * @note The linear axis finds the home switch in UPDATE_HOMING()
 */
 void HOME(){
-  Serial.println("HOME");
-  // TODO: Have the motors move until the home limit switch is hit
-  linearMotor.SetTargetPosition(-4000);
-  rotationMotor.SetTargetPosition(0);
-  MOVE(-4000, 1000, 0, 1000);
+  LOG_DEBUG("HOME");
+  // every axis without a home switch goes back to 0
+  int32_t target[motion.AXES] = {};
+  uint32_t speed[motion.AXES];
+  for(uint8_t i = 0; i < motion.AXES; i++){
+    speed[i] = ROTATION_HOMING_SPEED;
+  }
+  motion.MoveTo(target, speed, false, MOTION_PLANNER_ALL_AXES & ~(1 << LINEAR_AXIS));
+  homing.Start(homeEndstop.IsTriggered());
   SetMachineState(State::HOMING);
   machineState.isHomed = false;
 }
 
+/**
+ * @brief Move the homing cycle on, and finish homing once the linear axis is on its switch and every other axis is at 0
+ * @note This must be called every loop while homing, right after the home endstop is read
+*/
+void UPDATE_HOMING(){
+  switch(homing.Update(homeEndstop.IsTriggered())){
+    case HomingCycle::DONE:
+      if(!motion.IsMoving()){
+        homing.Stop();
+        HOMED();
+        homing.Report(*homingReplyOutput, "G28");
+        LOG_INFO("Homing Complete.");
+      }
+      break;
+
+    case HomingCycle::FAILED:
+      homing.Stop();
+      STOP_MOVE();
+      SetMachineState(State::IDLE);
+      homing.Report(*homingReplyOutput, "G28");
+      LOG_ERROR("Homing failed");
+      break;
+
+    default:
+      break;
+  }
+}
+
+/**
+ * @brief Set an output pin
+ * @param pin_number The pin. 0-7 are on port 1 and 8-15 are on port 2
+ * @param value true to turn it on
+ * @note A pin on port 1, like the sprayer and heater, changes on the last step of the last planned move,
+ * so it lines up with where the move ends without the moves stopping. With nothing planned it changes now
+*/
 void SET_PIN(uint8_t pin_number, bool value){
   // invert the value here because the relay board is active low
   value = !value;
   
   if(pin_number < 8){
-    Serial.print("Port 1, pin ");
-    Serial.print(pin_number);
-    Serial.print(" value ");
-    Serial.println(value);
-    i2c_output_port_1.write(pin_number, value);
+    LOG_DEBUG("Port 1, pin %u value %u", pin_number, value);
+    // port 1 is streamed by the step scheduler
+    stepScheduler.Lock();
+    if(!motion.GetPlanner().AddEvent(1 << pin_number, value)){
+      i2c_output_port_1.Write(pin_number, value);
+    }
+    stepScheduler.Unlock();
   }
   else if(pin_number < 16){
-    Serial.print("Port 2, pin ");
-    Serial.print(pin_number - 8);
-    Serial.print(" value ");
-    Serial.println(value);
-    i2c_output_port_2.write(pin_number - 8, value);
+    LOG_DEBUG("Port 2, pin %u value %u", pin_number - 8, value);
+    i2c_output_port_2.Write(pin_number - 8, value);
   }
   else{
-    Serial.println("Invalid pin number");
+    LOG_ERROR("Invalid pin number");
   }
 }
 
+/**
+ * @brief Print every timing histogram
+ * @param source The channel that asked for them
+ * @param reset true to clear them after they are printed
+*/
+void PRINT_PROFILE(GCodeSource &source, bool reset){
+  Print &output = *source.GetReplyOutput();
+  loopTime.Report(output, "M881", "LOOP");
+  parseTime.Report(output, "M881", "PARSE");
+  endstopTime.Report(output, "M881", "ENDSTOPS");
+  i2cTime.Report(output, "M881", "I2C");
+  homing.Report(output, "M881");
+  stepScheduler.GetTickLateness()->Report(output, "M881", "TICK");
+  stepScheduler.GetBurstTime()->Report(output, "M881", "BURST");
+  for(uint8_t i = 0; i < motion.AXES; i++){
+    char name[] = {'S', 'T', 'E', 'P', '_', motion.letters[i], '\0'};
+    stepWaveform.GetStepLateness(i)->Report(output, "M881", name);
+  }
+
+  if(reset){
+    loopTime.Reset();
+    parseTime.Reset();
+    endstopTime.Reset();
+    i2cTime.Reset();
+    stepScheduler.Lock();
+    stepScheduler.ResetStatistics();
+    for(uint8_t i = 0; i < motion.AXES; i++){
+      stepWaveform.GetStepLateness(i)->Reset();
+    }
+    stepScheduler.Unlock();
+  }
+  source.Reply("!M881;");
+}
+
+/**
+ * @brief Publish where the motors are and what the machine is doing
+ * @note Only the main loop publishes, so nothing else has to read the motors
+*/
+void PUBLISH_STATUS(){
+  MachineStatus status;
+  for(uint8_t i = 0; i < motion.AXES; i++){
+    status.position[i] = motion.GetMotor(i).GetCurrentPosition();
+    status.speed[i] = motion.GetMotor(i).GetSpeed();
+  }
+  status.state = machineState.state;
+  status.isHomed = machineState.isHomed;
+  machineSnapshot.Publish(status);
+}
+
+/**
+ * @brief Print the last published position of the motors
+ * @param source The channel that asked for it
+*/
+void PRINT_POSITION(GCodeSource &source){
+  MachineStatus status = machineSnapshot.Read();
+  // every axis by its letter, then the speeds of the first two as F and S
+  char reply[8 + motion.AXES * 13 + 2 * 12];
+  int length = snprintf(reply, sizeof(reply), "!M114");
+  for(uint8_t i = 0; i < motion.AXES; i++){
+    length += snprintf(reply + length, sizeof(reply) - length, ",%c%ld", motion.letters[i], static_cast<long>(status.position[i]));
+  }
+  const char speedLetters[] = {'F', 'S'};
+  for(uint8_t i = 0; i < motion.AXES && i < sizeof(speedLetters); i++){
+    length += snprintf(reply + length, sizeof(reply) - length, ",%c%lu", speedLetters[i], static_cast<unsigned long>(status.speed[i]));
+  }
+  snprintf(reply + length, sizeof(reply) - length, ";");
+  source.Reply("%s", reply);
+}
+
 // -------------------------------------------------
 // ---------    SERIAL PARSING    ------------------
 // -------------------------------------------------
 
 /**
  * @brief Parse the serial message
+ * @param gcode The command
+ * @param source The channel the command came from. Its replies go back there
  * @note Check that there is new data before calling this function
  * @return true if the message should be consumed
 */
-bool parseSerial(const GCodeDefinitions::GCode &gcode){
+bool parseSerial(const GCodeDefinitions::GCode &gcode, GCodeSource &source){
     using namespace GCodeDefinitions;
 
     // check if we're in a state to parse this serial command
@@ -198,116 +312,102 @@ bool parseSerial(const GCodeDefinitions::GCode &gcode){
     switch(gcode.command){
       // Invalid command so do nothing
       case Command::INVALID:
-        Serial.println("Invalid command! Ignoring.");
+        LOG_ERROR("Invalid command! Ignoring.");
                 break;
       
       // M2: Ping
       case Command::M2:
         // if we recieved a ping, log the time and send a ping back
         machineState.timeEnteredState = millis();
-        Serial.println("!M2;");
+        source.Reply("!M2;");
         break;
       
       // G4: Wait a specified amount of time in ms
       case Command::G4:
-        Serial.println("!G4;");
+        source.Reply("!G4;");
         SetMachineState(State::WAITING);
         machineState.waitTime = gcode.T;
         break;
       
       // M0: Emergency stop
       case Command::M0:
-        Serial.println("!M0;");
+        source.Reply("!M0;");
         ESTOP();
         break;
       
       // M1: Release the emergency stop
       case Command::M1:
-        Serial.println("!M1;");
+        source.Reply("!M1;");
         RELEASE_ESTOP();
         break;
       
       // M24: Pause/Resume
       case Command::M24:
-        Serial.println("!M24;");
+        source.Reply("!M24;");
         if(gcode.S == 0){
           SetMachineState(State::PAUSED);
         }
         else if(gcode.S == 1){
-          SetMachineState(State::IDLE);
+          // a homing cycle that was paused picks up where it was
+          SetMachineState(homing.IsRunning() ? State::HOMING : State::IDLE);
         }
         break;
       
       // M114: Get the current position of the motors
       case Command::M114:
-        Serial.print("!M114,X");
-        Serial.print(linearMotor.GetCurrentPosition());
-        Serial.print(",R");
-        Serial.print(rotationMotor.GetTargetPosition());
-        Serial.print(",F");
-        Serial.print(linearMotor.GetSpeed());
-        Serial.print(",S");
-        Serial.print(rotationMotor.GetSpeed());
-        Serial.println(";");
+        PRINT_POSITION(source);
         break;
       
       // G91: Relative positioning 
       case Command::G91:
-        Serial.println("!G91;");
+        source.Reply("!G91;");
         machineState.coordinateSystem = CoordinateSystem::RELATIVE;
         break;
       
       // G90: Absolute positioning
       case Command::G90:
-        Serial.println("!G90;");
+        source.Reply("!G90;");
         machineState.coordinateSystem = CoordinateSystem::ABSOLUTE;
         break;
       
       // M208: Set max travel
       case Command::M208:
-        Serial.println("!M208;");
-        linearMotor.SetMaxTravel(gcode.X);
+        source.Reply("!M208;");
+        motion.SetMaxTravel(gcode);
         break;
 
       // M92: Set steps per unit
       case Command::M92:
-        Serial.println("M92 IS UNIMPLIMENTED AND HAS NO PLAN TO BE IMPLIMENTED");
+        LOG_ERROR("M92 IS UNIMPLIMENTED AND HAS NO PLAN TO BE IMPLIMENTED");
         break;
       
       // G1: Controlled move
       case Command::G1:{
-        Serial.println("!G1;");
-        // calculate the rotational motor speed to the rotation finished at the same time as the linear motor
-        // r_speed = (x_speed * r_change) / x_change
-        float x_change = static_cast<float>(gcode.X - linearMotor.GetCurrentPosition());
-        float r_change = static_cast<float>(gcode.R - rotationMotor.GetCurrentPosition());
-        // if we are in relative mode, the given values are already our changes
-        if(machineState.coordinateSystem == CoordinateSystem::RELATIVE){
-          x_change = static_cast<float>(gcode.X);
-          r_change = static_cast<float>(gcode.R);
+        // the planner works out the speed of the other axes so they all finish together,
+        // and blends this move into the ones around it
+        bool isPlanned = motion.PlanMove(gcode, machineState.coordinateSystem == CoordinateSystem::RELATIVE);
+        // if the planner is full, leave the move in the queue and try again next loop
+        if(!isPlanned && motion.GetPlanner().IsFull()){
+          return false;
         }
-
-        // no division by 0 on my watch
-        if(x_change == 0){
-          x_change = 1;
+        if(!isPlanned){
+          LOG_ERROR("G1 needs a feed rate");
+          break;
         }
-
-        float rotationalFeedRate = static_cast<float>(gcode.F) * r_change / x_change;
-        uint16_t rotationalMotorSpeed = 0;
-        MOVE(gcode.X, gcode.F, gcode.R, static_cast<uint16_t>(rotationalFeedRate));
+        source.Reply("!G1;");
         break;
       }
       
       // G0: Move with a ping timeout
       case Command::G0:
-        Serial.println("!G0;");
+        source.Reply("!G0;");
         // if we recieve S0, stop the motors
         if(gcode.S == 0){
           STOP_MOVE();
           SetMachineState(State::IDLE);
         }
 
-        MOVE(gcode.X, gcode.F, gcode.R, gcode.P);
+        motion.Move(gcode, machineState.coordinateSystem == CoordinateSystem::RELATIVE);
         SetMachineState(State::PING);
         // if the user doesn't ping us every 500ms, stop moving
         machineState.waitTime = 500;
@@ -315,13 +415,14 @@ bool parseSerial(const GCodeDefinitions::GCode &gcode){
     
       // G28: Home
       case Command::G28:
-        Serial.println("!G28;");
+        source.Reply("!G28;");
+        homingReplyOutput = source.GetReplyOutput();
         HOME();
         break;
       
       // M42: Set pin
       case Command::M42:{
-        Serial.println("!M42;");
+        source.Reply("!M42;");
         // the pin will remain low unless the S parameter is 1
         bool pinState = false;
         if(gcode.S == 1){
@@ -331,14 +432,91 @@ bool parseSerial(const GCodeDefinitions::GCode &gcode){
         break;
       }
       
+      // M32: Run a recipe from flash
+      case Command::M32:
+        if(recipePlayer.Start(gcode.P, source.GetReplyOutput())){
+          source.Reply("!M32,P%ld;", static_cast<long>(gcode.P));
+        }
+        else{
+          LOG_ERROR("No recipe in that slot");
+        }
+        break;
+
+      // M27: Report the status of the recipe
+      case Command::M27:
+        recipePlayer.PrintStatus(source);
+        break;
+
+      // M524: Abort the recipe and stop the motors
+      case Command::M524:
+        source.Reply("!M524;");
+        recipePlayer.Stop();
+        STOP_MOVE();
+        recipePlayer.PrintStatus(source);
+        break;
+
+      // M881: Report the timing histograms. S1 clears them after
+      case Command::M881:
+        PRINT_PROFILE(source, gcode.S == 1);
+        break;
+
       default:
-        Serial.println("Something went wrong parsing the command");
+        LOG_ERROR("Something went wrong parsing the command");
         break;
     }
 
     return true;
 }
 
+/**
+ * @brief Parse the serial message and count how long it took
+ * @param gcode The command
+ * @param source The channel the command came from
+ * @return true if the message should be consumed
+*/
+bool timedParseSerial(const GCodeDefinitions::GCode &gcode, GCodeSource &source){
+  uint32_t start = CycleTimer::Now();
+  bool isParsed = parseSerial(gcode, source);
+  parseTime.RecordSince(start);
+  return isParsed;
+}
+
+// -------------------------------------------------
+// ---------    COMMS TASK    ----------------------
+// -------------------------------------------------
+
+/**
+ * @brief Answer a status query as soon as it's received, so it doesn't wait behind the queued moves
+ * @param gcode The command
+ * @param source The channel it came from
+ * @return true if the command was answered and shouldn't be queued
+ * @note This runs on the comms task, so it only reads the snapshot
+*/
+bool ANSWER_QUERY(const GCodeDefinitions::GCode &gcode, GCodeSource &source){
+  if(gcode.command == GCodeDefinitions::Command::M114){
+    PRINT_POSITION(source);
+    return true;
+  }
+  return false;
+}
+
+/**
+ * @brief Read every channel once and send what's waiting on the serial ports. The network server sends its own
+ * @note This runs on the comms task. It only pushes commands to the channels' queues for the main loop to run
+*/
+void UPDATE_COMMS(){
+  USBSerialMessage.Update();
+  displaySerialMessage.Update();
+  networkServer.Update();
+  SerialTx.Drain();
+  displayTx.Drain();
+}
+
+// reads the serial ports and the network on the other core
+CommsTask commsTask(UPDATE_COMMS);
+// runs the commands waiting in every channel on the main loop
+CommandDispatcher commandDispatcher(timedParseSerial, COMMAND_BUDGET_US);
+
 // -------------------------------------------------
 // ---------    SETUP AND LOOP    ------------------
 // -------------------------------------------------
@@ -347,81 +525,111 @@ bool parseSerial(const GCodeDefinitions::GCode &gcode){
  * @brief The setup function
 */
 void setup() {
+  CycleTimer::Begin();
+
   // <---------- Serial setup ------------>
   USBSerialMessage.Init(SERIAL_BAUD_RATE);
   // we initialize the display serial message differently because it's using different pins
   Serial2.begin(SERIAL_BAUD_RATE, SERIAL_8N1, RX2_PIN, TX2_PIN);
-  Serial.println("Beginning Machine Setup");
+  LOG_INFO("Beginning Machine Setup");
+
+  // <---------- recipe setup ------------>
+  if(recipeStore.Begin()){
+    USBSerialMessage.SetRecipeStore(&recipeStore);
+    displaySerialMessage.SetRecipeStore(&recipeStore);
+    networkMessage.SetRecipeStore(&recipeStore);
+  }
+  else{
+    LOG_ERROR("Recipe storage failed to start");
+  }
+
+  // replies on the USB port share its buffer with everything else the firmware sends there
+  USBSerialMessage.SetReplyOutput(&SerialTx);
+  displaySerialMessage.SetReplyOutput(&displayTx);
+  USBSerialMessage.SetQueryHandler(ANSWER_QUERY);
+  displaySerialMessage.SetQueryHandler(ANSWER_QUERY);
+  networkMessage.SetQueryHandler(ANSWER_QUERY);
+
+  commandDispatcher.AddSource(&USBSerialMessage, USB_COMMAND_PRIORITY, USB_COMMAND_WEIGHT);
+  commandDispatcher.AddSource(&displaySerialMessage, DISPLAY_COMMAND_PRIORITY, DISPLAY_COMMAND_WEIGHT);
+  commandDispatcher.AddSource(&networkMessage, NETWORK_COMMAND_PRIORITY, NETWORK_COMMAND_WEIGHT);
+  commandDispatcher.AddSource(&recipePlayer, RECIPE_COMMAND_PRIORITY, RECIPE_COMMAND_WEIGHT);
+
+  // <---------- Ethernet setup ------------>
+  if(!networkServer.Begin()){
+    LOG_ERROR("Ethernet failed to start, or the GCode server couldn't listen on its port");
+  }
   
   // <---------- I2C setup ------------>
-  I2C_BUS.begin(SDA_PIN, SCL_PIN, 100000);
-  i2c_output_port_1.begin();
-  i2c_output_port_2.begin();
-  i2c_input_port_1.begin();
-  i2c_input_port_2.begin();
+  I2C_BUS.begin(SDA_PIN, SCL_PIN, I2C_BUS_FREQUENCY);
+  i2c_output_port_1.Begin();
+  i2c_output_port_2.Begin();
+  i2c_input_port_1.Begin();
+  i2c_input_port_2.Begin();
 
   // <---------- endstop setup ------------>
-  homeEndstop.Init(HomeEndstopTriggered);
+  // the homing cycle reads the home switch itself
+  homeEndstop.Init(NULL);
   endstop1.Init(Endstop1Triggered);
   endstop2.Init(Endstop2Triggered);
 
   // <---------- motor setup ------------>
-  linearMotor.Init();
-  linearMotor.SetEnabled(true);
+  motion.Begin(&stepWaveform);
+  stepWaveform.Init();
+
+  // from here on the step scheduler owns output port 1
+  stepScheduler.Begin();
 
-  rotationMotor.Init();
-  rotationMotor.SetEnabled(true);
+  // from here on the comms task reads every channel
+  PUBLISH_STATUS();
+  commsTask.Begin();
 
-  Serial.println("Finished Machine Setup");
+  LOG_INFO("Finished Machine Setup");
 }
 
 /**
  * @brief The main loop
 */
 void loop() {
-  // check for new serial data
-  USBSerialMessage.Update();
-  displaySerialMessage.Update();
+  uint32_t loopStart = CycleTimer::Now();
+
+  // check for new serial data. On the ESP32 the comms task has already done it
+  commsTask.Update();
+  // read the running recipe ahead into its queue. Nothing is read while we wait, home or pause,
+  // so a compiled recipe's moves can't start before the command in front of them is done
+  if(machineState.state == State::IDLE || machineState.state == State::MOVING){
+    recipePlayer.Update();
+  }
   // check to see if we recieved an ESTOP
-  if(USBSerialMessage.EStopCommandReceived() || displaySerialMessage.EStopCommandReceived()){
+  if(USBSerialMessage.EStopCommandReceived() || displaySerialMessage.EStopCommandReceived() || networkMessage.EStopCommandReceived()
+    || recipePlayer.EStopCommandReceived()){
     ESTOP();
     USBSerialMessage.ClearNewData();
     displaySerialMessage.ClearNewData();
+    networkMessage.ClearNewData();
   }
   
-  if(USBSerialMessage.IsNewData()){
-    // try to parse the new data
-    if(parseSerial(*(USBSerialMessage.PeekGCode()))){
-      // if we parsed the data, pop it from the queue
-      USBSerialMessage.PopGCode();
-      // clear the new data flag
-      USBSerialMessage.ClearNewData();
-    }
-  }
-
-  if(displaySerialMessage.IsNewData()){
-    // try to parse the new data
-    if(parseSerial(*(displaySerialMessage.PeekGCode()))){
-      // if we parsed the data, pop it from the queue
-      displaySerialMessage.PopGCode();
-      // clear the new data flag
-      displaySerialMessage.ClearNewData();
-    }
-  }
+  // run as many waiting commands as fit in the budget, taking turns between the channels
+  commandDispatcher.Dispatch();
 
-  // update the motors
-  if(machineState.state != State::PAUSED){
-    linearMotor.Update();
-    rotationMotor.Update();
-  }
+  // the step scheduler streams the steps in the background, we just tell it if we're paused
+  stepScheduler.SetPaused(machineState.state == State::PAUSED);
 
   // update the endstops
+  uint32_t start = CycleTimer::Now();
   homeEndstop.Update();
   endstop1.Update();
   endstop2.Update();
+  endstopTime.RecordSince(start);
+  if(machineState.state == State::HOMING){
+    UPDATE_HOMING();
+  }
 
   // poll our input pins
-  if(estop.Get()){
+  start = CycleTimer::Now();
+  bool isEStopPressed = estop.Get();
+  i2cTime.RecordSince(start);
+  if(isEStopPressed){
     ESTOP();
   }
 
@@ -430,9 +638,19 @@ void loop() {
   // if we are in the ping state and don't hear back from the controller in the time promised, stop moving
   if(machineState.state == State::PING){
     if(machineState.timeEnteredState - millis() >= machineState.waitTime){
-      Serial.println("Ping timeout");
+      LOG_ERROR("Ping timeout");
       STOP_MOVE();
       SetMachineState(State::IDLE);
     }
   }
+
+  // send every pin change from this loop to the expander in one write.
+  // Port 1 is flushed by the step scheduler
+  start = CycleTimer::Now();
+  i2c_output_port_2.Flush();
+  i2cTime.RecordSince(start);
+
+  PUBLISH_STATUS();
+
+  loopTime.RecordSince(loopStart);
 }
\ No newline at end of file
@@ -0,0 +1,145 @@
+/**
+ * @file test_binary_frame.cpp
+ * @brief Tests for the binary framing: the CRC16, COBS and whole frames
+ * @version 1.0.0
+ * @author Quinn Henthorne. Contact: quinn.henthorne@gmail.com
+*/
+
+#include <unity.h>
+#include <string.h>
+#include "BinaryFrame.h"
+
+/**
+ * @brief Encode some data and check it against what it should be
+ * @param data The data to encode
+ * @param length The length of the data
+ * @param expected The encoded data
+ * @param expectedLength The length of the encoded data
+*/
+void checkCobs(const uint8_t *data, uint16_t length, const uint8_t *expected, uint16_t expectedLength){
+    uint8_t encoded[16];
+    TEST_ASSERT_EQUAL_UINT16(expectedLength, BinaryFrame::CobsEncode(data, length, encoded));
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(expected, encoded, expectedLength);
+
+    uint8_t decoded[16];
+    TEST_ASSERT_EQUAL_UINT16(length, BinaryFrame::CobsDecode(encoded, expectedLength, decoded));
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(data, decoded, length);
+}
+
+void setUp(){}
+
+void tearDown(){}
+
+void test_crc_matches_the_ccitt_check_value(){
+    const uint8_t data[] = {'1', '2', '3', '4', '5', '6', '7', '8', '9'};
+    TEST_ASSERT_EQUAL_HEX16(0x29B1, BinaryFrame::Crc16(data, sizeof(data)));
+}
+
+void test_crc_can_be_worked_out_in_pieces(){
+    const uint8_t data[] = {0x01, 0x00, 0xFF, 0x42, 0x10, 0x00, 0x7E};
+    uint16_t crc = BinaryFrame::Crc16(data, 3);
+    crc = BinaryFrame::Crc16(data + 3, sizeof(data) - 3, crc);
+    TEST_ASSERT_EQUAL_HEX16(BinaryFrame::Crc16(data, sizeof(data)), crc);
+}
+
+void test_cobs_known_blocks(){
+    const uint8_t zero[] = {0x00};
+    const uint8_t zeroEncoded[] = {0x01, 0x01};
+    checkCobs(zero, sizeof(zero), zeroEncoded, sizeof(zeroEncoded));
+
+    const uint8_t zeros[] = {0x00, 0x00};
+    const uint8_t zerosEncoded[] = {0x01, 0x01, 0x01};
+    checkCobs(zeros, sizeof(zeros), zerosEncoded, sizeof(zerosEncoded));
+
+    const uint8_t middle[] = {0x11, 0x22, 0x00, 0x33};
+    const uint8_t middleEncoded[] = {0x03, 0x11, 0x22, 0x02, 0x33};
+    checkCobs(middle, sizeof(middle), middleEncoded, sizeof(middleEncoded));
+
+    const uint8_t noZero[] = {0x11, 0x22, 0x33, 0x44};
+    const uint8_t noZeroEncoded[] = {0x05, 0x11, 0x22, 0x33, 0x44};
+    checkCobs(noZero, sizeof(noZero), noZeroEncoded, sizeof(noZeroEncoded));
+
+    const uint8_t trailing[] = {0x11, 0x00, 0x00, 0x00};
+    const uint8_t trailingEncoded[] = {0x02, 0x11, 0x01, 0x01, 0x01};
+    checkCobs(trailing, sizeof(trailing), trailingEncoded, sizeof(trailingEncoded));
+}
+
+void test_cobs_round_trip_across_full_blocks(){
+    // long runs without a zero have to be split into full blocks
+    uint8_t data[600];
+    for(uint16_t i = 0; i < sizeof(data); i++){
+        data[i] = i < 300 ? static_cast<uint8_t>(i % 255 + 1) : static_cast<uint8_t>(i % 7 == 0 ? 0 : i);
+    }
+    uint8_t encoded[sizeof(data) + sizeof(data) / 254 + 1];
+    uint16_t length = BinaryFrame::CobsEncode(data, sizeof(data), encoded);
+    TEST_ASSERT_LESS_OR_EQUAL(sizeof(encoded), length);
+    TEST_ASSERT_NULL(memchr(encoded, 0, length));
+
+    uint8_t decoded[sizeof(data)];
+    TEST_ASSERT_EQUAL_UINT16(sizeof(data), BinaryFrame::CobsDecode(encoded, length, decoded));
+    TEST_ASSERT_EQUAL_MEMORY(data, decoded, sizeof(data));
+}
+
+void test_cobs_decodes_in_place(){
+    const uint8_t data[] = {0x11, 0x22, 0x00, 0x33};
+    uint8_t buffer[8];
+    uint16_t length = BinaryFrame::CobsEncode(data, sizeof(data), buffer);
+    TEST_ASSERT_EQUAL_UINT16(sizeof(data), BinaryFrame::CobsDecode(buffer, length, buffer));
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(data, buffer, sizeof(data));
+}
+
+void test_cobs_rejects_bad_frames(){
+    uint8_t decoded[8];
+    // a zero can't start a block, since it is the delimiter
+    const uint8_t hasZero[] = {0x02, 0x11, 0x00, 0x01};
+    TEST_ASSERT_EQUAL_UINT16(0, BinaryFrame::CobsDecode(hasZero, sizeof(hasZero), decoded));
+    // the block says it is longer than the frame
+    const uint8_t tooLong[] = {0x05, 0x11, 0x22};
+    TEST_ASSERT_EQUAL_UINT16(0, BinaryFrame::CobsDecode(tooLong, sizeof(tooLong), decoded));
+}
+
+void test_frame_has_one_delimiter_and_checks_out(){
+    const uint8_t payload[] = {0xFF, 0xFF, 0xFF, 0xFF, 0x01, 0x00, 0x00, 0x03, 0x0A, 0x00, 0x00, 0x00};
+    uint8_t frame[64];
+    uint16_t length = BinaryFrame::Encode(BinaryFrame::FrameType::MOVES, payload, sizeof(payload), frame);
+    TEST_ASSERT_EQUAL_HEX8(BINARY_FRAME_DELIMITER, frame[length - 1]);
+    TEST_ASSERT_NULL(memchr(frame, BINARY_FRAME_DELIMITER, length - 1));
+
+    // this is what GCodeMessage does with a frame it receives
+    uint8_t decoded[64];
+    uint16_t decodedLength = BinaryFrame::CobsDecode(frame, length - 1, decoded);
+    TEST_ASSERT_EQUAL_UINT16(BINARY_FRAME_HEADER_LENGTH + sizeof(payload) + BINARY_FRAME_CRC_LENGTH, decodedLength);
+    TEST_ASSERT_EQUAL_HEX8(BinaryFrame::FrameType::MOVES, decoded[0]);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(payload, decoded + BINARY_FRAME_HEADER_LENGTH, sizeof(payload));
+    uint16_t crc = decoded[decodedLength - 2] | (decoded[decodedLength - 1] << 8);
+    TEST_ASSERT_EQUAL_HEX16(BinaryFrame::Crc16(decoded, decodedLength - BINARY_FRAME_CRC_LENGTH), crc);
+
+    // a flipped bit fails the check
+    decoded[3] ^= 0x10;
+    TEST_ASSERT_NOT_EQUAL(crc, BinaryFrame::Crc16(decoded, decodedLength - BINARY_FRAME_CRC_LENGTH));
+}
+
+void test_int32_is_little_endian(){
+    uint8_t bytes[4];
+    BinaryFrame::WriteInt32(-2, bytes);
+    const uint8_t expected[] = {0xFE, 0xFF, 0xFF, 0xFF};
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(expected, bytes, sizeof(bytes));
+    TEST_ASSERT_EQUAL_INT32(-2, BinaryFrame::ReadInt32(bytes));
+
+    BinaryFrame::WriteInt32(0x12345678, bytes);
+    TEST_ASSERT_EQUAL_HEX8(0x78, bytes[0]);
+    TEST_ASSERT_EQUAL_INT32(0x12345678, BinaryFrame::ReadInt32(bytes));
+}
+
+int main(int argc, char **argv){
+    UNITY_BEGIN();
+    RUN_TEST(test_crc_matches_the_ccitt_check_value);
+    RUN_TEST(test_crc_can_be_worked_out_in_pieces);
+    RUN_TEST(test_cobs_known_blocks);
+    RUN_TEST(test_cobs_round_trip_across_full_blocks);
+    RUN_TEST(test_cobs_decodes_in_place);
+    RUN_TEST(test_cobs_rejects_bad_frames);
+    RUN_TEST(test_frame_has_one_delimiter_and_checks_out);
+    RUN_TEST(test_int32_is_little_endian);
+    return UNITY_END();
+}
@@ -0,0 +1,140 @@
+/**
+ * @file test_bus_usage.cpp
+ * @brief A benchmark of the I2C bus transactions each step costs, on the simulated bus
+ * @details Two motors step together for a second of virtual time, first from the main loop through the port's shadow
+ * register, then from the step waveform's bursts. Writing the step pin straight to the PCF8574 took two transactions
+ * per step, one to pull it low and one to release it, so both ways have to beat that.
+ * Run it with pio test -e native -f test_bus_usage -v to see the numbers.
+ * @version 1.0.0
+ * @author Quinn Henthorne. Contact: quinn.henthorne@gmail.com
+*/
+
+#include <unity.h>
+#include <stdio.h>
+#include "MACHINE-PARAMETERS.h"
+#include "StepWaveform.h"
+
+// both motors on their own pins, with no acceleration so they step at a steady rate
+constexpr StepperMotorConfiguration LINEAR_CONFIGURATION(LINEAR_MOTOR_STEP_PIN, LINEAR_MOTOR_DIRECTION_PIN, LINEAR_MOTOR_ENABLE_PIN,
+    STEPS_PER_MM, LINEAR_MOTOR_MAX_SPEED_MM_PER_MIN, 0, false);
+constexpr StepperMotorConfiguration ROTATION_CONFIGURATION(ROTATION_MOTOR_STEP_PIN, ROTATION_MOTOR_DIRECTION_PIN, ROTATION_MOTOR_ENABLE_PIN,
+    STEPS_PER_REVOLUTION, ROTATION_MOTOR_MAX_SPEED, 0, false);
+#define BENCHMARK_STEP_RATE 2000 // steps per second of each motor
+#define BENCHMARK_TIME 1000000 // us
+#define LOOP_TIME 50 // the time one pass of the main loop takes in us
+// the transactions a step took when the step pin was written straight to the expander
+#define DIRECT_TRANSACTIONS_PER_STEP 2
+
+StepperMotor linearMotor(LINEAR_CONFIGURATION);
+StepperMotor rotationMotor(ROTATION_CONFIGURATION);
+StepperMotor *const motors[] = {&linearMotor, &rotationMotor};
+
+// the bus usage of one run
+struct BusUsage{
+    uint32_t steps;
+    uint32_t transactions;
+    uint64_t busyTime; // us
+};
+
+uint32_t countSteps(){
+    return linearMotor.GetCurrentSteps() + rotationMotor.GetCurrentSteps();
+}
+
+/**
+ * @brief Print how much bus a run took for each step
+ * @param name The name of the run
+ * @param usage The bus usage of the run
+*/
+void report(const char *name, const BusUsage &usage){
+    char message[128];
+    snprintf(message, sizeof(message), "%s: %lu steps, %lu transactions, %.3f transactions/step, %.1f us of bus/step",
+        name, static_cast<unsigned long>(usage.steps), static_cast<unsigned long>(usage.transactions),
+        static_cast<double>(usage.transactions) / usage.steps, static_cast<double>(usage.busyTime) / usage.steps);
+    TEST_MESSAGE(message);
+}
+
+/**
+ * @brief Start both motors from a stop, and measure the bus from there
+ * @param usage Where to start the measurement
+*/
+void start(BusUsage &usage){
+    for(StepperMotor *motor : motors){
+        motor->Stop();
+        motor->SetCurrentPosition(0);
+        motor->SetStepRate(BENCHMARK_STEP_RATE << STEP_RATE_FRACTION_BITS);
+        motor->SetTargetSteps(INT32_MAX / 2);
+    }
+    i2c_output_port_1.Flush();
+    usage.steps = countSteps();
+    usage.transactions = I2C_BUS.GetTransactionCount();
+    usage.busyTime = I2C_BUS.GetBusyTime();
+}
+
+/**
+ * @brief Finish measuring the bus
+ * @param usage The measurement from start(). It is changed to what the run used
+*/
+void finish(BusUsage &usage){
+    usage.steps = countSteps() - usage.steps;
+    usage.transactions = I2C_BUS.GetTransactionCount() - usage.transactions;
+    usage.busyTime = I2C_BUS.GetBusyTime() - usage.busyTime;
+}
+
+void setUp(){}
+
+void tearDown(){}
+
+void test_main_loop_steps(){
+    // every pass of the loop updates the motors and flushes the port once, like loop() does
+    BusUsage usage;
+    start(usage);
+    for(uint32_t time = 0; time < BENCHMARK_TIME; time += LOOP_TIME){
+        VirtualClock::Advance(LOOP_TIME);
+        for(StepperMotor *motor : motors){
+            motor->Update();
+        }
+        i2c_output_port_1.Flush();
+    }
+    finish(usage);
+    report("main loop", usage);
+
+    TEST_ASSERT_GREATER_THAN_UINT32(BENCHMARK_STEP_RATE, usage.steps);
+    // a flush carries the pulses of both motors, so it has to beat one write per edge of every step
+    TEST_ASSERT_LESS_THAN_UINT32(DIRECT_TRANSACTIONS_PER_STEP * usage.steps, usage.transactions);
+}
+
+void test_burst_steps(){
+    // the step scheduler sends a burst whenever the last one is done
+    StepWaveform stepWaveform(&i2c_output_port_1, I2C_BUS_FREQUENCY);
+    for(StepperMotor *motor : motors){
+        stepWaveform.AddMotor(motor);
+    }
+    stepWaveform.Init();
+
+    BusUsage usage;
+    start(usage);
+    for(uint32_t time = 0; time < BENCHMARK_TIME; time += stepWaveform.GetBurstDuration()){
+        stepWaveform.Update();
+        VirtualClock::Advance(stepWaveform.GetBurstDuration());
+    }
+    finish(usage);
+    report("bursts", usage);
+
+    TEST_ASSERT_GREATER_THAN_UINT32(BENCHMARK_STEP_RATE, usage.steps);
+    // a burst is one transaction, and holds many steps
+    TEST_ASSERT_LESS_THAN_UINT32(usage.steps / 10, usage.transactions);
+}
+
+int main(int argc, char **argv){
+    VirtualClock::Set(0);
+    I2C_BUS.begin(SDA_PIN, SCL_PIN, I2C_BUS_FREQUENCY);
+    i2c_output_port_1.Begin();
+    for(StepperMotor *motor : motors){
+        motor->Init();
+    }
+
+    UNITY_BEGIN();
+    RUN_TEST(test_main_loop_steps);
+    RUN_TEST(test_burst_steps);
+    return UNITY_END();
+}
@@ -0,0 +1,186 @@
+/**
+ * @file test_gcode_message.cpp
+ * @brief Tests for the line numbers on a GCodeMessage: the acks, the resend requests and M110
+ * @version 1.0.0
+ * @author Quinn Henthorne. Contact: quinn.henthorne@gmail.com
+*/
+
+#include <unity.h>
+#include <string>
+#include "GCodeMessage.h"
+
+using namespace GCodeDefinitions;
+
+// the host's end of a channel. What the host sends is read by the message, and the replies are kept to be checked
+class HostStream : public Stream{
+    public:
+        std::string input;
+        size_t readIndex{0};
+        std::string replies;
+
+        int available() override{ return this->input.size() - this->readIndex; }
+        int read() override{ return this->available() > 0 ? static_cast<uint8_t>(this->input[this->readIndex++]) : -1; }
+        int peek() override{ return this->available() > 0 ? static_cast<uint8_t>(this->input[this->readIndex]) : -1; }
+
+        size_t write(uint8_t byte) override{
+            this->replies += static_cast<char>(byte);
+            return 1;
+        }
+
+        size_t write(const uint8_t *buffer, size_t size) override{
+            this->replies.append(reinterpret_cast<const char *>(buffer), size);
+            return size;
+        }
+
+        /**
+         * @brief Take every reply that has been sent so far
+         * @return The replies
+        */
+        std::string TakeReplies(){
+            std::string replies = this->replies;
+            this->replies.clear();
+            return replies;
+        }
+};
+
+HostStream *host;
+GCodeMessage *message;
+
+/**
+ * @brief Send commands from the host and read them all
+ * @param text The commands, with their start and end markers
+*/
+void send(const char *text){
+    host->input += text;
+    while(host->available() > 0){
+        message->Update();
+    }
+}
+
+/**
+ * @brief Send numbered lines from the host
+ * @param first The first line number
+ * @param count The number of lines
+*/
+void sendLines(int32_t first, int32_t count){
+    for(int32_t line = first; line < first + count; line++){
+        char text[32];
+        snprintf(text, sizeof(text), "!G1,X%ld,F100,N%ld;", static_cast<long>(line), static_cast<long>(line));
+        send(text);
+    }
+}
+
+/**
+ * @brief Get the number of commands waiting in the message's queue
+*/
+uint16_t countQueued(){
+    uint16_t count = 0;
+    while(message->PopGCode() != NULL){
+        count++;
+    }
+    return count;
+}
+
+/**
+ * @brief Answer M114 right away, the way the firmware does
+*/
+bool answerQuery(const GCode &command, GCodeSource &source){
+    if(command.command != Command::M114){
+        return false;
+    }
+    source.Reply("!M114;");
+    return true;
+}
+
+void setUp(){
+    host = new HostStream();
+    message = new GCodeMessage(static_cast<Stream *>(host));
+}
+
+void tearDown(){
+    delete message;
+    delete host;
+}
+
+void test_lines_in_order_are_acked(){
+    send("!G1,X1,F100,N0;!G1,X2,N1;");
+    TEST_ASSERT_EQUAL_STRING("!ACK,N0,Q255;\r\n!ACK,N1,Q254;\r\n", host->TakeReplies().c_str());
+    TEST_ASSERT_EQUAL_UINT16(2, countQueued());
+}
+
+void test_duplicate_line_is_acked_again_but_not_queued(){
+    // the host missed the first ack and sent the line again
+    send("!G1,X1,F100,N0;");
+    send("!G1,X1,F100,N0;");
+    TEST_ASSERT_EQUAL_STRING("!ACK,N0,Q255;\r\n!ACK,N0,Q255;\r\n", host->TakeReplies().c_str());
+    TEST_ASSERT_EQUAL_UINT16(1, countQueued());
+}
+
+void test_gap_asks_once_for_the_missing_line(){
+    sendLines(0, 1);
+    host->TakeReplies();
+    // line 1 was lost. Everything after it is thrown away, and only the first asks for it
+    sendLines(2, 3);
+    TEST_ASSERT_EQUAL_STRING("!RS,N1;\r\n", host->TakeReplies().c_str());
+    sendLines(1, 4);
+    TEST_ASSERT_EQUAL_STRING("!ACK,N1,Q254;\r\n!ACK,N2,Q253;\r\n!ACK,N3,Q252;\r\n!ACK,N4,Q251;\r\n", host->TakeReplies().c_str());
+    TEST_ASSERT_EQUAL_UINT16(5, countQueued());
+}
+
+void test_full_queue_asks_again_every_time(){
+    sendLines(0, GCODE_QUEUE_MAX_SIZE);
+    host->TakeReplies();
+    // the queue drains at the speed of the moves, so the host can be refused the same line more than once
+    sendLines(GCODE_QUEUE_MAX_SIZE, 1);
+    TEST_ASSERT_EQUAL_STRING("!RS,N256;\r\n", host->TakeReplies().c_str());
+    sendLines(GCODE_QUEUE_MAX_SIZE, 1);
+    TEST_ASSERT_EQUAL_STRING("!RS,N256;\r\n", host->TakeReplies().c_str());
+
+    // once there's room the line is taken
+    message->PopGCode();
+    sendLines(GCODE_QUEUE_MAX_SIZE, 1);
+    TEST_ASSERT_EQUAL_STRING("!ACK,N256,Q0;\r\n", host->TakeReplies().c_str());
+}
+
+void test_query_is_answered_when_the_queue_is_full(){
+    message->SetQueryHandler(answerQuery);
+    sendLines(0, GCODE_QUEUE_MAX_SIZE);
+    host->TakeReplies();
+    send("!M114,N256;");
+    TEST_ASSERT_EQUAL_STRING("!M114;\r\n!ACK,N256,Q0;\r\n", host->TakeReplies().c_str());
+    TEST_ASSERT_EQUAL_UINT16(GCODE_QUEUE_MAX_SIZE, countQueued());
+}
+
+void test_garbled_line_asks_every_time(){
+    sendLines(0, 1);
+    host->TakeReplies();
+    send("!Q1,N1;");
+    TEST_ASSERT_EQUAL_STRING("!RS,N1;\r\n", host->TakeReplies().c_str());
+    // it came in garbled again
+    send("!Q1,N1;");
+    TEST_ASSERT_EQUAL_STRING("!RS,N1;\r\n", host->TakeReplies().c_str());
+    sendLines(1, 1);
+    TEST_ASSERT_EQUAL_STRING("!ACK,N1,Q254;\r\n", host->TakeReplies().c_str());
+}
+
+void test_m110_sets_the_line_number(){
+    send("!M110,N10;");
+    TEST_ASSERT_EQUAL_STRING("!ACK,N10,Q256;\r\n", host->TakeReplies().c_str());
+    // the lines before it are old now, and the next one is after it
+    sendLines(11, 1);
+    TEST_ASSERT_EQUAL_STRING("!ACK,N11,Q255;\r\n", host->TakeReplies().c_str());
+    sendLines(13, 1);
+    TEST_ASSERT_EQUAL_STRING("!RS,N12;\r\n", host->TakeReplies().c_str());
+}
+
+int main(int argc, char **argv){
+    UNITY_BEGIN();
+    RUN_TEST(test_lines_in_order_are_acked);
+    RUN_TEST(test_duplicate_line_is_acked_again_but_not_queued);
+    RUN_TEST(test_gap_asks_once_for_the_missing_line);
+    RUN_TEST(test_full_queue_asks_again_every_time);
+    RUN_TEST(test_query_is_answered_when_the_queue_is_full);
+    RUN_TEST(test_garbled_line_asks_every_time);
+    RUN_TEST(test_m110_sets_the_line_number);
+    return UNITY_END();
+}
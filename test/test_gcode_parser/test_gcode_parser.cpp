@@ -0,0 +1,151 @@
+/**
+ * @file test_gcode_parser.cpp
+ * @brief Tests for the GCodeParser, which turns a received command into a GCode struct and back
+ * @version 1.0.0
+ * @author Quinn Henthorne. Contact: quinn.henthorne@gmail.com
+*/
+
+#include <unity.h>
+#include <string.h>
+#include "GCodeParser.h"
+
+using namespace GCodeDefinitions;
+
+/**
+ * @brief Parse a command the way it would come in over serial
+ * @param message The command without the start and end markers
+*/
+GCode parse(const char *message){
+    return GCodeParser::Parse(message, strlen(message));
+}
+
+void setUp(){}
+
+void tearDown(){}
+
+void test_command_without_values(){
+    GCode command = parse("M2");
+    TEST_ASSERT_EQUAL_UINT8(Command::M2, command.command);
+    TEST_ASSERT_EQUAL_UINT8(0, command.axisMask);
+    TEST_ASSERT_FALSE(command.hasF);
+    TEST_ASSERT_FALSE(command.hasS);
+    TEST_ASSERT_FALSE(command.hasP);
+    TEST_ASSERT_FALSE(command.hasT);
+    TEST_ASSERT_FALSE(command.hasN);
+}
+
+void test_every_value_is_read(){
+    GCode command = parse("G1,X120,R-45,F3000,S1,P7,T250,N42");
+    TEST_ASSERT_EQUAL_UINT8(Command::G1, command.command);
+    TEST_ASSERT_TRUE(command.HasAxis(AXIS_X));
+    TEST_ASSERT_TRUE(command.HasAxis(AXIS_R));
+    TEST_ASSERT_EQUAL_INT32(120, command.axes[AXIS_X]);
+    TEST_ASSERT_EQUAL_INT32(-45, command.axes[AXIS_R]);
+    TEST_ASSERT_TRUE(command.hasF);
+    TEST_ASSERT_EQUAL_INT32(3000, command.F);
+    TEST_ASSERT_EQUAL_INT32(1, command.S);
+    TEST_ASSERT_EQUAL_INT32(7, command.P);
+    TEST_ASSERT_EQUAL_INT32(250, command.T);
+    TEST_ASSERT_TRUE(command.hasN);
+    TEST_ASSERT_EQUAL_INT32(42, command.N);
+}
+
+void test_axes_that_are_not_given_are_not_set(){
+    GCode command = parse("G1,R90");
+    TEST_ASSERT_FALSE(command.HasAxis(AXIS_X));
+    TEST_ASSERT_TRUE(command.HasAxis(AXIS_R));
+    TEST_ASSERT_EQUAL_INT32(0, command.axes[AXIS_X]);
+}
+
+void test_lowercase_is_folded(){
+    GCode command = parse("g1,x10,f600");
+    TEST_ASSERT_EQUAL_UINT8(Command::G1, command.command);
+    TEST_ASSERT_EQUAL_INT32(10, command.axes[AXIS_X]);
+    TEST_ASSERT_EQUAL_INT32(600, command.F);
+}
+
+void test_decimal_part_is_ignored(){
+    GCode command = parse("G1,X12.75,F+300");
+    TEST_ASSERT_EQUAL_UINT8(Command::G1, command.command);
+    TEST_ASSERT_EQUAL_INT32(12, command.axes[AXIS_X]);
+    TEST_ASSERT_EQUAL_INT32(300, command.F);
+}
+
+void test_trailing_comma_is_ignored(){
+    GCode command = parse("M42,P3,S1,");
+    TEST_ASSERT_EQUAL_UINT8(Command::M42, command.command);
+    TEST_ASSERT_EQUAL_INT32(3, command.P);
+    TEST_ASSERT_EQUAL_INT32(1, command.S);
+}
+
+void test_commands_that_share_digits_are_not_mixed_up(){
+    TEST_ASSERT_EQUAL_UINT8(Command::M1, parse("M1").command);
+    TEST_ASSERT_EQUAL_UINT8(Command::M114, parse("M114").command);
+    TEST_ASSERT_EQUAL_UINT8(Command::INVALID, parse("M11").command);
+    TEST_ASSERT_EQUAL_UINT8(Command::INVALID, parse("M1145").command);
+}
+
+void test_unknown_commands_are_invalid(){
+    TEST_ASSERT_EQUAL_UINT8(Command::INVALID, parse("").command);
+    TEST_ASSERT_EQUAL_UINT8(Command::INVALID, parse("G").command);
+    TEST_ASSERT_EQUAL_UINT8(Command::INVALID, parse("X1").command);
+    TEST_ASSERT_EQUAL_UINT8(Command::INVALID, parse("G1A").command);
+    TEST_ASSERT_EQUAL_UINT8(Command::INVALID, parse("M99999").command);
+}
+
+void test_unknown_value_makes_the_command_invalid_but_keeps_its_line_number(){
+    GCode command = parse("G1,Q5,N12");
+    TEST_ASSERT_EQUAL_UINT8(Command::INVALID, command.command);
+    TEST_ASSERT_TRUE(command.hasN);
+    TEST_ASSERT_EQUAL_INT32(12, command.N);
+}
+
+void test_invalid_command_keeps_its_line_number(){
+    GCode command = parse("Z9,N3");
+    TEST_ASSERT_EQUAL_UINT8(Command::INVALID, command.command);
+    TEST_ASSERT_EQUAL_INT32(3, command.N);
+}
+
+void test_only_the_given_length_is_read(){
+    const char message[] = "M114,X5";
+    GCode command = GCodeParser::Parse(message, 4);
+    TEST_ASSERT_EQUAL_UINT8(Command::M114, command.command);
+    TEST_ASSERT_FALSE(command.HasAxis(AXIS_X));
+}
+
+void test_format_writes_what_parse_reads(){
+    char buffer[64];
+    uint16_t length = GCodeParser::Format(parse("g1,f3000,r-45,x120,n9"), buffer, sizeof(buffer));
+    // the values come out in order, and the line number is left off
+    TEST_ASSERT_EQUAL_STRING("G1,X120,R-45,F3000", buffer);
+    TEST_ASSERT_EQUAL_UINT16(strlen(buffer), length);
+
+    GCode command = parse(buffer);
+    TEST_ASSERT_EQUAL_UINT8(Command::G1, command.command);
+    TEST_ASSERT_EQUAL_INT32(120, command.axes[AXIS_X]);
+    TEST_ASSERT_EQUAL_INT32(-45, command.axes[AXIS_R]);
+    TEST_ASSERT_EQUAL_INT32(3000, command.F);
+}
+
+void test_format_returns_0_if_it_does_not_fit(){
+    char buffer[8];
+    TEST_ASSERT_EQUAL_UINT16(0, GCodeParser::Format(parse("G1,X120,F3000"), buffer, sizeof(buffer)));
+}
+
+int main(int argc, char **argv){
+    UNITY_BEGIN();
+    RUN_TEST(test_command_without_values);
+    RUN_TEST(test_every_value_is_read);
+    RUN_TEST(test_axes_that_are_not_given_are_not_set);
+    RUN_TEST(test_lowercase_is_folded);
+    RUN_TEST(test_decimal_part_is_ignored);
+    RUN_TEST(test_trailing_comma_is_ignored);
+    RUN_TEST(test_commands_that_share_digits_are_not_mixed_up);
+    RUN_TEST(test_unknown_commands_are_invalid);
+    RUN_TEST(test_unknown_value_makes_the_command_invalid_but_keeps_its_line_number);
+    RUN_TEST(test_invalid_command_keeps_its_line_number);
+    RUN_TEST(test_only_the_given_length_is_read);
+    RUN_TEST(test_format_writes_what_parse_reads);
+    RUN_TEST(test_format_returns_0_if_it_does_not_fit);
+    return UNITY_END();
+}
@@ -0,0 +1,113 @@
+/**
+ * @file test_gcode_queue.cpp
+ * @brief Tests for the GCodeQueue ring buffer
+ * @version 1.0.0
+ * @author Quinn Henthorne. Contact: quinn.henthorne@gmail.com
+*/
+
+#include <unity.h>
+#include "GCodeQueue.h"
+
+using namespace GCodeDefinitions;
+
+/**
+ * @brief Make a command that can be told apart from the others
+ * @param number The line number to give it
+*/
+GCode numbered(int32_t number){
+    GCode command;
+    command.command = Command::G1;
+    command.N = number;
+    command.hasN = true;
+    command.SetAxis(AXIS_X, number * 10);
+    return command;
+}
+
+void setUp(){}
+
+void tearDown(){}
+
+void test_empty_queue_has_nothing_to_take(){
+    GCodeQueue<4> queue;
+    TEST_ASSERT_EQUAL_UINT16(0, queue.size());
+    TEST_ASSERT_NULL(queue.peek());
+    TEST_ASSERT_NULL(queue.pop());
+}
+
+void test_commands_come_out_in_order(){
+    GCodeQueue<4> queue;
+    for(int32_t i = 0; i < 3; i++){
+        TEST_ASSERT_TRUE(queue.push(numbered(i)));
+    }
+    TEST_ASSERT_EQUAL_UINT16(3, queue.size());
+    for(int32_t i = 0; i < 3; i++){
+        GCode *command = queue.pop();
+        TEST_ASSERT_NOT_NULL(command);
+        TEST_ASSERT_EQUAL_INT32(i, command->N);
+        TEST_ASSERT_EQUAL_INT32(i * 10, command->axes[AXIS_X]);
+        TEST_ASSERT_TRUE(command->HasAxis(AXIS_X));
+    }
+    TEST_ASSERT_EQUAL_UINT16(0, queue.size());
+}
+
+void test_peek_does_not_take_the_command(){
+    GCodeQueue<4> queue;
+    queue.push(numbered(7));
+    TEST_ASSERT_EQUAL_INT32(7, queue.peek()->N);
+    TEST_ASSERT_EQUAL_UINT16(1, queue.size());
+    TEST_ASSERT_EQUAL_INT32(7, queue.pop()->N);
+    TEST_ASSERT_NULL(queue.peek());
+}
+
+void test_full_queue_refuses_more(){
+    GCodeQueue<4> queue;
+    TEST_ASSERT_EQUAL_UINT16(4, queue.max_size());
+    for(int32_t i = 0; i < 4; i++){
+        TEST_ASSERT_TRUE(queue.push(numbered(i)));
+    }
+    TEST_ASSERT_FALSE(queue.push(numbered(4)));
+    TEST_ASSERT_EQUAL_UINT16(4, queue.size());
+    // the command that didn't fit is gone, and the ones that did are untouched
+    TEST_ASSERT_EQUAL_INT32(0, queue.pop()->N);
+    TEST_ASSERT_TRUE(queue.push(numbered(5)));
+    for(int32_t expected : {1, 2, 3, 5}){
+        TEST_ASSERT_EQUAL_INT32(expected, queue.pop()->N);
+    }
+}
+
+void test_order_is_kept_as_the_counters_wrap(){
+    GCodeQueue<4> queue;
+    // the counters are 16 bits, so go round them more than once
+    int32_t next = 0;
+    for(uint32_t i = 0; i < 70000; i++){
+        TEST_ASSERT_TRUE(queue.push(numbered(i)));
+        if(queue.size() == 3){
+            TEST_ASSERT_EQUAL_INT32(next++, queue.pop()->N);
+        }
+    }
+    while(queue.size() > 0){
+        TEST_ASSERT_EQUAL_INT32(next++, queue.pop()->N);
+    }
+    TEST_ASSERT_EQUAL_INT32(70000, next);
+}
+
+void test_popped_command_is_kept_until_the_next_pop(){
+    GCodeQueue<2> queue;
+    queue.push(numbered(1));
+    GCode *command = queue.pop();
+    // the slot it came from is free again, so filling the queue mustn't change it
+    queue.push(numbered(2));
+    queue.push(numbered(3));
+    TEST_ASSERT_EQUAL_INT32(1, command->N);
+}
+
+int main(int argc, char **argv){
+    UNITY_BEGIN();
+    RUN_TEST(test_empty_queue_has_nothing_to_take);
+    RUN_TEST(test_commands_come_out_in_order);
+    RUN_TEST(test_peek_does_not_take_the_command);
+    RUN_TEST(test_full_queue_refuses_more);
+    RUN_TEST(test_order_is_kept_as_the_counters_wrap);
+    RUN_TEST(test_popped_command_is_kept_until_the_next_pop);
+    return UNITY_END();
+}
@@ -0,0 +1,139 @@
+/**
+ * @file test_gcode_server.cpp
+ * @brief Tests for the GCodeServer on the PC, where it listens on 127.0.0.1 with the loopback socket
+ * @details The tests connect to the server with a plain TCP socket, the way a host would over Ethernet
+ * @version 1.0.0
+ * @author Quinn Henthorne. Contact: quinn.henthorne@gmail.com
+*/
+
+#include <unity.h>
+#include <string.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include "MACHINE-PARAMETERS.h"
+#include "GCodeServer.h"
+
+using namespace GCodeDefinitions;
+
+// a port nothing else should be on, so the tests don't clash with a simulator that's running
+#define TEST_PORT 23231
+// the most server updates to wait for something
+#define MAX_UPDATES 1000
+
+GCodeServer server(ETHERNET_CONFIGURATION, TEST_PORT);
+int host = -1; // the host's end of the connection
+
+/**
+ * @brief Update the server until a condition is met
+ * @param condition Checked after every update
+ * @return true if the condition was met in time
+*/
+bool updateUntil(bool (*condition)()){
+    for(uint16_t i = 0; i < MAX_UPDATES; i++){
+        server.Update();
+        if(condition()){
+            return true;
+        }
+        usleep(100);
+    }
+    return false;
+}
+
+/**
+ * @brief Read a line from the server as the host
+ * @param line Where to put the line, without its line ending
+ * @param size The size of line
+ * @return true if a whole line came in time
+*/
+bool readLine(char *line, size_t size){
+    size_t length = 0;
+    for(uint16_t i = 0; i < MAX_UPDATES && length < size - 1; i++){
+        server.Update();
+        char c;
+        if(recv(host, &c, 1, MSG_DONTWAIT) != 1){
+            usleep(100);
+            continue;
+        }
+        if(c == '\n'){
+            // take the \r off too
+            line[length > 0 && line[length - 1] == '\r' ? length - 1 : length] = '\0';
+            return true;
+        }
+        line[length++] = c;
+    }
+    line[length] = '\0';
+    return false;
+}
+
+/**
+ * @brief Send a string from the host
+ * @param text The string
+*/
+void sendText(const char *text){
+    send(host, text, strlen(text), 0);
+}
+
+bool isConnected(){ return server.IsConnected(); }
+bool isDisconnected(){ return !server.IsConnected(); }
+bool hasCommand(){ return server.GetMessage().PeekGCode() != NULL; }
+
+void setUp(){}
+
+void tearDown(){}
+
+void test_server_listens(){
+    TEST_ASSERT_TRUE(server.Begin());
+}
+
+void test_port_in_use_is_reported(){
+    GCodeServer other(ETHERNET_CONFIGURATION, TEST_PORT);
+    TEST_ASSERT_FALSE(other.Begin());
+}
+
+void test_host_connects(){
+    host = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(TEST_PORT);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    TEST_ASSERT_EQUAL_INT(0, connect(host, reinterpret_cast<sockaddr *>(&address), sizeof(address)));
+    TEST_ASSERT_TRUE(updateUntil(isConnected));
+}
+
+void test_command_is_queued_and_acked(){
+    sendText("!G1,X25,F3000,N0;");
+    TEST_ASSERT_TRUE(updateUntil(hasCommand));
+    GCode *command = server.GetMessage().PopGCode();
+    TEST_ASSERT_EQUAL_UINT8(Command::G1, command->command);
+    TEST_ASSERT_EQUAL_INT32(25, command->axes[AXIS_X]);
+
+    char line[64];
+    TEST_ASSERT_TRUE(readLine(line, sizeof(line)));
+    TEST_ASSERT_EQUAL_STRING_LEN("!ACK,N0,", line, 8);
+}
+
+void test_reply_goes_to_the_host(){
+    server.GetMessage().Reply("!M114,X%d,R%d;", 25, 0);
+    char line[64];
+    TEST_ASSERT_TRUE(readLine(line, sizeof(line)));
+    TEST_ASSERT_EQUAL_STRING("!M114,X25,R0;", line);
+}
+
+void test_host_disconnects(){
+    close(host);
+    host = -1;
+    TEST_ASSERT_TRUE(updateUntil(isDisconnected));
+}
+
+int main(int argc, char **argv){
+    UNITY_BEGIN();
+    RUN_TEST(test_server_listens);
+    RUN_TEST(test_port_in_use_is_reported);
+    RUN_TEST(test_host_connects);
+    RUN_TEST(test_command_is_queued_and_acked);
+    RUN_TEST(test_reply_goes_to_the_host);
+    RUN_TEST(test_host_disconnects);
+    return UNITY_END();
+}
@@ -0,0 +1,150 @@
+/**
+ * @file test_gcode_throughput.cpp
+ * @brief A benchmark of how many commands a second the parser and the command queue take, on the example recipes
+ * @details Every command in the recipes is parsed where it sits and pushed through a queue, over and over, against the
+ * PC's clock. The result is compared with the rate commands can come in over serial, which the parser has to keep up with.
+ * Run it with pio test -e native -f test_gcode_throughput -v to see the numbers.
+ * @version 1.0.0
+ * @author Quinn Henthorne. Contact: quinn.henthorne@gmail.com
+*/
+
+#include <unity.h>
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+#include "MACHINE-PARAMETERS.h"
+#include "GCodeParser.h"
+#include "GCodeQueue.h"
+
+using namespace GCodeDefinitions;
+
+#define MAX_COMMANDS 64
+#define MAX_COMMAND_LENGTH 64
+#define BENCHMARK_PASSES 100000
+
+// the recipes are found from the project folder, so the benchmark runs from anywhere. The native environment passes it in,
+// otherwise it is worked out from where this file is
+#ifndef PROJECT_DIR
+#define PROJECT_DIR NULL
+#endif
+// the path of this file in the project folder
+#define TEST_FILE "test/test_gcode_throughput/test_gcode_throughput.cpp"
+
+const char *const RECIPES[] = {
+    "Example Recipes/Test recipe.txt",
+    "Example Recipes/Test Fill Up Queue.txt",
+};
+
+// the commands from the recipes, without their start and end markers
+char commands[MAX_COMMANDS][MAX_COMMAND_LENGTH];
+uint16_t commandLengths[MAX_COMMANDS];
+uint8_t commandCount = 0;
+uint8_t invalidCount = 0; // the commands the parser doesn't know
+uint32_t characterCount = 0; // every character the commands take on the wire, markers included
+
+/**
+ * @brief Get the path of a file in the project folder
+ * @param name The path from the project folder
+ * @param path Where to put the full path
+ * @param size The size of path
+*/
+void projectPath(const char *name, char *path, size_t size){
+    const char *projectDir = PROJECT_DIR;
+    int projectDirLength = projectDir == NULL ? 0 : strlen(projectDir);
+    if(projectDir == NULL){
+        // __FILE__ ends with this file's path in the project folder. Whatever comes before it is the project folder
+        projectDir = __FILE__;
+        int fileLength = strlen(__FILE__);
+        int testFileLength = strlen(TEST_FILE);
+        projectDirLength = fileLength >= testFileLength ? fileLength - testFileLength : 0;
+    }
+    if(projectDirLength == 0){
+        snprintf(path, size, "%s", name);
+        return;
+    }
+    // the folder might or might not end with a separator
+    const char *separator = projectDir[projectDirLength - 1] == '/' ? "" : "/";
+    snprintf(path, size, "%.*s%s%s", projectDirLength, projectDir, separator, name);
+}
+
+/**
+ * @brief Read the commands out of a recipe, the way SerialMessage picks them out of what it receives
+ * @param path The recipe file
+ * @return true if the file could be read
+*/
+bool loadRecipe(const char *name){
+    char path[512];
+    projectPath(name, path, sizeof(path));
+    FILE *file = fopen(path, "r");
+    if(file == NULL){
+        return false;
+    }
+    char line[256];
+    while(fgets(line, sizeof(line), file) != NULL && commandCount < MAX_COMMANDS){
+        // anything outside the markers is a comment
+        const char *start = strchr(line, '!');
+        const char *end = start == NULL ? NULL : strchr(start, ';');
+        if(end == NULL || end - start - 1 >= MAX_COMMAND_LENGTH){
+            continue;
+        }
+        uint16_t length = end - start - 1;
+        memcpy(commands[commandCount], start + 1, length);
+        commands[commandCount][length] = '\0';
+        commandLengths[commandCount] = length;
+        characterCount += length + 2;
+        if(GCodeParser::Parse(commands[commandCount], length).command == Command::INVALID){
+            invalidCount++;
+        }
+        commandCount++;
+    }
+    fclose(file);
+    return true;
+}
+
+void setUp(){}
+
+void tearDown(){}
+
+void test_recipes_are_read(){
+    for(const char *recipe : RECIPES){
+        TEST_ASSERT_TRUE_MESSAGE(loadRecipe(recipe), recipe);
+    }
+    TEST_ASSERT_GREATER_THAN_UINT32(invalidCount, commandCount);
+}
+
+void test_parse_and_queue_throughput(){
+    GCodeQueue<> queue;
+    uint32_t validCommands = 0;
+    auto start = std::chrono::steady_clock::now();
+    for(uint32_t pass = 0; pass < BENCHMARK_PASSES; pass++){
+        for(uint8_t i = 0; i < commandCount; i++){
+            GCode command = GCodeParser::Parse(commands[i], commandLengths[i]);
+            if(command.command == Command::INVALID){
+                continue;
+            }
+            queue.push(command);
+            validCommands += queue.pop() != NULL;
+        }
+    }
+    auto end = std::chrono::steady_clock::now();
+    double seconds = std::chrono::duration<double>(end - start).count();
+
+    uint32_t parsed = BENCHMARK_PASSES * commandCount;
+    double commandsPerSecond = parsed / seconds;
+    // 10 bits a character on the wire
+    double serialCommandsPerSecond = SERIAL_BAUD_RATE / 10.0 * commandCount / characterCount;
+    char message[160];
+    snprintf(message, sizeof(message), "%lu commands in %.3f s: %.0f commands/s, %.0f ns/command. Serial brings in %.0f commands/s",
+        static_cast<unsigned long>(parsed), seconds, commandsPerSecond, seconds * 1e9 / parsed, serialCommandsPerSecond);
+    TEST_MESSAGE(message);
+
+    TEST_ASSERT_EQUAL_UINT32(BENCHMARK_PASSES * (commandCount - invalidCount), validCommands);
+    TEST_ASSERT_TRUE(commandsPerSecond > serialCommandsPerSecond);
+}
+
+int main(int argc, char **argv){
+    UNITY_BEGIN();
+    RUN_TEST(test_recipes_are_read);
+    RUN_TEST(test_parse_and_queue_throughput);
+    return UNITY_END();
+}
@@ -0,0 +1,90 @@
+/**
+ * @file test_histogram.cpp
+ * @brief Tests for the Histogram's buckets and its report
+ * @version 1.0.0
+ * @author Quinn Henthorne. Contact: quinn.henthorne@gmail.com
+*/
+
+#include <unity.h>
+#include <string>
+#include "Histogram.h"
+
+// keeps everything printed to it, so a report can be checked
+class CapturePrint : public Print{
+    public:
+        std::string text;
+        size_t writes{0}; // the number of calls to write, so we can check a report goes out in one piece
+
+        size_t write(uint8_t byte) override{
+            this->text += static_cast<char>(byte);
+            this->writes++;
+            return 1;
+        }
+
+        size_t write(const uint8_t *buffer, size_t size) override{
+            this->text.append(reinterpret_cast<const char *>(buffer), size);
+            this->writes++;
+            return size;
+        }
+};
+
+void setUp(){}
+
+void tearDown(){}
+
+void test_empty_report(){
+    Histogram histogram;
+    CapturePrint output;
+    histogram.Report(output, "M881", "LOOP");
+    TEST_ASSERT_EQUAL_STRING("!M881,LOOP,N0,A0,M0,B0:0:0:0:0:0:0:0:0:0:0:0:0:0:0:0;\r\n", output.text.c_str());
+}
+
+void test_buckets_double_in_width(){
+    Histogram histogram;
+    // bucket 0 is under 1us, and bucket n is from 2^(n-1) up to 2^n us
+    for(uint32_t time : {0u, 1u, 2u, 3u, 4u, 7u, 8u, 1000u}){
+        histogram.Record(time);
+    }
+    CapturePrint output;
+    histogram.Report(output, "M881", "T");
+    TEST_ASSERT_EQUAL_STRING("!M881,T,N8,A128,M1000,B1:1:2:2:1:0:0:0:0:0:1:0:0:0:0:0;\r\n", output.text.c_str());
+}
+
+void test_long_times_go_in_the_last_bucket(){
+    Histogram histogram;
+    histogram.Record(1 << (HISTOGRAM_BUCKETS - 2));
+    histogram.Record(UINT32_MAX);
+    CapturePrint output;
+    histogram.Report(output, "M881", "T");
+    TEST_ASSERT_EQUAL_STRING("!M881,T,N2,A2147491839,M4294967295,B0:0:0:0:0:0:0:0:0:0:0:0:0:0:0:2;\r\n", output.text.c_str());
+}
+
+void test_report_is_one_write(){
+    Histogram histogram;
+    for(uint32_t i = 0; i < 100; i++){
+        histogram.Record(i * 37);
+    }
+    CapturePrint output;
+    histogram.Report(output, "M881", "STEP_X");
+    TEST_ASSERT_EQUAL_UINT32(1, output.writes);
+}
+
+void test_reset_clears_every_count(){
+    Histogram histogram;
+    histogram.Record(5);
+    histogram.Record(50000);
+    histogram.Reset();
+    CapturePrint output;
+    histogram.Report(output, "M881", "I2C");
+    TEST_ASSERT_EQUAL_STRING("!M881,I2C,N0,A0,M0,B0:0:0:0:0:0:0:0:0:0:0:0:0:0:0:0;\r\n", output.text.c_str());
+}
+
+int main(int argc, char **argv){
+    UNITY_BEGIN();
+    RUN_TEST(test_empty_report);
+    RUN_TEST(test_buckets_double_in_width);
+    RUN_TEST(test_long_times_go_in_the_last_bucket);
+    RUN_TEST(test_report_is_one_write);
+    RUN_TEST(test_reset_clears_every_count);
+    return UNITY_END();
+}
@@ -0,0 +1,265 @@
+/**
+ * @file test_motion_planner.cpp
+ * @brief Tests for the MotionPlanner's junction speeds and ramps, worked out the way the recipe compiler does it
+ * @version 1.0.0
+ * @author Quinn Henthorne. Contact: quinn.henthorne@gmail.com
+*/
+
+#include <unity.h>
+#include "MACHINE-PARAMETERS.h"
+#include "MotionPlanner.h"
+
+// the firmware's motors. Nothing here steps them, so they never touch the bus
+StepperMotor linearMotor(LINEAR_MOTOR_CONFIGURATION);
+StepperMotor rotationMotor(ROTATION_MOTOR_CONFIGURATION);
+StepperMotor *const motors[MOTION_PLANNER_AXES] = {&linearMotor, &rotationMotor};
+const float maxJerk[MOTION_PLANNER_AXES] = {LINEAR_MOTOR_MAX_JERK_MM_PER_MIN, ROTATION_MOTOR_MAX_JERK};
+
+// the acceleration of the linear axis in steps per second^2
+const float LINEAR_ACCELERATION = LINEAR_MOTOR_MAX_ACCELERATION_MM_PER_MIN_PER_MIN * STEPS_PER_MM / 3600.0f;
+
+/**
+ * @brief Plan a move of the linear axis
+ * @param planner The planner
+ * @param x Where to move to in mm
+ * @param feedRate The feed rate in mm per minute. 0 for the last one given
+ * @return true if the move was added
+*/
+bool moveX(MotionPlanner &planner, int32_t x, float feedRate){
+    const int32_t target[MOTION_PLANNER_AXES] = {x, 0};
+    return planner.AddMove(target, feedRate, false, 1 << 0);
+}
+
+/**
+ * @brief Work out the interval of a rate the way the planner does
+ * @param rate The rate in steps per second
+ * @return The interval in 1/256 us
+*/
+uint32_t interval(float rate){
+    return static_cast<uint32_t>(1000000.0f / rate * (1 << RAMP_FRACTION_BITS));
+}
+
+void setUp(){
+    for(StepperMotor *motor : motors){
+        motor->SetCurrentPosition(0);
+        motor->SetTargetPosition(0);
+    }
+}
+
+void tearDown(){}
+
+void test_single_move_starts_and_ends_at_a_stop(){
+    MotionPlanner planner(motors, maxJerk);
+    TEST_ASSERT_TRUE(moveX(planner, 200, 30000));
+    MotionSegment segment;
+    TEST_ASSERT_TRUE(planner.NextSegment(segment));
+    TEST_ASSERT_EQUAL_INT32(200 * STEPS_PER_MM, segment.steps[0]);
+    TEST_ASSERT_EQUAL_INT32(0, segment.steps[1]);
+    TEST_ASSERT_EQUAL_UINT32(200 * STEPS_PER_MM, segment.stepEventCount);
+    TEST_ASSERT_EQUAL_INT32(0, segment.initialRampStep);
+    TEST_ASSERT_EQUAL_UINT32(0, segment.exitInterval);
+    TEST_ASSERT_EQUAL_UINT32(interval(30000 * STEPS_PER_MM / 60.0f), segment.cruiseInterval);
+    TEST_ASSERT_FALSE(planner.NextSegment(segment));
+    TEST_ASSERT_TRUE(planner.IsEmpty());
+}
+
+void test_long_move_slows_down_as_late_as_it_can(){
+    MotionPlanner planner(motors, maxJerk);
+    moveX(planner, 200, 30000);
+    MotionSegment segment;
+    planner.NextSegment(segment);
+    // it takes v^2 / 2a steps to stop from the cruise rate
+    float rate = 30000 * STEPS_PER_MM / 60.0f;
+    uint32_t decelerateSteps = static_cast<uint32_t>(rate * rate / (2.0f * LINEAR_ACCELERATION));
+    TEST_ASSERT_UINT32_WITHIN(1, segment.stepEventCount - decelerateSteps, segment.decelerateAfter);
+}
+
+void test_short_move_slows_down_half_way(){
+    MotionPlanner planner(motors, maxJerk);
+    // too short to reach the cruise rate, so the ramps up and down meet in the middle
+    moveX(planner, 10, 30000);
+    MotionSegment segment;
+    planner.NextSegment(segment);
+    TEST_ASSERT_UINT32_WITHIN(1, segment.stepEventCount / 2, segment.decelerateAfter);
+}
+
+void test_moves_in_a_line_blend_together(){
+    MotionPlanner planner(motors, maxJerk);
+    moveX(planner, 100, 30000);
+    moveX(planner, 200, 30000);
+    MotionSegment first;
+    MotionSegment second;
+    planner.NextSegment(first);
+    planner.NextSegment(second);
+    // nothing changes speed at the junction, so the first move doesn't slow down at all
+    TEST_ASSERT_EQUAL_UINT32(first.cruiseInterval, first.exitInterval);
+    TEST_ASSERT_EQUAL_UINT32(first.stepEventCount, first.decelerateAfter);
+    TEST_ASSERT_GREATER_THAN(0, second.initialRampStep);
+    TEST_ASSERT_EQUAL_UINT32(second.cruiseInterval, second.initialInterval);
+    TEST_ASSERT_EQUAL_UINT32(0, second.exitInterval);
+}
+
+void test_reversal_slows_to_the_jerk_limit(){
+    MotionPlanner planner(motors, maxJerk);
+    moveX(planner, 100, 30000);
+    moveX(planner, 0, 30000);
+    MotionSegment first;
+    MotionSegment second;
+    planner.NextSegment(first);
+    planner.NextSegment(second);
+    TEST_ASSERT_EQUAL_INT32(-100 * STEPS_PER_MM, second.steps[0]);
+    // the speed changes by twice the exit rate, which can't be more than the jerk
+    float jerkRate = LINEAR_MOTOR_MAX_JERK_MM_PER_MIN * STEPS_PER_MM / 60.0f;
+    TEST_ASSERT_NOT_EQUAL(0, first.exitInterval);
+    TEST_ASSERT_GREATER_OR_EQUAL_UINT32(interval(jerkRate / 2) - 1, first.exitInterval);
+    TEST_ASSERT_LESS_THAN_UINT32(first.stepEventCount, first.decelerateAfter);
+}
+
+void test_speed_change_into_a_slower_move_is_within_the_jerk(){
+    MotionPlanner planner(motors, maxJerk);
+    moveX(planner, 100, 30000);
+    moveX(planner, 200, 3000);
+    MotionSegment first;
+    MotionSegment second;
+    planner.NextSegment(first);
+    planner.NextSegment(second);
+    // both moves are slowed by the same amount at the junction, until the step in speed is no more than the jerk
+    float jerkRate = LINEAR_MOTOR_MAX_JERK_MM_PER_MIN * STEPS_PER_MM / 60.0f;
+    float exitRate = 1000000.0f * (1 << RAMP_FRACTION_BITS) / first.exitInterval;
+    float entryRate = 1000000.0f * (1 << RAMP_FRACTION_BITS) / second.initialInterval;
+    TEST_ASSERT_GREATER_THAN_UINT32(second.cruiseInterval, second.initialInterval);
+    TEST_ASSERT_FLOAT_WITHIN(jerkRate * 0.01f, jerkRate, exitRate - entryRate);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 10.0f, exitRate / entryRate);
+}
+
+void test_move_without_a_feed_rate_is_refused_until_one_is_given(){
+    MotionPlanner planner(motors, maxJerk);
+    TEST_ASSERT_FALSE(moveX(planner, 100, 0));
+    TEST_ASSERT_TRUE(planner.IsEmpty());
+
+    // after that, a move without one goes at the last one given
+    TEST_ASSERT_TRUE(moveX(planner, 100, 6000));
+    TEST_ASSERT_TRUE(moveX(planner, 0, 0));
+    MotionSegment first;
+    MotionSegment second;
+    planner.NextSegment(first);
+    planner.NextSegment(second);
+    TEST_ASSERT_EQUAL_UINT32(first.cruiseInterval, second.cruiseInterval);
+    TEST_ASSERT_EQUAL_UINT32(interval(6000 * STEPS_PER_MM / 60.0f), second.cruiseInterval);
+}
+
+void test_feed_rate_is_capped_at_the_max_speed(){
+    MotionPlanner planner(motors, maxJerk);
+    moveX(planner, 1000, LINEAR_MOTOR_MAX_SPEED_MM_PER_MIN * 10.0f);
+    MotionSegment segment;
+    planner.NextSegment(segment);
+    TEST_ASSERT_GREATER_OR_EQUAL_UINT32(LINEAR_MOTOR_CONFIGURATION.minStepInterval, segment.cruiseInterval);
+}
+
+void test_axes_finish_together(){
+    MotionPlanner planner(motors, maxJerk);
+    const int32_t target[MOTION_PLANNER_AXES] = {10, 3};
+    TEST_ASSERT_TRUE(planner.AddMove(target, 600));
+
+    // step the whole move and count the steps of each axis. The rotation takes the most steps, so it leads
+    planner.AdvanceTime(0);
+    TEST_ASSERT_TRUE(planner.IsRunning());
+    uint32_t masterSteps = 0;
+    uint32_t steps[MOTION_PLANNER_AXES] = {};
+    while(planner.IsRunning() && masterSteps < 10000){
+        uint8_t axes = planner.Step();
+        masterSteps++;
+        for(uint8_t axis = 0; axis < MOTION_PLANNER_AXES; axis++){
+            steps[axis] += (axes >> axis) & 1;
+        }
+    }
+    TEST_ASSERT_EQUAL_UINT32(3 * STEPS_PER_REVOLUTION, masterSteps);
+    TEST_ASSERT_EQUAL_UINT32(10 * STEPS_PER_MM, steps[0]);
+    TEST_ASSERT_EQUAL_UINT32(3 * STEPS_PER_REVOLUTION, steps[1]);
+    TEST_ASSERT_TRUE(planner.IsEmpty());
+    TEST_ASSERT_EQUAL_INT32(10, linearMotor.GetCurrentPosition());
+    TEST_ASSERT_EQUAL_INT32(3, rotationMotor.GetCurrentPosition());
+}
+
+void test_event_goes_out_when_its_move_ends(){
+    MotionPlanner planner(motors, maxJerk);
+    // with nothing planned the change has to be made straight away
+    TEST_ASSERT_FALSE(planner.AddEvent(0x10, true));
+
+    moveX(planner, 10, 3000);
+    TEST_ASSERT_TRUE(planner.AddEvent(0x10, true));
+    moveX(planner, 20, 3000);
+    TEST_ASSERT_TRUE(planner.AddEvent(0x20, false));
+
+    MotionSegment segment;
+    planner.NextSegment(segment);
+    TEST_ASSERT_TRUE(planner.TakeEvent().IsEmpty());
+    planner.NextSegment(segment);
+    MotionEvent event = planner.TakeEvent();
+    TEST_ASSERT_EQUAL_HEX8(0x10, event.setMask);
+    TEST_ASSERT_EQUAL_HEX8(0x00, event.clearMask);
+    TEST_ASSERT_TRUE(planner.TakeEvent().IsEmpty());
+    TEST_ASSERT_FALSE(planner.NextSegment(segment));
+    event = planner.TakeEvent();
+    TEST_ASSERT_EQUAL_HEX8(0x00, event.setMask);
+    TEST_ASSERT_EQUAL_HEX8(0x20, event.clearMask);
+}
+
+void test_clear_makes_the_events_due(){
+    MotionPlanner planner(motors, maxJerk);
+    moveX(planner, 10, 3000);
+    planner.AddEvent(0x01, true);
+    moveX(planner, 20, 3000);
+    planner.AddEvent(0x01, false);
+    planner.Clear();
+    // both changes are made in order, so the pin ends up where the last command left it
+    MotionEvent event = planner.TakeEvent();
+    TEST_ASSERT_EQUAL_HEX8(0x00, event.setMask);
+    TEST_ASSERT_EQUAL_HEX8(0x01, event.clearMask);
+    TEST_ASSERT_TRUE(planner.IsEmpty());
+}
+
+void test_merge_lets_the_later_change_win(){
+    MotionEvent event{0x03, 0x0C};
+    event.Merge(MotionEvent{0x04, 0x01});
+    TEST_ASSERT_EQUAL_HEX8(0x06, event.setMask);
+    TEST_ASSERT_EQUAL_HEX8(0x09, event.clearMask);
+}
+
+void test_merge_keeps_pins_the_later_change_leaves_alone(){
+    MotionEvent event{0x10, 0x20};
+    event.Merge(MotionEvent{0x01, 0x02});
+    TEST_ASSERT_EQUAL_HEX8(0x11, event.setMask);
+    TEST_ASSERT_EQUAL_HEX8(0x22, event.clearMask);
+}
+
+void test_merge_with_nothing_changes_nothing(){
+    MotionEvent event{0x00, 0x00};
+    TEST_ASSERT_TRUE(event.IsEmpty());
+    event.Merge(MotionEvent{0x00, 0x00});
+    TEST_ASSERT_TRUE(event.IsEmpty());
+    event.Merge(MotionEvent{0x80, 0x00});
+    TEST_ASSERT_FALSE(event.IsEmpty());
+    event.Merge(MotionEvent{0x00, 0x00});
+    TEST_ASSERT_EQUAL_HEX8(0x80, event.setMask);
+    TEST_ASSERT_EQUAL_HEX8(0x00, event.clearMask);
+}
+
+int main(int argc, char **argv){
+    UNITY_BEGIN();
+    RUN_TEST(test_single_move_starts_and_ends_at_a_stop);
+    RUN_TEST(test_long_move_slows_down_as_late_as_it_can);
+    RUN_TEST(test_short_move_slows_down_half_way);
+    RUN_TEST(test_moves_in_a_line_blend_together);
+    RUN_TEST(test_reversal_slows_to_the_jerk_limit);
+    RUN_TEST(test_speed_change_into_a_slower_move_is_within_the_jerk);
+    RUN_TEST(test_move_without_a_feed_rate_is_refused_until_one_is_given);
+    RUN_TEST(test_feed_rate_is_capped_at_the_max_speed);
+    RUN_TEST(test_axes_finish_together);
+    RUN_TEST(test_event_goes_out_when_its_move_ends);
+    RUN_TEST(test_clear_makes_the_events_due);
+    RUN_TEST(test_merge_lets_the_later_change_win);
+    RUN_TEST(test_merge_keeps_pins_the_later_change_leaves_alone);
+    RUN_TEST(test_merge_with_nothing_changes_nothing);
+    return UNITY_END();
+}
@@ -0,0 +1,153 @@
+/**
+ * @file test_motion_system.cpp
+ * @brief Tests for the MotionSystem, stepped by the step scheduler off the virtual clock
+ * @version 1.0.0
+ * @author Quinn Henthorne. Contact: quinn.henthorne@gmail.com
+*/
+
+#include <unity.h>
+#include "MACHINE-PARAMETERS.h"
+#include "GCodeParser.h"
+#include "MotionSystem.h"
+#include "SimulatedMachine.h"
+
+// the same machine as the firmware, on the mock bus
+StepWaveform stepWaveform(&i2c_output_port_1, I2C_BUS_FREQUENCY);
+StepScheduler stepScheduler(&stepWaveform);
+MACHINE_MOTION_SYSTEM motion(&stepScheduler);
+// the motors on the other end of the bus, which only see the pins
+SimulatedMachine machine;
+
+/**
+ * @brief Parse a command the way it would come in over serial
+ * @param message The command without the start and end markers
+*/
+GCodeDefinitions::GCode parse(const char *message){
+    return GCodeParser::Parse(message, strlen(message));
+}
+
+/**
+ * @brief Run the machine until nothing is moving
+ * @param timeout The longest to wait in microseconds
+ * @return true if everything stopped in time
+*/
+bool waitForStop(uint64_t timeout){
+    uint64_t end = VirtualClock::Now() + timeout;
+    while(VirtualClock::Now() < end){
+        VirtualClock::Advance(1000);
+        if(!motion.IsMoving() && motion.GetPlanner().IsEmpty()){
+            return true;
+        }
+    }
+    return false;
+}
+
+void setUp(){
+    motion.SetAllPositions(0);
+}
+
+void tearDown(){}
+
+void test_planned_move_reaches_its_target(){
+    TEST_ASSERT_TRUE(motion.PlanMove(parse("G1,X20,F3000"), false));
+    TEST_ASSERT_TRUE(waitForStop(2000000));
+    TEST_ASSERT_EQUAL_INT32(20, motion.GetMotor(0).GetCurrentPosition());
+    TEST_ASSERT_EQUAL_INT32(20 * STEPS_PER_MM, motion.GetMotor(0).GetCurrentSteps());
+}
+
+void test_stop_in_a_planned_move_lets_the_next_move_run(){
+    TEST_ASSERT_TRUE(motion.PlanMove(parse("G1,X100,F3000"), false));
+    // stop somewhere in the middle, which is very unlikely to be on a whole mm
+    VirtualClock::Advance(700003);
+    TEST_ASSERT_TRUE(motion.IsMoving());
+    motion.Stop();
+    TEST_ASSERT_TRUE(waitForStop(100000));
+    int32_t stoppedSteps = motion.GetMotor(0).GetCurrentSteps();
+    TEST_ASSERT_GREATER_THAN(0, stoppedSteps);
+    TEST_ASSERT_LESS_THAN(100 * STEPS_PER_MM, stoppedSteps);
+
+    // the next move has to start from the step the motor stopped on and still end exactly on its target
+    TEST_ASSERT_TRUE(motion.PlanMove(parse("G1,X0,F3000"), false));
+    TEST_ASSERT_TRUE(waitForStop(3000000));
+    TEST_ASSERT_EQUAL_INT32(0, motion.GetMotor(0).GetCurrentSteps());
+
+    TEST_ASSERT_TRUE(motion.PlanMove(parse("G1,X10,F3000"), false));
+    TEST_ASSERT_TRUE(waitForStop(1000000));
+    TEST_ASSERT_EQUAL_INT32(10 * STEPS_PER_MM, motion.GetMotor(0).GetCurrentSteps());
+}
+
+void test_stop_in_a_relative_move_keeps_the_motor_where_it_stopped(){
+    TEST_ASSERT_TRUE(motion.PlanMove(parse("G1,X50,F3000"), true));
+    VirtualClock::Advance(300007);
+    motion.Stop();
+    TEST_ASSERT_TRUE(waitForStop(100000));
+    int32_t stoppedSteps = motion.GetMotor(0).GetCurrentSteps();
+    TEST_ASSERT_EQUAL_INT32(stoppedSteps, motion.GetMotor(0).GetTargetSteps());
+    TEST_ASSERT_FALSE(motion.IsMoving());
+}
+
+/**
+ * @brief Check that the machine took every step the motors counted, in the direction they counted it
+ * @param startSteps The steps of each axis of the machine when the motors were at 0
+*/
+void assertMachineMatchesMotors(const int32_t startSteps[MACHINE_AXIS_COUNT]){
+    for(uint8_t axis = 0; axis < MACHINE_AXIS_COUNT; axis++){
+        TEST_ASSERT_EQUAL_INT32(motion.GetMotor(axis).GetCurrentSteps(), machine.GetSteps(axis) - startSteps[axis]);
+    }
+}
+
+void test_planned_reversals_step_the_machine_the_right_way(){
+    // each move starts in the slot after the last one's final step, so the direction pins change right behind a step
+    int32_t startSteps[MACHINE_AXIS_COUNT];
+    for(uint8_t axis = 0; axis < MACHINE_AXIS_COUNT; axis++){
+        startSteps[axis] = machine.GetSteps(axis);
+    }
+    for(uint8_t i = 0; i < 5; i++){
+        TEST_ASSERT_TRUE(motion.PlanMove(parse("G1,X2,R1,F3000"), false));
+        TEST_ASSERT_TRUE(motion.PlanMove(parse("G1,X0,R0,F3000"), false));
+        TEST_ASSERT_TRUE(waitForStop(1000000));
+        TEST_ASSERT_EQUAL_INT32(0, motion.GetMotor(0).GetCurrentSteps());
+        assertMachineMatchesMotors(startSteps);
+    }
+}
+
+void test_direct_reversals_step_the_machine_the_right_way(){
+    // the new target is set between bursts, right after one that ended with the step pin low
+    PCF8574Device *expander = static_cast<PCF8574Device *>(I2C_BUS.GetDevice(i2c_output_port_1.GetAddress()));
+    StepperMotor &motor = motion.GetMotor(0);
+    int32_t startSteps[MACHINE_AXIS_COUNT];
+    for(uint8_t axis = 0; axis < MACHINE_AXIS_COUNT; axis++){
+        startSteps[axis] = machine.GetSteps(axis);
+    }
+    for(uint8_t i = 0; i < 5; i++){
+        motion.Move(parse("G1,X20,F3000"), false);
+        bool isStepLow = false;
+        for(uint16_t tick = 0; tick < 1000 && !isStepLow; tick++){
+            VirtualClock::Advance(stepScheduler.GetPeriod());
+            isStepLow = (expander->GetOutputs() & motor.GetStepPinMask()) == 0;
+        }
+        TEST_ASSERT_TRUE(isStepLow);
+        motion.Move(parse("G1,X0,F3000"), false);
+        TEST_ASSERT_TRUE(waitForStop(2000000));
+        TEST_ASSERT_EQUAL_INT32(0, motor.GetCurrentSteps());
+        assertMachineMatchesMotors(startSteps);
+    }
+}
+
+int main(int argc, char **argv){
+    VirtualClock::Set(0);
+    I2C_BUS.begin(SDA_PIN, SCL_PIN, I2C_BUS_FREQUENCY);
+    i2c_output_port_1.Begin();
+    machine.Begin();
+    motion.Begin(&stepWaveform);
+    stepWaveform.Init();
+    stepScheduler.Begin();
+
+    UNITY_BEGIN();
+    RUN_TEST(test_planned_move_reaches_its_target);
+    RUN_TEST(test_stop_in_a_planned_move_lets_the_next_move_run);
+    RUN_TEST(test_stop_in_a_relative_move_keeps_the_motor_where_it_stopped);
+    RUN_TEST(test_planned_reversals_step_the_machine_the_right_way);
+    RUN_TEST(test_direct_reversals_step_the_machine_the_right_way);
+    return UNITY_END();
+}
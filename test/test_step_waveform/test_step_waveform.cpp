@@ -0,0 +1,142 @@
+/**
+ * @file test_step_waveform.cpp
+ * @brief Tests for how late the StepWaveform puts steps on the pins, with bursts generated off the virtual clock
+ * @details Each image is held for one slot, so a step lands up to a slot after it was due, and one more if the pin
+ * is still low from the step before. Anything later than that comes from the burst itself starting late.
+ * @version 1.0.0
+ * @author Quinn Henthorne. Contact: quinn.henthorne@gmail.com
+*/
+
+#include <unity.h>
+#include "MACHINE-PARAMETERS.h"
+#include "StepWaveform.h"
+#include "StepScheduler.h"
+
+// the linear motor's pins, with no acceleration so every step interval is the same
+constexpr StepperMotorConfiguration CONFIGURATION(LINEAR_MOTOR_STEP_PIN, LINEAR_MOTOR_DIRECTION_PIN, LINEAR_MOTOR_ENABLE_PIN,
+    STEPS_PER_MM, LINEAR_MOTOR_MAX_SPEED_MM_PER_MIN, 0, false);
+// 3000 steps/s, which is a step every 3.7 slots at 100kHz
+#define TEST_STEP_RATE 3000
+#define TEST_SPEED (TEST_STEP_RATE * 60 / STEPS_PER_MM)
+
+StepperMotor motor(CONFIGURATION);
+StepWaveform stepWaveform(&i2c_output_port_1, I2C_BUS_FREQUENCY);
+
+// the latest a step can be when its burst starts on time
+const uint32_t MAX_ON_TIME_LATENESS = 2 * stepWaveform.GetSlotLength();
+
+/**
+ * @brief Generate bursts back to back, the way the step scheduler's timer would
+ * @param bursts The number of bursts
+ * @param lateEvery Start every nth burst late. 0 to start them all on time
+ * @param delay How late the late bursts start in microseconds
+*/
+void runBursts(uint32_t bursts, uint32_t lateEvery, uint32_t delay){
+    for(uint32_t i = 0; i < bursts; i++){
+        bool isLate = lateEvery != 0 && i % lateEvery == lateEvery - 1;
+        if(isLate){
+            VirtualClock::Advance(delay);
+        }
+        stepWaveform.Generate();
+        stepWaveform.Send();
+        VirtualClock::Advance(stepWaveform.GetBurstDuration());
+    }
+}
+
+void setUp(){
+    // start from a stop with the clock on a burst boundary
+    motor.Stop();
+    stepWaveform.Generate();
+    stepWaveform.GetStepLateness(0)->Reset();
+    motor.SetCurrentPosition(0);
+    motor.SetSpeed(TEST_SPEED);
+    motor.SetTargetSteps(INT32_MAX / 2);
+}
+
+void tearDown(){}
+
+void test_steps_on_time_are_at_most_two_slots_late(){
+    runBursts(1000, 0, 0);
+    Histogram *lateness = stepWaveform.GetStepLateness(0);
+    TEST_ASSERT_GREATER_THAN_UINT32(0, lateness->GetCount());
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(MAX_ON_TIME_LATENESS, lateness->GetMax());
+}
+
+void test_late_burst_adds_no_more_than_its_delay(){
+    // every 10th burst starts 1ms late, like a tick held up by a long interrupt
+    runBursts(1000, 10, 1000);
+    Histogram *lateness = stepWaveform.GetStepLateness(0);
+    TEST_ASSERT_GREATER_THAN_UINT32(MAX_ON_TIME_LATENESS, lateness->GetMax());
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(1000 + MAX_ON_TIME_LATENESS, lateness->GetMax());
+}
+
+void test_step_rate_is_kept_over_time(){
+    // a second of bursts. Each burst's slots are counted once, so no steps are lost or gained between bursts
+    uint64_t start = VirtualClock::Now();
+    runBursts(347, 0, 0);
+    uint64_t elapsed = VirtualClock::Now() - start;
+    int32_t expected = static_cast<int32_t>(elapsed * TEST_STEP_RATE / 1000000);
+    // a step can still be waiting in the last slot
+    TEST_ASSERT_INT32_WITHIN(2, expected, motor.GetCurrentSteps());
+}
+
+void test_late_bursts_never_add_steps(){
+    // the time between late bursts is counted once too. A motor only catches up one step, so it can fall behind but never ahead
+    uint64_t start = VirtualClock::Now();
+    runBursts(347, 5, 500);
+    uint64_t elapsed = VirtualClock::Now() - start;
+    int32_t expected = static_cast<int32_t>(elapsed * TEST_STEP_RATE / 1000000);
+    TEST_ASSERT_LESS_OR_EQUAL_INT32(expected + 1, motor.GetCurrentSteps());
+    // a late burst can drop the part of a step that had built up, but no more than one step for each late burst
+    int32_t onTime = static_cast<int32_t>(347 * stepWaveform.GetBurstDuration() * TEST_STEP_RATE / 1000000);
+    TEST_ASSERT_GREATER_OR_EQUAL_INT32(onTime - 347 / 5, motor.GetCurrentSteps());
+}
+
+void test_scheduler_leaves_the_bus_free(){
+    // the mock bus takes no virtual time to send a burst, so the time it would hold the real bus is counted from its clocks
+    StepScheduler stepScheduler(&stepWaveform);
+    uint64_t busyTime = I2C_BUS.GetBusyTime();
+    runBursts(100, 0, 0);
+    uint32_t burstBusyTime = static_cast<uint32_t>((I2C_BUS.GetBusyTime() - busyTime) / 100);
+    TEST_ASSERT_UINT32_WITHIN(1, stepWaveform.GetTransactionDuration(STEP_WAVEFORM_BURST_LENGTH), burstBusyTime);
+    // a burst is on the bus for longer than it is on the pins, and the period has to cover that and the free transactions
+    TEST_ASSERT_GREATER_THAN_UINT32(stepWaveform.GetBurstDuration(), burstBusyTime);
+    TEST_ASSERT_GREATER_OR_EQUAL_UINT32(burstBusyTime + STEP_SCHEDULER_FREE_TRANSACTIONS * stepWaveform.GetTransactionDuration(1),
+        stepScheduler.GetPeriod());
+}
+
+void test_scheduler_ticks_on_time(){
+    // this has to run last. From here on the scheduler's timer generates the bursts
+    StepScheduler stepScheduler(&stepWaveform);
+    stepScheduler.Begin();
+    uint32_t period = stepScheduler.GetPeriod();
+    // the first burst counts the time since the waveform was last paused, so it starts measuring after that
+    VirtualClock::Advance(period);
+    stepWaveform.GetStepLateness(0)->Reset();
+    VirtualClock::Advance(1000 * period);
+    TEST_ASSERT_EQUAL_UINT32(1001, stepScheduler.GetTickCount());
+    TEST_ASSERT_EQUAL_UINT32(0, stepScheduler.GetMissedTicks());
+    TEST_ASSERT_EQUAL_UINT32(0, stepScheduler.GetMaxLateness());
+    // a step that comes due while the bus is left free waits for the next burst
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(period - stepWaveform.GetBurstDuration() + MAX_ON_TIME_LATENESS,
+        stepWaveform.GetStepLateness(0)->GetMax());
+    stepScheduler.GetTimer()->End();
+}
+
+int main(int argc, char **argv){
+    VirtualClock::Set(0);
+    I2C_BUS.begin(SDA_PIN, SCL_PIN, I2C_BUS_FREQUENCY);
+    i2c_output_port_1.Begin();
+    motor.Init();
+    stepWaveform.AddMotor(&motor);
+    stepWaveform.Init();
+
+    UNITY_BEGIN();
+    RUN_TEST(test_steps_on_time_are_at_most_two_slots_late);
+    RUN_TEST(test_late_burst_adds_no_more_than_its_delay);
+    RUN_TEST(test_step_rate_is_kept_over_time);
+    RUN_TEST(test_late_bursts_never_add_steps);
+    RUN_TEST(test_scheduler_leaves_the_bus_free);
+    RUN_TEST(test_scheduler_ticks_on_time);
+    return UNITY_END();
+}
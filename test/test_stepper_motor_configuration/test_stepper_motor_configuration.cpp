@@ -0,0 +1,89 @@
+/**
+ * @file test_stepper_motor_configuration.cpp
+ * @brief Tests for the fixed point constants a StepperMotorConfiguration works out when the firmware is built
+ * @version 1.0.0
+ * @author Quinn Henthorne. Contact: quinn.henthorne@gmail.com
+*/
+
+#include <unity.h>
+#include <math.h>
+#include "MACHINE-PARAMETERS.h"
+#include "StepperMotor.h"
+
+I2CPort port(0x20, &I2C_BUS);
+
+// 5 steps per unit, 600 units per minute and 3600 units per minute^2 is 50 steps/s and 5 steps/s^2
+constexpr StepperMotorConfiguration CONFIGURATION(I2CPin(3, &port), I2CPin(4, &port), I2CPin(7, &port), 5, 600, 3600, false);
+constexpr StepperMotorConfiguration NO_ACCELERATION(I2CPin(0, &port), I2CPin(1, &port), I2CPin(2, &port), 2.5f, 150.5f, 0, true);
+
+// they have to be worked out by the compiler, since the firmware only uses them as constants
+static_assert(CONFIGURATION.fixedStepsPerUnit == 5UL << STEP_RATE_FRACTION_BITS, "steps per unit must be worked out at compile time");
+static_assert(LINEAR_MOTOR_CONFIGURATION.maxStepRate > 0, "the machine's configuration must be worked out at compile time");
+
+void setUp(){}
+
+void tearDown(){}
+
+void test_pin_masks(){
+    TEST_ASSERT_EQUAL_HEX8(0x08, CONFIGURATION.stepMask);
+    TEST_ASSERT_EQUAL_HEX8(0x10, CONFIGURATION.directionMask);
+    TEST_ASSERT_EQUAL_HEX8(0x80, CONFIGURATION.enableMask);
+}
+
+void test_steps_per_unit(){
+    TEST_ASSERT_EQUAL_UINT32(5UL << STEP_RATE_FRACTION_BITS, CONFIGURATION.fixedStepsPerUnit);
+    TEST_ASSERT_EQUAL_UINT32(5UL << (STEP_RATE_FRACTION_BITS - 1), NO_ACCELERATION.fixedStepsPerUnit);
+    // the reciprocal is rounded up
+    TEST_ASSERT_EQUAL_UINT64(((1ULL << UNITS_PER_STEP_FRACTION_BITS) + 4) / 5, CONFIGURATION.unitsPerStep);
+}
+
+void test_speed_limits(){
+    // 600 units per minute at 5 steps per unit is 50 steps/s
+    TEST_ASSERT_EQUAL_UINT32(600, CONFIGURATION.maxSpeedUnits);
+    TEST_ASSERT_EQUAL_UINT32(50UL << STEP_RATE_FRACTION_BITS, CONFIGURATION.maxStepRate);
+    TEST_ASSERT_EQUAL_UINT32(1000000UL / 50 << RAMP_FRACTION_BITS, CONFIGURATION.minStepInterval);
+    // 1 unit per minute is 5/60 steps/s, rounded to the nearest
+    TEST_ASSERT_EQUAL_UINT64(((5ULL << (STEP_RATE_FRACTION_BITS + SPEED_TO_STEP_RATE_FRACTION_BITS)) + 30) / 60, CONFIGURATION.speedToStepRate);
+    // a fraction of a unit per minute rounds up
+    TEST_ASSERT_EQUAL_UINT32(151, NO_ACCELERATION.maxSpeedUnits);
+}
+
+void test_ramp_start(){
+    // the first interval of a ramp from a stop at 5 steps/s^2, with the correction for the first step
+    double expected = 0.676 * sqrt(2.0 / 5.0) * 1000000.0 * (1 << RAMP_FRACTION_BITS);
+    TEST_ASSERT_UINT32_WITHIN(1, static_cast<uint32_t>(expected), CONFIGURATION.rampStartInterval);
+    TEST_ASSERT_EQUAL_UINT32(0, NO_ACCELERATION.rampStartInterval);
+}
+
+void test_whole_units_convert_exactly(){
+    // unitsPerStep is rounded up so a whole number of steps per unit always converts back to the same units
+    StepperMotor motor(LINEAR_MOTOR_CONFIGURATION);
+    for(int32_t units = -100000; units <= 100000; units += 37){
+        TEST_ASSERT_EQUAL_INT32(units, motor.StepsToUnits(motor.UnitsToSteps(units)));
+    }
+    TEST_ASSERT_EQUAL_INT32(STEPS_PER_MM, motor.UnitsToSteps(1));
+    TEST_ASSERT_EQUAL_INT32(-STEPS_PER_MM, motor.UnitsToSteps(-1));
+    // part of a unit rounds towards 0 either way
+    TEST_ASSERT_EQUAL_INT32(1, motor.StepsToUnits(STEPS_PER_MM + 1));
+    TEST_ASSERT_EQUAL_INT32(-1, motor.StepsToUnits(-STEPS_PER_MM - 1));
+}
+
+void test_speed_converts_to_the_step_rate(){
+    StepperMotor motor(CONFIGURATION);
+    motor.SetSpeed(300);
+    TEST_ASSERT_EQUAL_UINT32(300, motor.GetSpeed());
+    // anything over the max speed is held at it
+    motor.SetSpeed(100000);
+    TEST_ASSERT_EQUAL_UINT32(600, motor.GetSpeed());
+}
+
+int main(int argc, char **argv){
+    UNITY_BEGIN();
+    RUN_TEST(test_pin_masks);
+    RUN_TEST(test_steps_per_unit);
+    RUN_TEST(test_speed_limits);
+    RUN_TEST(test_ramp_start);
+    RUN_TEST(test_whole_units_convert_exactly);
+    RUN_TEST(test_speed_converts_to_the_step_rate);
+    return UNITY_END();
+}
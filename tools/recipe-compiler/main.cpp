@@ -0,0 +1,210 @@
+/**
+ * @file main.cpp
+ * @brief The recipe compiler turns a text recipe into a compiled recipe the controller can run without planning
+ * @details Every move is run through the same motion planner the controller uses, with the machine parameters in
+ * include/, and written out as a segment with its ramp already worked out. Any other command is written as it is.
+ * The motion planner can't look past a command, so every move before one is finished first, the same as the
+ * controller does when the command would have to wait for them.
+ * Usage: recipe-compiler <recipe.txt> <recipe_n.seg> [start position of each axis]
+ * The start position is where the motors have to be when the recipe is run, given for every axis in MACHINE_AXES in order,
+ * like 100 0 for X100 R0. It is the home position if it isn't given.
+ * @version 1.0.0
+ * @author Quinn Henthorne. Contact: quinn.henthorne@gmail.com
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "MACHINE-PARAMETERS.h"
+#include "GCodeParser.h"
+#include "MotionPlanner.h"
+#include "StepperMotor.h"
+#include "RecipeSegments.h"
+
+using namespace GCodeDefinitions;
+
+// the same axes, in the same order, as the controller's motion system
+#define COMPILER_MOTOR(letter, configuration, maxJerk) StepperMotor(configuration),
+#define COMPILER_GCODE_AXIS(letter, configuration, maxJerk) AxisIndex(letter),
+#define COMPILER_MAX_JERK(letter, configuration, maxJerk) maxJerk,
+StepperMotor motors[MOTION_PLANNER_AXES] = {MACHINE_AXES(COMPILER_MOTOR)};
+const uint8_t gcodeAxes[MOTION_PLANNER_AXES] = {MACHINE_AXES(COMPILER_GCODE_AXIS)};
+const float maxJerk[MOTION_PLANNER_AXES] = {MACHINE_AXES(COMPILER_MAX_JERK)};
+
+/**
+ * @brief Get the motors the way the planner takes them
+ * @return A pointer to each motor
+*/
+StepperMotor *const * motorPointers(){
+  static StepperMotor *pointers[MOTION_PLANNER_AXES];
+  for(uint8_t i = 0; i < MOTION_PLANNER_AXES; i++){
+    pointers[i] = &motors[i];
+  }
+  return pointers;
+}
+MotionPlanner motionPlanner(motorPointers(), maxJerk);
+
+#define LINE_LENGTH 128
+
+/**
+ * @brief Write out every planned move
+ * @param file The compiled recipe
+ * @return The number of segments written, or -1 if one couldn't be written
+*/
+int32_t drain(FILE *file){
+  int32_t count = 0;
+  MotionSegment segment;
+  while(motionPlanner.NextSegment(segment)){
+    if(!RecipeSegments::WriteSegment(file, segment)){
+      return -1;
+    }
+    count++;
+  }
+  return count;
+}
+
+/**
+ * @brief Move the motors to a position, as if they had been stepped there
+ * @param position The position of each axis in units
+*/
+void setPosition(const int32_t position[MOTION_PLANNER_AXES]){
+  for(uint8_t i = 0; i < MOTION_PLANNER_AXES; i++){
+    motors[i].SetCurrentPosition(position[i]);
+    motors[i].SetTargetPosition(position[i]);
+  }
+}
+
+/**
+ * @brief Move every motor to the home position
+*/
+void setHomePosition(){
+  int32_t position[MOTION_PLANNER_AXES];
+  for(uint8_t i = 0; i < MOTION_PLANNER_AXES; i++){
+    position[i] = HOME_SWITCH_POSITION;
+  }
+  setPosition(position);
+}
+
+int main(int argc, char **argv){
+  if(argc != 3 && argc != 3 + MOTION_PLANNER_AXES){
+    fprintf(stderr, "Usage: %s <recipe.txt> <recipe_n.seg>", argv[0]);
+    for(uint8_t i = 0; i < MOTION_PLANNER_AXES; i++){
+      fprintf(stderr, " [start %c]", MACHINE_AXIS_LETTERS[i]);
+    }
+    fprintf(stderr, "\n");
+    return 2;
+  }
+
+  FILE *input = fopen(argv[1], "r");
+  if(input == NULL){
+    fprintf(stderr, "Could not open %s\n", argv[1]);
+    return 1;
+  }
+  FILE *output = fopen(argv[2], "wb");
+  if(output == NULL){
+    fprintf(stderr, "Could not create %s\n", argv[2]);
+    fclose(input);
+    return 1;
+  }
+
+  RecipeSegments::Header header;
+  for(uint8_t i = 0; i < MOTION_PLANNER_AXES; i++){
+    header.stepsPerUnit[i] = RecipeSegments::FixedStepsPerUnit(motors[i].GetConfiguration().stepsPerUnit);
+    header.startPosition[i] = argc == 3 ? HOME_SWITCH_POSITION : atoi(argv[3 + i]);
+  }
+  setPosition(header.startPosition);
+
+  bool isOk = RecipeSegments::WriteHeader(output, header);
+  bool isRelative = false;
+  int32_t segments = 0;
+  int32_t commands = 0;
+  uint32_t lineNumber = 0;
+  char line[LINE_LENGTH];
+  while(isOk && fgets(line, sizeof(line), input) != NULL){
+    lineNumber++;
+
+    // a command is between the start and end markers, the same as over serial. Anything else is a comment
+    char *start = strchr(line, '!');
+    if(start == NULL){
+      continue;
+    }
+    start++;
+    char *end = strchr(start, ';');
+    if(end == NULL){
+      continue;
+    }
+    GCode gcode = GCodeParser::Parse(start, end - start);
+
+    switch(gcode.command){
+      // the controller ignores these, so they are left out
+      case Command::INVALID:
+        fprintf(stderr, "Line %u: skipping an invalid command\n", lineNumber);
+        continue;
+
+      // the mode only changes how the moves after it are planned
+      case Command::G91:
+        isRelative = true;
+        continue;
+      case Command::G90:
+        isRelative = false;
+        continue;
+
+      case Command::G1:{
+        int32_t target[MOTION_PLANNER_AXES];
+        uint8_t axisMask = 0;
+        for(uint8_t i = 0; i < MOTION_PLANNER_AXES; i++){
+          target[i] = gcode.axes[gcodeAxes[i]];
+          axisMask |= gcode.HasAxis(gcodeAxes[i]) ? 1 << i : 0;
+        }
+        // a full planner has to give up its oldest move before it can take another
+        if(motionPlanner.IsFull()){
+          MotionSegment segment;
+          motionPlanner.NextSegment(segment);
+          isOk = RecipeSegments::WriteSegment(output, segment);
+          segments++;
+        }
+        if(!motionPlanner.AddMove(target, gcode.F, isRelative, axisMask)){
+          fprintf(stderr, "Line %u: G1 needs a feed rate\n", lineNumber);
+          isOk = false;
+        }
+        continue;
+      }
+
+      // the compiled moves after these couldn't know where they start
+      case Command::G0:
+      case Command::M32:
+        fprintf(stderr, "Line %u: %s can't be compiled\n", lineNumber, commandStrings[gcode.command]);
+        isOk = false;
+        continue;
+
+      default:
+        break;
+    }
+
+    // every other command is a stop point, so the moves before it are finished first
+    int32_t count = drain(output);
+    isOk = count >= 0 && RecipeSegments::WriteCommand(output, gcode);
+    segments += count;
+    commands++;
+    if(gcode.command == Command::G28){
+      setHomePosition();
+    }
+  }
+
+  if(isOk){
+    int32_t count = drain(output);
+    isOk = count >= 0;
+    segments += count;
+  }
+  fclose(input);
+  fclose(output);
+
+  if(!isOk){
+    fprintf(stderr, "Could not compile %s\n", argv[1]);
+    remove(argv[2]);
+    return 1;
+  }
+  printf("%s: %d segments, %d commands\n", argv[2], segments, commands);
+  return 0;
+}